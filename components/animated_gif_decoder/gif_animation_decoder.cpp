@@ -33,6 +33,9 @@ struct gif_decoder_impl {
     size_t file_size;
     uint8_t *previous_frame; // For disposal method handling
     uint32_t current_frame_delay_ms;  // Delay of the last decoded frame
+    uint32_t loop_duration_ms;  // Sum of all frame delays from getInfo()
+    bool background_set;              // Transparent pixels resolve to background_rgba
+    uint8_t background_rgba[4];
 };
 
 // GIF draw callback - converts GIF pixels to RGBA
@@ -68,6 +71,8 @@ static void gif_draw_callback(GIFDRAW *pDraw)
             // Transparent pixel - keep previous frame pixel if available
             if (impl->previous_frame) {
                 memcpy(dst_pixel, impl->previous_frame + (size_t)(frame_y + y) * canvas_w * 4 + (size_t)(frame_x + x) * 4, 4);
+            } else if (impl->background_set) {
+                memcpy(dst_pixel, impl->background_rgba, 4);
             } else {
                 dst_pixel[0] = 0; // R
                 dst_pixel[1] = 0; // G
@@ -90,6 +95,19 @@ static void gif_draw_callback(GIFDRAW *pDraw)
     }
 }
 
+// Clear a canvas to fully transparent, or to the pre-blended background colour
+static void clear_canvas(struct gif_decoder_impl *impl, uint8_t *canvas)
+{
+    const size_t pixels = (size_t)impl->canvas_width * impl->canvas_height;
+    if (!impl->background_set) {
+        memset(canvas, 0, pixels * 4);
+        return;
+    }
+    for (size_t i = 0; i < pixels; i++) {
+        memcpy(canvas + i * 4, impl->background_rgba, 4);
+    }
+}
+
 // Export functions for dispatcher
 esp_err_t gif_decoder_init(animation_decoder_t **decoder, const uint8_t *data, size_t size)
 {
@@ -193,6 +211,8 @@ esp_err_t gif_decoder_init(animation_decoder_t **decoder, const uint8_t *data, s
     }
 
     impl->frame_count = (size_t)gif_info.iFrameCount;
+    // Frames with no delay are shown for 1 ms by decode_next
+    impl->loop_duration_ms = (uint32_t)((gif_info.iDuration > gif_info.iFrameCount) ? gif_info.iDuration : gif_info.iFrameCount);
     impl->gif->reset();
 
     // Ensure decode buffers start cleared before first frame decode
@@ -235,7 +255,8 @@ esp_err_t gif_decoder_get_info(animation_decoder_t *decoder, animation_decoder_i
     info->canvas_width = impl->canvas_width;
     info->canvas_height = impl->canvas_height;
     info->frame_count = impl->frame_count;
-    info->has_transparency = true; // GIFs can have transparency
+    info->has_transparency = !impl->background_set; // GIFs can have transparency unless pre-blended
+    info->loop_duration_ms = impl->loop_duration_ms;
 
     return ESP_OK;
 }
@@ -258,7 +279,7 @@ esp_err_t gif_decoder_decode_next(animation_decoder_t *decoder, uint8_t *rgba_bu
     }
 
     // Clear the RGBA buffer first
-    memset(impl->rgba_buffer, 0, rgba_size);
+    clear_canvas(impl, impl->rgba_buffer);
 
     // Set user data for callback
     // Decode next frame
@@ -302,8 +323,31 @@ esp_err_t gif_decoder_reset(animation_decoder_t *decoder)
     impl->current_frame = 0;
     impl->current_frame_delay_ms = 1;  // Reset timing state
     if (impl->previous_frame) {
-        size_t rgba_size = (size_t)impl->canvas_width * impl->canvas_height * 4;
-        memset(impl->previous_frame, 0, rgba_size);
+        clear_canvas(impl, impl->previous_frame);
+    }
+    return ESP_OK;
+}
+
+esp_err_t gif_decoder_set_background(animation_decoder_t *decoder, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (!decoder || decoder->type != ANIMATION_DECODER_TYPE_GIF) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct gif_decoder_impl *impl = (struct gif_decoder_impl *)decoder->impl.gif.gif_decoder;
+    if (!impl || !impl->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Transparent index resolves to the background, so every decoded pixel is opaque
+    impl->background_rgba[0] = r;
+    impl->background_rgba[1] = g;
+    impl->background_rgba[2] = b;
+    impl->background_rgba[3] = 255;
+    impl->background_set = true;
+    clear_canvas(impl, impl->rgba_buffer);
+    if (impl->previous_frame) {
+        clear_canvas(impl, impl->previous_frame);
     }
     return ESP_OK;
 }
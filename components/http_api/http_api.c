@@ -10,6 +10,15 @@
 #include "app_state.h"
 #include "config_store.h"
 #include "app_wifi.h"
+#include "sync_wall.h"
+#include "perf_trace.h"
+#include "metrics.h"
+#include "task_stats.h"
+#include "task_topology.h"
+#include "boot_profile.h"
+#include "asset_health.h"
+#include "thumb_cache.h"
+#include "animation_player.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -21,11 +30,15 @@ static const char *TAG = "HTTP";
 #define MAX_JSON (32 * 1024)
 #define RECV_CHUNK 4096
 #define QUEUE_LEN 10
+#define MAX_ROUTES 20
+#define METRICS_TEXT_SIZE (16 * 1024)
+#define MAX_ASSET_FAILURES 64
 
 typedef enum {
     CMD_REBOOT,
     CMD_SWAP_NEXT,
-    CMD_SWAP_BACK
+    CMD_SWAP_BACK,
+    CMD_APPLY_CONFIG
 } command_type_t;
 
 typedef struct {
@@ -37,12 +50,28 @@ typedef struct {
 typedef void (*action_callback_t)(void);
 static action_callback_t s_swap_next_callback = NULL;
 static action_callback_t s_swap_back_callback = NULL;
+static action_callback_t s_config_changed_callback = NULL;
 
 static QueueHandle_t s_cmdq = NULL;
 static httpd_handle_t s_server = NULL;
 static TaskHandle_t s_worker = NULL;
 static uint32_t s_cmd_id = 0;
 
+// Registered handlers with their request counts. Handlers run on the single HTTP server task,
+// so the counts need no locking.
+typedef struct {
+    const char *uri;
+    httpd_method_t method;
+    esp_err_t (*handler)(httpd_req_t *req);
+    uint32_t requests;
+} route_stats_t;
+
+static route_stats_t s_routes[MAX_ROUTES];
+static size_t s_route_count = 0;
+
+// /metrics is rendered here rather than on the heap or the server task stack
+static char s_metrics_text[METRICS_TEXT_SIZE];
+
 // ---------- Worker Task ----------
 
 static void do_reboot(void) {
@@ -87,6 +116,14 @@ static void api_worker_task(void *arg) {
                     }
                     break;
 
+                case CMD_APPLY_CONFIG:
+                    if (s_config_changed_callback) {
+                        ESP_LOGI(TAG, "Applying saved config");
+                        s_config_changed_callback();
+                    }
+                    app_state_enter_playing();
+                    break;
+
                 default:
                     ESP_LOGE(TAG, "Unknown command type: %d", cmd.type);
                     app_state_enter_error();
@@ -132,6 +169,10 @@ void http_api_set_action_handlers(action_callback_t swap_next, action_callback_t
     ESP_LOGI(TAG, "Action handlers registered");
 }
 
+void http_api_set_config_handler(action_callback_t config_changed) {
+    s_config_changed_callback = config_changed;
+}
+
 // ---------- HTTP Helper Functions ----------
 
 static const char* http_status_str(int status) {
@@ -139,6 +180,7 @@ static const char* http_status_str(int status) {
         case 200: return "200 OK";
         case 202: return "202 Accepted";
         case 400: return "400 Bad Request";
+        case 404: return "404 Not Found";
         case 409: return "409 Conflict";
         case 413: return "413 Payload Too Large";
         case 415: return "415 Unsupported Media Type";
@@ -200,7 +242,23 @@ static char* recv_body_json(httpd_req_t *req, size_t *out_len, int *out_err_stat
     return buf;
 }
 
+static esp_err_t h_counted(httpd_req_t *req) {
+    route_stats_t *route = (route_stats_t *)req->user_ctx;
+    route->requests++;
+    return route->handler(req);
+}
+
 static void register_uri_handler_or_log(httpd_handle_t server, httpd_uri_t *uri) {
+    // Route through h_counted so every endpoint shows up in /metrics
+    if (!uri->user_ctx && s_route_count < MAX_ROUTES) {
+        route_stats_t *route = &s_routes[s_route_count++];
+        route->uri = uri->uri;
+        route->method = uri->method;
+        route->handler = uri->handler;
+        route->requests = 0;
+        uri->handler = h_counted;
+        uri->user_ctx = route;
+    }
     esp_err_t err = httpd_register_uri_handler(server, uri);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to register URI %s: %s", uri->uri, esp_err_to_name(err));
@@ -659,6 +717,433 @@ static esp_err_t h_get_status(httpd_req_t *req) {
     return ESP_OK;
 }
 
+static const char *http_method_str(httpd_method_t method) {
+    switch (method) {
+        case HTTP_GET: return "GET";
+        case HTTP_POST: return "POST";
+        case HTTP_PUT: return "PUT";
+        case HTTP_DELETE: return "DELETE";
+        default: return "OTHER";
+    }
+}
+
+/**
+ * GET /metrics
+ * Prometheus text exposition of player, heap, task, Wi-Fi and HTTP metrics. Rendered into a
+ * static buffer without allocating, so scraping cannot fragment the heap playback relies on.
+ */
+static esp_err_t h_get_metrics(httpd_req_t *req) {
+    char *buf = s_metrics_text;
+    const size_t size = sizeof(s_metrics_text);
+    size_t len = metrics_render(buf, size);
+
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_uptime_seconds Time since boot\n"
+                          "# TYPE p3a_uptime_seconds gauge\n"
+                          "p3a_uptime_seconds %llu\n",
+                          (unsigned long long)(esp_timer_get_time() / 1000000LL));
+
+    wifi_ap_record_t ap = {0};
+    if (esp_wifi_remote_sta_get_ap_info(&ap) == ESP_OK) {
+        len = metrics_appendf(buf, size, len,
+                              "# HELP p3a_wifi_rssi_dbm Signal strength of the associated access point\n"
+                              "# TYPE p3a_wifi_rssi_dbm gauge\n"
+                              "p3a_wifi_rssi_dbm %d\n", ap.rssi);
+    }
+
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_http_requests_total HTTP requests per endpoint\n"
+                          "# TYPE p3a_http_requests_total counter\n");
+    for (size_t i = 0; i < s_route_count; ++i) {
+        len = metrics_appendf(buf, size, len, "p3a_http_requests_total{method=\"%s\",path=\"%s\"} %lu\n",
+                              http_method_str(s_routes[i].method), s_routes[i].uri,
+                              (unsigned long)s_routes[i].requests);
+    }
+
+    // Lines that do not fit are dropped whole, so a nearly full buffer means some were lost
+    if (size - len < 256) {
+        ESP_LOGW(TAG, "Metrics output may be truncated (%u of %u bytes)", (unsigned)len, (unsigned)size);
+    }
+    httpd_resp_set_type(req, "text/plain; version=0.0.4; charset=utf-8");
+    return httpd_resp_send(req, buf, len);
+}
+
+/**
+ * GET /sync
+ * Returns sync wall clock state (offset, round trip, drift) and frame deadline telemetry
+ */
+static esp_err_t h_get_sync(httpd_req_t *req) {
+    sync_wall_stats_t st;
+    sync_wall_get_stats(&st);
+
+    cJSON *data = cJSON_CreateObject();
+    if (!data) {
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    char id[9];
+    cJSON_AddBoolToObject(data, "running", st.running);
+    cJSON_AddStringToObject(data, "role", st.leader ? "leader" : "follower");
+    cJSON_AddBoolToObject(data, "locked", st.locked);
+    snprintf(id, sizeof(id), "%08lx", (unsigned long)st.node_id);
+    cJSON_AddStringToObject(data, "node_id", id);
+    snprintf(id, sizeof(id), "%08lx", (unsigned long)st.leader_id);
+    cJSON_AddStringToObject(data, "leader_id", id);
+
+    cJSON *clock = cJSON_CreateObject();
+    if (clock) {
+        cJSON_AddNumberToObject(clock, "offset_us", (double)st.offset_us);
+        cJSON_AddNumberToObject(clock, "rtt_us", (double)st.rtt_us);
+        cJSON_AddNumberToObject(clock, "jitter_us", (double)st.jitter_us);
+        cJSON_AddNumberToObject(clock, "drift_ppb", (double)st.drift_ppb);
+        cJSON_AddNumberToObject(clock, "samples", (double)st.samples);
+        cJSON_AddNumberToObject(clock, "pings_lost", (double)st.pings_lost);
+        cJSON_AddNumberToObject(clock, "last_sample_age_ms", (double)st.last_sample_age_ms);
+        cJSON_AddItemToObject(data, "clock", clock);
+    }
+
+    cJSON *frames = cJSON_CreateObject();
+    if (frames) {
+        cJSON_AddNumberToObject(frames, "presented", (double)st.frames);
+        cJSON_AddNumberToObject(frames, "late", (double)st.late_frames);
+        cJSON_AddNumberToObject(frames, "max_lateness_us", (double)st.max_lateness_us);
+        cJSON_AddNumberToObject(frames, "mean_abs_error_us", (double)st.mean_abs_error_us);
+        cJSON_AddNumberToObject(frames, "resyncs", (double)st.resyncs);
+        cJSON_AddItemToObject(data, "frames", frames);
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        cJSON_Delete(data);
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    cJSON_AddBoolToObject(root, "ok", true);
+    cJSON_AddItemToObject(root, "data", data);
+
+    char *out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (!out) {
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    send_json(req, 200, out);
+    free(out);
+    return ESP_OK;
+}
+
+static cJSON *permille_windows_json(const uint16_t *permille, const uint32_t *window_s) {
+    static const char *const names[TASK_STATS_WINDOW_COUNT] = { "1s", "10s", "60s" };
+    cJSON *obj = cJSON_CreateObject();
+    if (!obj) {
+        return NULL;
+    }
+    for (int w = 0; w < TASK_STATS_WINDOW_COUNT; ++w) {
+        if (window_s[w] > 0) {
+            cJSON_AddNumberToObject(obj, names[w], permille[w] / 10.0);
+        }
+    }
+    return obj;
+}
+
+/**
+ * GET /debug/tasks
+ * Per-task CPU% (share of one core) over 1/10/60 s windows, core load, stack headroom and
+ * buffer mutex contention from the task_stats sampler
+ */
+static esp_err_t h_get_debug_tasks(httpd_req_t *req) {
+    task_stats_report_t *report = malloc(sizeof(*report));
+    if (!report) {
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+    if (task_stats_get(report) != ESP_OK) {
+        free(report);
+        send_json(req, 409, "{\"ok\":false,\"error\":\"Task statistics disabled (CONFIG_P3A_TASK_STATS_ENABLE)\",\"code\":\"TASK_STATS_DISABLED\"}");
+        return ESP_OK;
+    }
+
+    cJSON *data = cJSON_CreateObject();
+    if (!data) {
+        free(report);
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    cJSON *cores = cJSON_CreateArray();
+    if (cores) {
+        for (int c = 0; c < portNUM_PROCESSORS; ++c) {
+            cJSON *core = cJSON_CreateObject();
+            if (!core) {
+                break;
+            }
+            cJSON_AddNumberToObject(core, "core", c);
+            cJSON_AddItemToObject(core, "busy_pct", permille_windows_json(report->core_busy_permille[c], report->window_s));
+            cJSON_AddItemToArray(cores, core);
+        }
+        cJSON_AddItemToObject(data, "cores", cores);
+    }
+
+    cJSON *tasks = cJSON_CreateArray();
+    if (tasks) {
+        for (size_t i = 0; i < report->task_count; ++i) {
+            const task_stats_task_t *t = &report->tasks[i];
+            cJSON *task = cJSON_CreateObject();
+            if (!task) {
+                break;
+            }
+            cJSON_AddStringToObject(task, "name", t->name);
+            if (t->core >= 0) {
+                cJSON_AddNumberToObject(task, "core", t->core);
+            } else {
+                cJSON_AddNullToObject(task, "core");
+            }
+            cJSON_AddNumberToObject(task, "priority", t->priority);
+            cJSON_AddNumberToObject(task, "base_priority", t->base_priority);
+            cJSON_AddNumberToObject(task, "stack_free_min", t->stack_free_min);
+            cJSON_AddItemToObject(task, "cpu_pct", permille_windows_json(t->cpu_permille, report->window_s));
+            cJSON_AddItemToArray(tasks, task);
+        }
+        cJSON_AddItemToObject(data, "tasks", tasks);
+    }
+
+    cJSON *lock = cJSON_CreateObject();
+    if (lock) {
+        cJSON_AddNumberToObject(lock, "contended", report->lock_contended);
+        cJSON_AddNumberToObject(lock, "max_wait_us", (double)report->lock_max_wait_us);
+        cJSON_AddNumberToObject(lock, "inversions", report->lock_inversions);
+        if (report->lock_inversions > 0) {
+            cJSON_AddStringToObject(lock, "last_waiter", report->lock_last_waiter);
+            cJSON_AddStringToObject(lock, "last_holder", report->lock_last_holder);
+            cJSON_AddNumberToObject(lock, "last_inversion_wait_us", (double)report->lock_last_inversion_wait_us);
+        }
+        cJSON_AddItemToObject(data, "buffer_mutex", lock);
+    }
+    free(report);
+
+    cJSON *root = cJSON_CreateObject();
+    if (!root) {
+        cJSON_Delete(data);
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    cJSON_AddBoolToObject(root, "ok", true);
+    cJSON_AddItemToObject(root, "data", data);
+
+    char *out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (!out) {
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    send_json(req, 200, out);
+    free(out);
+    return ESP_OK;
+}
+
+/**
+ * GET /debug/boot
+ * Start-up timeline: each phase with its time since the bootloader handed over and the time
+ * spent since the previous phase, plus the time to the first frame
+ */
+static esp_err_t h_get_debug_boot(httpd_req_t *req) {
+    boot_profile_mark_t marks[BOOT_PROFILE_MAX_MARKS];
+    const size_t count = boot_profile_get(marks, BOOT_PROFILE_MAX_MARKS);
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON *data = cJSON_CreateObject();
+    cJSON *phases = cJSON_CreateArray();
+    if (!root || !data || !phases) {
+        cJSON_Delete(root);
+        cJSON_Delete(data);
+        cJSON_Delete(phases);
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    int64_t prev_us = 0;
+    for (size_t i = 0; i < count; ++i) {
+        cJSON *phase = cJSON_CreateObject();
+        if (!phase) {
+            break;
+        }
+        cJSON_AddStringToObject(phase, "phase", marks[i].phase);
+        cJSON_AddNumberToObject(phase, "at_ms", marks[i].time_us / 1000.0);
+        cJSON_AddNumberToObject(phase, "delta_ms", (marks[i].time_us - prev_us) / 1000.0);
+        cJSON_AddItemToArray(phases, phase);
+        prev_us = marks[i].time_us;
+    }
+    cJSON_AddItemToObject(data, "phases", phases);
+
+    const int64_t first_frame_us = boot_profile_first_frame_us();
+    if (first_frame_us > 0) {
+        cJSON_AddNumberToObject(data, "first_frame_ms", first_frame_us / 1000.0);
+    } else {
+        cJSON_AddNullToObject(data, "first_frame_ms");
+    }
+
+    cJSON_AddBoolToObject(root, "ok", true);
+    cJSON_AddItemToObject(root, "data", data);
+
+    char *out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (!out) {
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    send_json(req, 200, out);
+    free(out);
+    return ESP_OK;
+}
+
+/**
+ * GET /assets/{id}/thumb
+ * Raw thumbnail of the artwork at play-order position id: THUMB_CACHE_SIDE square, rows top to
+ * bottom in the panel's pixel format (RGB565 little-endian or B,G,R bytes), described by headers
+ */
+static esp_err_t h_get_asset_thumb(httpd_req_t *req) {
+    const char *prefix = "/assets/";
+    char *end = NULL;
+    const unsigned long index = strtoul(req->uri + strlen(prefix), &end, 10);
+    if (end == req->uri + strlen(prefix) || strncmp(end, "/thumb", 6) != 0 || (end[6] != '\0' && end[6] != '?')) {
+        send_json(req, 404, "{\"ok\":false,\"error\":\"Not found\",\"code\":\"NOT_FOUND\"}");
+        return ESP_OK;
+    }
+    const size_t bytes = thumb_cache_thumb_bytes();
+    if (bytes == 0) {
+        send_json(req, 503, "{\"ok\":false,\"error\":\"Thumbnail cache unavailable\",\"code\":\"THUMBS_UNAVAILABLE\"}");
+        return ESP_OK;
+    }
+    char name[256];
+    if (animation_player_get_asset_name((size_t)index, name, sizeof(name)) != ESP_OK) {
+        send_json(req, 404, "{\"ok\":false,\"error\":\"No such asset\",\"code\":\"NO_ASSET\"}");
+        return ESP_OK;
+    }
+    uint8_t *pixels = malloc(bytes);
+    if (!pixels) {
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+    const esp_err_t err = thumb_cache_read(name, pixels, bytes);
+    if (err == ESP_ERR_NOT_FOUND) {
+        free(pixels);
+        send_json(req, 404, "{\"ok\":false,\"error\":\"No thumbnail yet\",\"code\":\"NO_THUMB\"}");
+        return ESP_OK;
+    } else if (err != ESP_OK) {
+        free(pixels);
+        send_json(req, 500, "{\"ok\":false,\"error\":\"Thumbnail read failed\",\"code\":\"THUMB_READ\"}");
+        return ESP_OK;
+    }
+
+    char side[8];
+    snprintf(side, sizeof(side), "%d", THUMB_CACHE_SIDE);
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "X-Thumb-Width", side);
+    httpd_resp_set_hdr(req, "X-Thumb-Height", side);
+    httpd_resp_set_hdr(req, "X-Thumb-Format", (bytes == (size_t)THUMB_CACHE_SIDE * THUMB_CACHE_SIDE * 2) ? "rgb565le" : "bgr888");
+    httpd_resp_send(req, (const char *)pixels, (ssize_t)bytes);
+    free(pixels);
+    return ESP_OK;
+}
+
+/**
+ * GET /assets/health
+ * Artworks that failed to load since their last successful load: reason, error, failure count
+ * and, while quarantined, the time until navigation tries them again
+ */
+static esp_err_t h_get_assets_health(httpd_req_t *req) {
+    asset_health_record_t *records = malloc(MAX_ASSET_FAILURES * sizeof(*records));
+    cJSON *root = cJSON_CreateObject();
+    cJSON *data = cJSON_CreateObject();
+    cJSON *failures = cJSON_CreateArray();
+    if (!records || !root || !data || !failures) {
+        free(records);
+        cJSON_Delete(root);
+        cJSON_Delete(data);
+        cJSON_Delete(failures);
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    const size_t count = asset_health_get_failures(records, MAX_ASSET_FAILURES);
+    const int64_t now_us = esp_timer_get_time();
+    for (size_t i = 0; i < count; ++i) {
+        cJSON *entry = cJSON_CreateObject();
+        if (!entry) {
+            break;
+        }
+        char name[128];
+        cJSON_AddNumberToObject(entry, "index", (double)records[i].index);
+        if (animation_player_get_asset_name(records[i].index, name, sizeof(name)) == ESP_OK) {
+            cJSON_AddStringToObject(entry, "file", name);
+        } else {
+            cJSON_AddNullToObject(entry, "file");
+        }
+        cJSON_AddStringToObject(entry, "reason", asset_health_reason_name(records[i].reason));
+        cJSON_AddStringToObject(entry, "error", esp_err_to_name(records[i].error));
+        cJSON_AddNumberToObject(entry, "failures", records[i].failures);
+        cJSON_AddBoolToObject(entry, "quarantined", records[i].quarantined);
+        if (records[i].quarantined) {
+            const int64_t retry_in_us = records[i].retry_at_us - now_us;
+            cJSON_AddNumberToObject(entry, "retry_in_ms", retry_in_us > 0 ? retry_in_us / 1000.0 : 0);
+        } else {
+            cJSON_AddNullToObject(entry, "retry_in_ms");
+        }
+        cJSON_AddItemToArray(failures, entry);
+    }
+    free(records);
+    cJSON_AddNumberToObject(data, "healthy", (double)asset_health_healthy_count());
+    cJSON_AddItemToObject(data, "failures", failures);
+
+    cJSON_AddBoolToObject(root, "ok", true);
+    cJSON_AddItemToObject(root, "data", data);
+
+    char *out = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (!out) {
+        send_json(req, 500, "{\"ok\":false,\"error\":\"OOM\",\"code\":\"OOM\"}");
+        return ESP_OK;
+    }
+
+    send_json(req, 200, out);
+    free(out);
+    return ESP_OK;
+}
+
+static esp_err_t trace_send_chunk(void *ctx, const char *chunk, size_t len) {
+    return httpd_resp_send_chunk((httpd_req_t *)ctx, chunk, len);
+}
+
+/**
+ * GET /debug/trace
+ * Streams the hot-path trace rings as Chrome trace JSON (open in Perfetto or chrome://tracing)
+ */
+static esp_err_t h_get_debug_trace(httpd_req_t *req) {
+    if (!perf_trace_available()) {
+        send_json(req, 409, "{\"ok\":false,\"error\":\"Tracing disabled (CONFIG_P3A_TRACE_ENABLE)\",\"code\":\"TRACE_DISABLED\"}");
+        return ESP_OK;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"p3a_trace.json\"");
+    esp_err_t err = perf_trace_dump_json(trace_send_chunk, req);
+    if (err == ESP_ERR_INVALID_STATE) {
+        send_json(req, 409, "{\"ok\":false,\"error\":\"Trace dump already in progress\",\"code\":\"BUSY\"}");
+        return ESP_OK;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Trace dump aborted: %s", esp_err_to_name(err));
+        return err;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
 /**
  * GET /config
  * Returns current configuration as JSON object
@@ -739,6 +1224,11 @@ static esp_err_t h_put_config(httpd_req_t *req) {
         return ESP_OK;
     }
 
+    // Saved config is authoritative; applying it happens on the worker, off the HTTP task
+    if (!enqueue_cmd(CMD_APPLY_CONFIG)) {
+        ESP_LOGW(TAG, "Config saved but could not queue apply");
+    }
+
     send_json(req, 200, "{\"ok\":true}");
     return ESP_OK;
 }
@@ -859,7 +1349,7 @@ esp_err_t http_api_start(void) {
 
     // Create worker task if not exists
     if (!s_worker) {
-        BaseType_t ret = xTaskCreate(api_worker_task, "api_worker", 4096, NULL, 5, &s_worker);
+        BaseType_t ret = task_topology_create(TASK_TOPOLOGY_HTTP_WORKER, api_worker_task, NULL, &s_worker);
         if (ret != pdPASS) {
             ESP_LOGE(TAG, "Failed to create worker task");
             return ESP_ERR_NO_MEM;
@@ -878,7 +1368,8 @@ esp_err_t http_api_start(void) {
     cfg.stack_size = 8192;
     cfg.server_port = 80;
     cfg.lru_purge_enable = true;
-    cfg.max_uri_handlers = 12;
+    cfg.max_uri_handlers = MAX_ROUTES;
+    cfg.uri_match_fn = httpd_uri_match_wildcard;  // For /assets/{id}/thumb; other routes still match exactly
 
     if (httpd_start(&s_server, &cfg) != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start HTTP server");
@@ -912,6 +1403,49 @@ esp_err_t http_api_start(void) {
     u.user_ctx = NULL;
     register_uri_handler_or_log(s_server, &u);
 
+    u.uri = "/sync";
+    u.method = HTTP_GET;
+    u.handler = h_get_sync;
+    u.user_ctx = NULL;
+    register_uri_handler_or_log(s_server, &u);
+
+    u.uri = "/metrics";
+    u.method = HTTP_GET;
+    u.handler = h_get_metrics;
+    u.user_ctx = NULL;
+    register_uri_handler_or_log(s_server, &u);
+
+    u.uri = "/debug/trace";
+    u.method = HTTP_GET;
+    u.handler = h_get_debug_trace;
+    u.user_ctx = NULL;
+    register_uri_handler_or_log(s_server, &u);
+
+    u.uri = "/debug/tasks";
+    u.method = HTTP_GET;
+    u.handler = h_get_debug_tasks;
+    u.user_ctx = NULL;
+    register_uri_handler_or_log(s_server, &u);
+
+    u.uri = "/debug/boot";
+    u.method = HTTP_GET;
+    u.handler = h_get_debug_boot;
+    u.user_ctx = NULL;
+    register_uri_handler_or_log(s_server, &u);
+
+    u.uri = "/assets/health";
+    u.method = HTTP_GET;
+    u.handler = h_get_assets_health;
+    u.user_ctx = NULL;
+    register_uri_handler_or_log(s_server, &u);
+
+    // After /assets/health, which the wildcard would otherwise take
+    u.uri = "/assets/*";
+    u.method = HTTP_GET;
+    u.handler = h_get_asset_thumb;
+    u.user_ctx = NULL;
+    register_uri_handler_or_log(s_server, &u);
+
     u.uri = "/config";
     u.method = HTTP_GET;
     u.handler = h_get_config;
@@ -40,6 +40,15 @@ esp_err_t http_api_stop(void);
  */
 void http_api_set_action_handlers(action_callback_t swap_next, action_callback_t swap_back);
 
+/**
+ * @brief Set callback invoked after PUT /config saves a new configuration
+ * 
+ * Runs on the API worker task, so it may take a while (e.g. rebuilding tables).
+ * 
+ * @param config_changed Callback function (can be NULL)
+ */
+void http_api_set_config_handler(action_callback_t config_changed);
+
 /**
  * @brief Enqueue reboot command
  * 
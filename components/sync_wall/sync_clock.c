@@ -0,0 +1,175 @@
+#include "sync_clock.h"
+#include <string.h>
+
+// Drift is only measured across estimates at least this far apart, so that offset noise
+// (up to half the round trip asymmetry) averages down to a few ppm
+#define DRIFT_MIN_SPAN_US   (60LL * 1000 * 1000)
+#define DRIFT_MAX_PPB       (500 * 1000)
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void put_i64(uint8_t *p, int64_t v) {
+    const uint64_t u = (uint64_t)v;
+    for (int i = 0; i < 8; ++i) {
+        p[i] = (uint8_t)(u >> (8 * i));
+    }
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) {
+        v |= (uint32_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+static int64_t get_i64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) {
+        v |= (uint64_t)p[i] << (8 * i);
+    }
+    return (int64_t)v;
+}
+
+// Layout: magic(4) version(1) type(1) ping_port(2) sender_id(4) seq(4) t0(8) t1(8) t2(8) asset_id(4)
+size_t sync_packet_encode(const sync_packet_t *pkt, uint8_t *buf, size_t len) {
+    if (!pkt || !buf || len < SYNC_CLOCK_PACKET_SIZE) {
+        return 0;
+    }
+    put_u32(buf + 0, SYNC_CLOCK_MAGIC);
+    buf[4] = SYNC_CLOCK_VERSION;
+    buf[5] = pkt->type;
+    put_u16(buf + 6, pkt->ping_port);
+    put_u32(buf + 8, pkt->sender_id);
+    put_u32(buf + 12, pkt->seq);
+    put_i64(buf + 16, pkt->t0);
+    put_i64(buf + 24, pkt->t1);
+    put_i64(buf + 32, pkt->t2);
+    put_u32(buf + 40, pkt->asset_id);
+    return SYNC_CLOCK_PACKET_SIZE;
+}
+
+bool sync_packet_decode(const uint8_t *buf, size_t len, sync_packet_t *pkt) {
+    if (!buf || !pkt || len != SYNC_CLOCK_PACKET_SIZE) {
+        return false;
+    }
+    if (get_u32(buf) != SYNC_CLOCK_MAGIC || buf[4] != SYNC_CLOCK_VERSION) {
+        return false;
+    }
+    pkt->type = buf[5];
+    if (pkt->type < SYNC_PACKET_BEACON || pkt->type > SYNC_PACKET_PONG) {
+        return false;
+    }
+    pkt->ping_port = get_u16(buf + 6);
+    pkt->sender_id = get_u32(buf + 8);
+    pkt->seq = get_u32(buf + 12);
+    pkt->t0 = get_i64(buf + 16);
+    pkt->t1 = get_i64(buf + 24);
+    pkt->t2 = get_i64(buf + 32);
+    pkt->asset_id = get_u32(buf + 40);
+    return true;
+}
+
+uint32_t sync_clock_asset_id(const char *name) {
+    uint32_t hash = 2166136261UL;
+    for (const char *p = name; p && *p; ++p) {
+        hash = (hash ^ (uint8_t)*p) * 16777619UL;
+    }
+    return hash ? hash : 1;
+}
+
+void sync_clock_reset(sync_clock_t *clk) {
+    if (clk) {
+        memset(clk, 0, sizeof(*clk));
+    }
+}
+
+static int64_t abs64(int64_t v) {
+    return v < 0 ? -v : v;
+}
+
+void sync_clock_add_exchange(sync_clock_t *clk, int64_t t0, int64_t t1, int64_t t2, int64_t t3) {
+    if (!clk) {
+        return;
+    }
+    const int64_t rtt = (t3 - t0) - (t2 - t1);
+    if (rtt < 0) {
+        return;  // Clock stepped mid-exchange
+    }
+
+    sync_clock_sample_t *s = &clk->window[clk->next];
+    s->offset_us = ((t1 - t0) + (t2 - t3)) / 2;
+    s->rtt_us = rtt;
+    s->local_us = t3;
+    clk->next = (clk->next + 1) % SYNC_CLOCK_WINDOW;
+    if (clk->count < SYNC_CLOCK_WINDOW) {
+        clk->count++;
+    }
+    clk->total_samples++;
+
+    // NTP-style clock filter: the exchange with the shortest round trip had the least queuing,
+    // so its offset is the most trustworthy one in the window
+    const sync_clock_sample_t *best = &clk->window[0];
+    int64_t mean = 0;
+    for (int i = 0; i < clk->count; ++i) {
+        if (clk->window[i].rtt_us < best->rtt_us) {
+            best = &clk->window[i];
+        }
+        mean += clk->window[i].offset_us;
+    }
+    mean /= clk->count;
+    int64_t deviation = 0;
+    for (int i = 0; i < clk->count; ++i) {
+        deviation += abs64(clk->window[i].offset_us - mean);
+    }
+    clk->jitter_us = deviation / clk->count;
+
+    clk->offset_us = best->offset_us;
+    clk->ref_local_us = best->local_us;
+    clk->rtt_us = best->rtt_us;
+
+    // Frequency error between successive filtered estimates, smoothed (1/4 weight per update)
+    if (!clk->valid) {
+        clk->drift_ref_offset_us = clk->offset_us;
+        clk->drift_ref_local_us = clk->ref_local_us;
+    } else if (clk->ref_local_us - clk->drift_ref_local_us >= DRIFT_MIN_SPAN_US) {
+        const int64_t span = clk->ref_local_us - clk->drift_ref_local_us;
+        int64_t ppb = ((clk->offset_us - clk->drift_ref_offset_us) * 1000000000LL) / span;
+        if (ppb > DRIFT_MAX_PPB) ppb = DRIFT_MAX_PPB;
+        if (ppb < -DRIFT_MAX_PPB) ppb = -DRIFT_MAX_PPB;
+        clk->drift_ppb = (int32_t)(clk->drift_ppb + (ppb - clk->drift_ppb) / 4);
+        clk->drift_ref_offset_us = clk->offset_us;
+        clk->drift_ref_local_us = clk->ref_local_us;
+    }
+    clk->valid = true;
+}
+
+int64_t sync_clock_local_to_shared(const sync_clock_t *clk, int64_t local_us) {
+    if (!clk || !clk->valid) {
+        return local_us;
+    }
+    const int64_t since_ref = local_us - clk->ref_local_us;
+    return local_us + clk->offset_us + (since_ref * clk->drift_ppb) / 1000000000LL;
+}
+
+int64_t sync_clock_shared_to_local(const sync_clock_t *clk, int64_t shared_us) {
+    if (!clk || !clk->valid) {
+        return shared_us;
+    }
+    // One fixed-point step is exact to well under a microsecond for drifts below 500 ppm
+    const int64_t guess = shared_us - clk->offset_us;
+    return shared_us - (sync_clock_local_to_shared(clk, guess) - guess);
+}
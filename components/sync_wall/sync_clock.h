@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Platform-independent half of the sync wall: packet codec and the clock offset
+ * estimator. No ESP-IDF dependencies, so it builds unchanged on a Linux host.
+ */
+
+#define SYNC_CLOCK_MAGIC        0x57413350UL  // "P3AW"
+#define SYNC_CLOCK_VERSION      2
+#define SYNC_CLOCK_PACKET_SIZE  44
+#define SYNC_CLOCK_WINDOW       8             // Exchanges kept by the minimum-delay filter
+
+typedef enum {
+    SYNC_PACKET_BEACON = 1,  // Leader -> group: its ping port and artwork; t0 send time, t1/t2 swap window
+    SYNC_PACKET_PING   = 2,  // Follower -> leader: t0 = follower send time
+    SYNC_PACKET_PONG   = 3,  // Leader -> follower: t0 echoed, t1 leader receive, t2 leader send
+} sync_packet_type_t;
+
+typedef struct {
+    uint8_t type;            // sync_packet_type_t
+    uint16_t ping_port;      // BEACON: UDP port the leader answers pings on
+    uint32_t sender_id;
+    uint32_t seq;
+    int64_t t0;
+    int64_t t1;
+    int64_t t2;
+    uint32_t asset_id;       // BEACON: sync_clock_asset_id() of the leader's artwork, 0 if none
+} sync_packet_t;
+
+/**
+ * @brief Serialize a packet (little endian, fixed size)
+ *
+ * @return Number of bytes written, 0 if the buffer is too small
+ */
+size_t sync_packet_encode(const sync_packet_t *pkt, uint8_t *buf, size_t len);
+
+/**
+ * @brief Parse a packet, rejecting foreign magic, versions and sizes
+ */
+bool sync_packet_decode(const uint8_t *buf, size_t len, sync_packet_t *pkt);
+
+/**
+ * @brief Identify an artwork by file name, the same on every device whatever its play order
+ *
+ * @return 32-bit FNV-1a hash of the name, never 0
+ */
+uint32_t sync_clock_asset_id(const char *name);
+
+typedef struct {
+    int64_t offset_us;   // Leader clock minus local clock
+    int64_t rtt_us;
+    int64_t local_us;    // Local time the exchange completed
+} sync_clock_sample_t;
+
+// Offset/drift estimate of the leader clock relative to the local clock
+typedef struct {
+    sync_clock_sample_t window[SYNC_CLOCK_WINDOW];
+    int count;           // Samples in the window
+    int next;
+    uint32_t total_samples;
+
+    bool valid;
+    int64_t offset_us;   // Filtered offset at ref_local_us
+    int64_t ref_local_us;
+    int64_t rtt_us;      // Round trip of the sample the offset came from
+    int32_t drift_ppb;   // Leader clock rate relative to ours, parts per billion
+    int64_t jitter_us;   // Mean absolute deviation of the window's offsets
+
+    int64_t drift_ref_offset_us;  // Earlier filtered estimate the drift is measured against
+    int64_t drift_ref_local_us;
+} sync_clock_t;
+
+void sync_clock_reset(sync_clock_t *clk);
+
+/**
+ * @brief Add one ping/pong exchange
+ *
+ * @param t0 Local time the ping was sent
+ * @param t1 Leader time the ping arrived
+ * @param t2 Leader time the pong was sent
+ * @param t3 Local time the pong arrived
+ */
+void sync_clock_add_exchange(sync_clock_t *clk, int64_t t0, int64_t t1, int64_t t2, int64_t t3);
+
+/**
+ * @brief Convert local time to leader (shared) time using offset and drift
+ */
+int64_t sync_clock_local_to_shared(const sync_clock_t *clk, int64_t local_us);
+
+/**
+ * @brief Convert shared time back to local time
+ */
+int64_t sync_clock_shared_to_local(const sync_clock_t *clk, int64_t shared_us);
@@ -0,0 +1,462 @@
+#include "sync_wall.h"
+#include "sync_clock.h"
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "lwip/inet.h"
+
+static const char *TAG = "sync_wall";
+
+#define SYNC_TASK_STACK_SIZE        4096
+#define SYNC_TASK_PRIORITY          6       // Above the render task so receive timestamps stay tight
+#define SYNC_POLL_MS                20
+#define SYNC_PING_FAST_MS           250     // Until locked
+#define SYNC_PING_SLOW_MS           1000
+#define SYNC_LEADER_TIMEOUT_US      (3LL * 1000 * 1000)
+#define SYNC_SAMPLE_TIMEOUT_US      (5LL * 1000 * 1000)
+#define SYNC_LOCK_MIN_SAMPLES       4
+#define SYNC_LOCK_MAX_RTT_US        20000
+#define SYNC_LATE_THRESHOLD_US      2000
+
+static sync_wall_config_t s_cfg;
+static char s_group[16];
+static TaskHandle_t s_task = NULL;
+static SemaphoreHandle_t s_mutex = NULL;
+static int s_group_sock = -1;
+static int s_unicast_sock = -1;
+static uint16_t s_unicast_port = 0;
+
+// Follower state (touched by the sync task only, published under s_mutex)
+static struct sockaddr_in s_leader_addr;
+static int64_t s_leader_seen_us = 0;
+static uint32_t s_ping_seq = 0;
+static bool s_ping_outstanding = false;
+static int64_t s_last_ping_us = 0;
+
+// Published state, guarded by s_mutex
+static sync_clock_t s_clock;
+static bool s_locked = false;
+static uint32_t s_leader_id = 0;
+static int64_t s_last_sample_us = 0;
+static uint32_t s_pings_lost = 0;
+static uint32_t s_frames = 0;
+static uint32_t s_late_frames = 0;
+static int64_t s_max_lateness_us = 0;
+static int64_t s_abs_error_sum_us = 0;
+static uint32_t s_resyncs = 0;
+
+// Artwork announcement, guarded by s_asset_lock so the player can announce before the task starts
+static portMUX_TYPE s_asset_lock = portMUX_INITIALIZER_UNLOCKED;
+static sync_wall_asset_t s_asset;            // Leader: announced; follower: as last beaconed
+static bool s_beacon_now = false;            // Leader: beacon the new announcement without waiting
+
+static void send_packet(int sock, const struct sockaddr_in *to, const sync_packet_t *pkt)
+{
+    uint8_t buf[SYNC_CLOCK_PACKET_SIZE];
+    const size_t len = sync_packet_encode(pkt, buf, sizeof(buf));
+    if (sendto(sock, buf, len, 0, (const struct sockaddr *)to, sizeof(*to)) < 0) {
+        ESP_LOGD(TAG, "sendto failed: errno %d", errno);
+    }
+}
+
+static void forget_leader(void)
+{
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    sync_clock_reset(&s_clock);
+    s_locked = false;
+    s_leader_id = 0;
+    s_last_sample_us = 0;
+    xSemaphoreGive(s_mutex);
+    portENTER_CRITICAL(&s_asset_lock);
+    memset(&s_asset, 0, sizeof(s_asset));
+    portEXIT_CRITICAL(&s_asset_lock);
+    s_leader_seen_us = 0;
+    s_ping_outstanding = false;
+}
+
+static void handle_beacon(const sync_packet_t *pkt, const struct sockaddr_in *from, int64_t now_us)
+{
+    if (pkt->sender_id == s_cfg.node_id) {
+        return;  // Own beacon looped back
+    }
+    if (s_cfg.leader) {
+        ESP_LOGW(TAG, "Another leader (%08lx) is beaconing on this group", (unsigned long)pkt->sender_id);
+        return;
+    }
+    if (s_leader_id != 0 && pkt->sender_id != s_leader_id) {
+        return;  // Stay with the current leader while it is alive
+    }
+    if (s_leader_id == 0) {
+        xSemaphoreTake(s_mutex, portMAX_DELAY);
+        sync_clock_reset(&s_clock);
+        s_leader_id = pkt->sender_id;
+        xSemaphoreGive(s_mutex);
+        ESP_LOGI(TAG, "Following leader %08lx at %s:%u", (unsigned long)pkt->sender_id,
+                 inet_ntoa(from->sin_addr), (unsigned)pkt->ping_port);
+    }
+    s_leader_addr = *from;
+    s_leader_addr.sin_port = htons(pkt->ping_port);
+    s_leader_seen_us = now_us;
+
+    portENTER_CRITICAL(&s_asset_lock);
+    s_asset.asset_id = pkt->asset_id;
+    s_asset.not_before_us = pkt->t1;
+    s_asset.deadline_us = pkt->t2;
+    portEXIT_CRITICAL(&s_asset_lock);
+}
+
+static void handle_unicast(const sync_packet_t *pkt, const struct sockaddr_in *from, int64_t rx_us)
+{
+    if (s_cfg.leader && pkt->type == SYNC_PACKET_PING) {
+        sync_packet_t pong = {
+            .type = SYNC_PACKET_PONG,
+            .sender_id = s_cfg.node_id,
+            .seq = pkt->seq,
+            .t0 = pkt->t0,
+            .t1 = rx_us,
+        };
+        pong.t2 = esp_timer_get_time();
+        send_packet(s_unicast_sock, from, &pong);
+        return;
+    }
+    if (s_cfg.leader || pkt->type != SYNC_PACKET_PONG || pkt->sender_id != s_leader_id ||
+        !s_ping_outstanding || pkt->seq != s_ping_seq) {
+        return;
+    }
+    s_ping_outstanding = false;
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    sync_clock_add_exchange(&s_clock, pkt->t0, pkt->t1, pkt->t2, rx_us);
+    s_last_sample_us = rx_us;
+    const bool was_locked = s_locked;
+    s_locked = s_clock.valid && s_clock.count >= SYNC_LOCK_MIN_SAMPLES && s_clock.rtt_us <= SYNC_LOCK_MAX_RTT_US;
+    const int64_t offset_us = s_clock.offset_us;
+    const int64_t rtt_us = s_clock.rtt_us;
+    xSemaphoreGive(s_mutex);
+
+    if (s_locked && !was_locked) {
+        ESP_LOGI(TAG, "Locked to leader %08lx: offset %lld us, rtt %lld us", (unsigned long)s_leader_id,
+                 (long long)offset_us, (long long)rtt_us);
+    }
+}
+
+static void follower_tick(int64_t now_us)
+{
+    if (s_leader_id == 0) {
+        return;
+    }
+    if (now_us - s_leader_seen_us > SYNC_LEADER_TIMEOUT_US ||
+        (s_last_sample_us != 0 && now_us - s_last_sample_us > SYNC_SAMPLE_TIMEOUT_US)) {
+        ESP_LOGW(TAG, "Lost leader %08lx", (unsigned long)s_leader_id);
+        forget_leader();
+        return;
+    }
+    const int64_t interval_us = (s_locked ? SYNC_PING_SLOW_MS : SYNC_PING_FAST_MS) * 1000LL;
+    if (now_us - s_last_ping_us < interval_us) {
+        return;
+    }
+    if (s_ping_outstanding) {
+        xSemaphoreTake(s_mutex, portMAX_DELAY);
+        s_pings_lost++;
+        xSemaphoreGive(s_mutex);
+    }
+    sync_packet_t ping = {
+        .type = SYNC_PACKET_PING,
+        .sender_id = s_cfg.node_id,
+        .seq = ++s_ping_seq,
+    };
+    ping.t0 = esp_timer_get_time();
+    send_packet(s_unicast_sock, &s_leader_addr, &ping);
+    s_ping_outstanding = true;
+    s_last_ping_us = now_us;
+}
+
+static void sync_wall_task(void *arg)
+{
+    (void)arg;
+    struct sockaddr_in group_addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(s_cfg.port),
+    };
+    inet_aton(s_group, &group_addr.sin_addr);
+    int64_t last_beacon_us = 0;
+    uint32_t beacon_seq = 0;
+    uint8_t buf[SYNC_CLOCK_PACKET_SIZE + 1];
+    const int max_fd = (s_group_sock > s_unicast_sock) ? s_group_sock : s_unicast_sock;
+
+    while (true) {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(s_group_sock, &fds);
+        FD_SET(s_unicast_sock, &fds);
+        struct timeval tv = { .tv_sec = 0, .tv_usec = SYNC_POLL_MS * 1000 };
+        const int ready = select(max_fd + 1, &fds, NULL, NULL, &tv);
+
+        if (ready > 0) {
+            struct sockaddr_in from;
+            socklen_t from_len = sizeof(from);
+            sync_packet_t pkt;
+            if (FD_ISSET(s_unicast_sock, &fds)) {
+                const int len = recvfrom(s_unicast_sock, buf, sizeof(buf), 0, (struct sockaddr *)&from, &from_len);
+                const int64_t rx_us = esp_timer_get_time();
+                if (len > 0 && sync_packet_decode(buf, (size_t)len, &pkt)) {
+                    handle_unicast(&pkt, &from, rx_us);
+                }
+            }
+            if (FD_ISSET(s_group_sock, &fds)) {
+                from_len = sizeof(from);
+                const int len = recvfrom(s_group_sock, buf, sizeof(buf), 0, (struct sockaddr *)&from, &from_len);
+                if (len > 0 && sync_packet_decode(buf, (size_t)len, &pkt) && pkt.type == SYNC_PACKET_BEACON) {
+                    handle_beacon(&pkt, &from, esp_timer_get_time());
+                }
+            }
+        }
+
+        const int64_t now_us = esp_timer_get_time();
+        if (s_cfg.leader) {
+            portENTER_CRITICAL(&s_asset_lock);
+            const sync_wall_asset_t asset = s_asset;
+            const bool beacon_now = s_beacon_now;
+            s_beacon_now = false;
+            portEXIT_CRITICAL(&s_asset_lock);
+            if (beacon_now || now_us - last_beacon_us >= (int64_t)s_cfg.beacon_interval_ms * 1000) {
+                sync_packet_t beacon = {
+                    .type = SYNC_PACKET_BEACON,
+                    .ping_port = s_unicast_port,
+                    .sender_id = s_cfg.node_id,
+                    .seq = ++beacon_seq,
+                    .t0 = now_us,
+                    .t1 = asset.not_before_us,
+                    .t2 = asset.deadline_us,
+                    .asset_id = asset.asset_id,
+                };
+                send_packet(s_unicast_sock, &group_addr, &beacon);
+                last_beacon_us = now_us;
+            }
+        } else {
+            follower_tick(now_us);
+        }
+    }
+}
+
+static int open_group_socket(void)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        return -1;
+    }
+    // Every instance on a host binds the group port; multicast is delivered to all of them
+    int one = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(s_cfg.port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    struct ip_mreq mreq = { .imr_interface.s_addr = htonl(INADDR_ANY) };
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        inet_aton(s_group, &mreq.imr_multiaddr) == 0 ||
+        setsockopt(sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        ESP_LOGE(TAG, "Cannot join %s:%u: errno %d", s_group, (unsigned)s_cfg.port, errno);
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+static int open_unicast_socket(void)
+{
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        return -1;
+    }
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = 0,  // Ephemeral: unicast to a shared port would reach only one instance
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    socklen_t len = sizeof(addr);
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        getsockname(sock, (struct sockaddr *)&addr, &len) < 0) {
+        ESP_LOGE(TAG, "Cannot bind ping socket: errno %d", errno);
+        close(sock);
+        return -1;
+    }
+    s_unicast_port = ntohs(addr.sin_port);
+    // Beacons are sent from this socket: keep them on the LAN and visible to local instances
+    uint8_t ttl = 1;
+    uint8_t loop = 1;
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    setsockopt(sock, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    return sock;
+}
+
+esp_err_t sync_wall_start(const sync_wall_config_t *config)
+{
+    if (s_task) {
+        return ESP_OK;
+    }
+    if (!config || !config->group || config->port == 0 || config->beacon_interval_ms == 0 ||
+        strlen(config->group) >= sizeof(s_group)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_cfg = *config;
+    strcpy(s_group, config->group);
+    s_cfg.group = s_group;
+    while (s_cfg.node_id == 0) {
+        s_cfg.node_id = esp_random();
+    }
+
+    if (!s_mutex) {
+        s_mutex = xSemaphoreCreateMutex();
+        if (!s_mutex) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    sync_clock_reset(&s_clock);
+    s_locked = s_cfg.leader;
+    s_leader_id = s_cfg.leader ? s_cfg.node_id : 0;
+
+    s_group_sock = open_group_socket();
+    s_unicast_sock = (s_group_sock >= 0) ? open_unicast_socket() : -1;
+    if (s_unicast_sock < 0) {
+        if (s_group_sock >= 0) {
+            close(s_group_sock);
+            s_group_sock = -1;
+        }
+        return ESP_FAIL;
+    }
+
+    if (xTaskCreate(sync_wall_task, "sync_wall", SYNC_TASK_STACK_SIZE, NULL, SYNC_TASK_PRIORITY, &s_task) != pdPASS) {
+        close(s_group_sock);
+        close(s_unicast_sock);
+        s_group_sock = s_unicast_sock = -1;
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "Started as %s %08lx on %s:%u (ping port %u)", s_cfg.leader ? "leader" : "follower",
+             (unsigned long)s_cfg.node_id, s_group, (unsigned)s_cfg.port, (unsigned)s_unicast_port);
+    return ESP_OK;
+}
+
+bool sync_wall_is_locked(void)
+{
+    if (!s_mutex) {
+        return false;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    const bool locked = s_locked;
+    xSemaphoreGive(s_mutex);
+    return locked;
+}
+
+int64_t sync_wall_local_to_shared(int64_t local_us)
+{
+    if (!s_mutex) {
+        return local_us;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    const int64_t shared_us = sync_clock_local_to_shared(&s_clock, local_us);
+    xSemaphoreGive(s_mutex);
+    return shared_us;
+}
+
+int64_t sync_wall_shared_to_local(int64_t shared_us)
+{
+    if (!s_mutex) {
+        return shared_us;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    const int64_t local_us = sync_clock_shared_to_local(&s_clock, shared_us);
+    xSemaphoreGive(s_mutex);
+    return local_us;
+}
+
+void sync_wall_announce_asset(const sync_wall_asset_t *asset)
+{
+    if (!asset) {
+        return;
+    }
+    portENTER_CRITICAL(&s_asset_lock);
+    s_asset = *asset;
+    s_beacon_now = true;
+    portEXIT_CRITICAL(&s_asset_lock);
+}
+
+bool sync_wall_get_leader_asset(sync_wall_asset_t *out)
+{
+    if (!out || s_cfg.leader || !sync_wall_is_locked()) {
+        return false;
+    }
+    portENTER_CRITICAL(&s_asset_lock);
+    *out = s_asset;
+    portEXIT_CRITICAL(&s_asset_lock);
+    return out->asset_id != 0;
+}
+
+void sync_wall_note_frame(int64_t error_us)
+{
+    if (!s_mutex) {
+        return;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    s_frames++;
+    if (error_us > SYNC_LATE_THRESHOLD_US) {
+        s_late_frames++;
+    }
+    if (error_us > s_max_lateness_us) {
+        s_max_lateness_us = error_us;
+    }
+    s_abs_error_sum_us += (error_us < 0) ? -error_us : error_us;
+    xSemaphoreGive(s_mutex);
+}
+
+void sync_wall_note_resync(void)
+{
+    if (!s_mutex) {
+        return;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    s_resyncs++;
+    xSemaphoreGive(s_mutex);
+}
+
+void sync_wall_get_stats(sync_wall_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    memset(out, 0, sizeof(*out));
+    out->last_sample_age_ms = -1;
+    if (!s_mutex) {
+        return;
+    }
+    const int64_t now_us = esp_timer_get_time();
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    out->running = (s_task != NULL);
+    out->leader = s_cfg.leader;
+    out->locked = s_locked;
+    out->node_id = s_cfg.node_id;
+    out->leader_id = s_leader_id;
+    out->offset_us = s_clock.offset_us;
+    out->rtt_us = s_clock.rtt_us;
+    out->jitter_us = s_clock.jitter_us;
+    out->drift_ppb = s_clock.drift_ppb;
+    out->samples = s_clock.total_samples;
+    out->pings_lost = s_pings_lost;
+    if (s_last_sample_us != 0) {
+        out->last_sample_age_ms = (now_us - s_last_sample_us) / 1000;
+    }
+    out->frames = s_frames;
+    out->late_frames = s_late_frames;
+    out->max_lateness_us = s_max_lateness_us;
+    out->mean_abs_error_us = s_frames ? s_abs_error_sum_us / s_frames : 0;
+    out->resyncs = s_resyncs;
+    xSemaphoreGive(s_mutex);
+}
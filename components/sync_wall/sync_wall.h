@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/**
+ * @brief Sync wall: shared LAN clock for frame-locked playback on several devices
+ *
+ * One device is the leader and multicasts a beacon; followers measure their offset to the
+ * leader's clock with unicast ping/pong exchanges (SNTP style, minimum-delay filtered) and
+ * track its drift. Players then schedule frames on the shared timeline. The beacon also carries
+ * the artwork the leader shows or is about to swap to, which followers show instead of
+ * cycling on their own.
+ */
+
+typedef struct {
+    bool leader;                  ///< Act as the time source for the group
+    const char *group;            ///< IPv4 multicast group, e.g. "239.255.47.33"
+    uint16_t port;                ///< Group UDP port
+    uint32_t beacon_interval_ms;  ///< Leader beacon period
+    uint32_t node_id;             ///< Unique id of this device, 0 picks a random one
+} sync_wall_config_t;
+
+typedef struct {
+    bool running;
+    bool leader;
+    bool locked;                  ///< Shared clock usable for scheduling
+    uint32_t node_id;
+    uint32_t leader_id;           ///< Leader currently followed (own id on the leader)
+    int64_t offset_us;            ///< Leader clock minus local clock
+    int64_t rtt_us;               ///< Round trip of the exchange the offset came from
+    int64_t jitter_us;            ///< Spread of the recent offset samples
+    int32_t drift_ppb;            ///< Leader clock rate error relative to ours
+    uint32_t samples;             ///< Ping/pong exchanges since the leader was found
+    uint32_t pings_lost;          ///< Pings that got no answer
+    int64_t last_sample_age_ms;   ///< Time since the last exchange, -1 if none
+    uint32_t frames;              ///< Frames presented on the shared timeline
+    uint32_t late_frames;         ///< Frames presented more than 2 ms after their deadline
+    int64_t max_lateness_us;
+    int64_t mean_abs_error_us;    ///< Mean |presentation time - deadline|
+    uint32_t resyncs;             ///< Times playback fell too far behind and was re-anchored
+} sync_wall_stats_t;
+
+// Artwork announced by the leader
+typedef struct {
+    uint32_t asset_id;            ///< sync_clock_asset_id() of its file name, 0 if none
+    int64_t not_before_us;        ///< Shared time from which the swap happens at a loop end
+    int64_t deadline_us;          ///< Shared time by which the swap happens regardless
+} sync_wall_asset_t;
+
+/**
+ * @brief Start the sync task
+ *
+ * Safe to call again once the network is up; later calls are ignored.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad config, ESP_FAIL if a socket
+ *         cannot be opened
+ */
+esp_err_t sync_wall_start(const sync_wall_config_t *config);
+
+/**
+ * @brief True when the shared clock can be used to schedule frames
+ *
+ * Always true on the leader. Followers lock once enough low-delay exchanges agree, and
+ * unlock when the leader goes silent.
+ */
+bool sync_wall_is_locked(void);
+
+/**
+ * @brief Convert an esp_timer timestamp to shared time
+ */
+int64_t sync_wall_local_to_shared(int64_t local_us);
+
+/**
+ * @brief Convert a shared timestamp to esp_timer time
+ */
+int64_t sync_wall_shared_to_local(int64_t shared_us);
+
+/**
+ * @brief Leader: announce the artwork being swapped to in the following beacons
+ *
+ * A new announcement is beaconed right away; one made before sync_wall_start() is kept for the
+ * first beacon. Never beaconed by followers.
+ */
+void sync_wall_announce_asset(const sync_wall_asset_t *asset);
+
+/**
+ * @brief Follower: the leader's latest announcement
+ *
+ * @return false while not locked or before the leader announced anything
+ */
+bool sync_wall_get_leader_asset(sync_wall_asset_t *out);
+
+/**
+ * @brief Record how far a frame was presented from its shared deadline (positive is late)
+ */
+void sync_wall_note_frame(int64_t error_us);
+
+/**
+ * @brief Record that playback was re-anchored after falling behind
+ */
+void sync_wall_note_resync(void);
+
+/**
+ * @brief Snapshot of the clock state and frame telemetry
+ */
+void sync_wall_get_stats(sync_wall_stats_t *out);
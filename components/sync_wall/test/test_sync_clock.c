@@ -0,0 +1,244 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Host tests for the sync wall clock: packet codec, and followers with synthetic offset, drift and
+// network jitter pinging a leader, whose estimates must map shared deadlines to the same instant
+
+#include "sync_clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int s_failures = 0;
+
+#define CHECK_EQ(actual, expected)                                                              \
+    do {                                                                                        \
+        const long long a_ = (long long)(actual);                                               \
+        const long long e_ = (long long)(expected);                                             \
+        if (a_ != e_) {                                                                         \
+            fprintf(stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual,  \
+                    a_, e_);                                                                    \
+            s_failures++;                                                                       \
+        }                                                                                       \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                 \
+    do {                                                                                        \
+        const long long a_ = (long long)(actual);                                               \
+        const long long e_ = (long long)(expected);                                             \
+        if (llabs(a_ - e_) > (long long)(tolerance)) {                                          \
+            fprintf(stderr, "%s:%d: %s is %lld, expected %lld +- %lld\n", __FILE__, __LINE__,   \
+                    #actual, a_, e_, (long long)(tolerance));                                   \
+            s_failures++;                                                                       \
+        }                                                                                       \
+    } while (0)
+
+#define MS(ms)  ((int64_t)(ms) * 1000)
+#define S(s)    ((int64_t)(s) * 1000000)
+
+// Deterministic xorshift, so failures reproduce
+static uint32_t s_rng = 0x12345678;
+
+static uint32_t rng_next(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// One-way network delay: 1 ms plus up to jitter_us, and one packet in eight queued for 5-25 ms
+static int64_t net_delay(int64_t jitter_us)
+{
+    int64_t d = 1000 + (int64_t)(rng_next() % (uint32_t)(jitter_us + 1));
+    if (rng_next() % 8 == 0) {
+        d += 5000 + (int64_t)(rng_next() % 20000);
+    }
+    return d;
+}
+
+// The leader's clock is the shared timeline. A follower's clock runs off true time by offset_us
+// plus drift_ppb, and its pings see jitter_us of random delay each way.
+typedef struct {
+    int64_t offset_us;
+    int64_t drift_ppb;
+    int64_t jitter_us;
+    sync_clock_t clk;
+} follower_t;
+
+static const int64_t LEADER_OFFSET_US = S(1000);
+
+static int64_t leader_clock(int64_t true_us)
+{
+    return true_us + LEADER_OFFSET_US;
+}
+
+static int64_t follower_clock(const follower_t *f, int64_t true_us)
+{
+    return true_us + f->offset_us + (true_us * f->drift_ppb) / 1000000000LL;
+}
+
+// One ping/pong exchange starting at true time true_us
+static void exchange(follower_t *f, int64_t true_us)
+{
+    const int64_t t0 = follower_clock(f, true_us);
+    const int64_t at_leader = true_us + net_delay(f->jitter_us);
+    const int64_t t1 = leader_clock(at_leader);
+    const int64_t t2 = t1 + 50;
+    const int64_t t3 = follower_clock(f, at_leader + 50 + net_delay(f->jitter_us));
+    sync_clock_add_exchange(&f->clk, t0, t1, t2, t3);
+}
+
+// Ping once a second, as a locked follower does, from true time from_us for count seconds
+static void run(follower_t *f, int64_t from_us, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        exchange(f, from_us + S(i));
+    }
+}
+
+// How far the follower's estimate of shared time is off at true time true_us
+static int64_t shared_error(const follower_t *f, int64_t true_us)
+{
+    return sync_clock_local_to_shared(&f->clk, follower_clock(f, true_us)) - leader_clock(true_us);
+}
+
+static void test_packet_codec(void)
+{
+    const sync_packet_t in = {
+        .type = SYNC_PACKET_BEACON,
+        .ping_port = 47331,
+        .sender_id = 0xdeadbeef,
+        .seq = 42,
+        .t0 = -5,
+        .t1 = 0x0123456789abcdefLL,
+        .t2 = S(3600),
+        .asset_id = 0x89abcdef,
+    };
+    uint8_t buf[SYNC_CLOCK_PACKET_SIZE + 4];
+    CHECK_EQ(sync_packet_encode(&in, buf, SYNC_CLOCK_PACKET_SIZE - 1), 0);
+    CHECK_EQ(sync_packet_encode(&in, buf, sizeof(buf)), SYNC_CLOCK_PACKET_SIZE);
+
+    sync_packet_t out;
+    memset(&out, 0, sizeof(out));
+    CHECK_EQ(sync_packet_decode(buf, SYNC_CLOCK_PACKET_SIZE, &out), true);
+    CHECK_EQ(out.type, in.type);
+    CHECK_EQ(out.ping_port, in.ping_port);
+    CHECK_EQ(out.sender_id, in.sender_id);
+    CHECK_EQ(out.seq, in.seq);
+    CHECK_EQ(out.t0, in.t0);
+    CHECK_EQ(out.t1, in.t1);
+    CHECK_EQ(out.t2, in.t2);
+    CHECK_EQ(out.asset_id, in.asset_id);
+
+    // Foreign sizes, magic, versions and types are rejected
+    CHECK_EQ(sync_packet_decode(buf, SYNC_CLOCK_PACKET_SIZE + 1, &out), false);
+    uint8_t bad[SYNC_CLOCK_PACKET_SIZE];
+    memcpy(bad, buf, sizeof(bad));
+    bad[0] ^= 1;
+    CHECK_EQ(sync_packet_decode(bad, sizeof(bad), &out), false);
+    memcpy(bad, buf, sizeof(bad));
+    bad[4] = SYNC_CLOCK_VERSION + 1;
+    CHECK_EQ(sync_packet_decode(bad, sizeof(bad), &out), false);
+    memcpy(bad, buf, sizeof(bad));
+    bad[5] = SYNC_PACKET_PONG + 1;
+    CHECK_EQ(sync_packet_decode(bad, sizeof(bad), &out), false);
+}
+
+static void test_asset_id(void)
+{
+    CHECK_EQ(sync_clock_asset_id("cat.webp"), sync_clock_asset_id("cat.webp"));
+    CHECK_EQ(sync_clock_asset_id("cat.webp") != sync_clock_asset_id("cat.gif"), true);
+    CHECK_EQ(sync_clock_asset_id("") != 0, true);
+    CHECK_EQ(sync_clock_asset_id(NULL) != 0, true);
+}
+
+static void test_offset(void)
+{
+    follower_t f = { .offset_us = S(-20), .jitter_us = 2000 };
+    sync_clock_reset(&f.clk);
+    CHECK_EQ(f.clk.valid, false);
+    CHECK_EQ(sync_clock_local_to_shared(&f.clk, 1234), 1234);   // Identity until the first exchange
+
+    // A reply that came back before its ping left (the local clock stepped) is ignored
+    sync_clock_add_exchange(&f.clk, S(10), S(5), S(5), S(9));
+    CHECK_EQ(f.clk.valid, false);
+    CHECK_EQ(f.clk.total_samples, 0);
+
+    run(&f, S(100), SYNC_CLOCK_WINDOW);
+    CHECK_EQ(f.clk.valid, true);
+    CHECK_EQ(f.clk.count, SYNC_CLOCK_WINDOW);
+    CHECK_EQ(f.clk.drift_ppb, 0);   // Not measured yet: all samples lie within DRIFT_MIN_SPAN_US
+    // The minimum-delay sample's offset is off by at most half its delay asymmetry
+    CHECK_NEAR(f.clk.offset_us, LEADER_OFFSET_US - f.offset_us, f.clk.rtt_us / 2);
+    CHECK_NEAR(shared_error(&f, S(110)), 0, 1000);
+    CHECK_EQ(f.clk.rtt_us <= 2 * (1000 + f.jitter_us) + 50, true);
+    CHECK_EQ(f.clk.jitter_us > 0, true);
+
+    // Shared and local time convert back and forth exactly
+    const int64_t local_us = follower_clock(&f, S(110));
+    CHECK_EQ(sync_clock_shared_to_local(&f.clk, sync_clock_local_to_shared(&f.clk, local_us)), local_us);
+}
+
+static void test_drift(void)
+{
+    // 40 ppm fast: without drift correction the estimate is 2.4 ms off a minute after an exchange
+    follower_t f = { .offset_us = S(7), .drift_ppb = 40000, .jitter_us = 500 };
+    sync_clock_reset(&f.clk);
+    run(&f, S(10), 900);
+
+    // The follower runs fast, so the leader clock runs slow relative to it
+    CHECK_NEAR(f.clk.drift_ppb, -40000, 3000);
+    const int64_t last_us = S(10) + S(899);
+    CHECK_NEAR(shared_error(&f, last_us + S(60)), 0, 1000);
+
+    const int64_t local_us = follower_clock(&f, last_us + S(30));
+    CHECK_NEAR(sync_clock_shared_to_local(&f.clk, sync_clock_local_to_shared(&f.clk, local_us)), local_us, 1);
+}
+
+// Several followers of one leader present a frame due at the same shared deadline within half
+// the round trip of their best exchange (plus residual drift), whatever their offsets and drifts
+static void test_wall(void)
+{
+    follower_t wall[] = {
+        { .offset_us = S(-300), .drift_ppb = 25000, .jitter_us = 300 },
+        { .offset_us = S(12), .drift_ppb = -60000, .jitter_us = 2000 },
+        { .offset_us = 777, .drift_ppb = 5000, .jitter_us = 5000 },
+    };
+    const int n = (int)(sizeof(wall) / sizeof(wall[0]));
+    for (int i = 0; i < n; ++i) {
+        sync_clock_reset(&wall[i].clk);
+        run(&wall[i], S(50) + MS(137) * i, 900);
+    }
+
+    // Within the second before the next ping, which a locked follower sends every second
+    for (int k = 0; k < 5; ++k) {
+        const int64_t true_due_us = S(50) + S(900) + MS(200) * k;
+        const int64_t due_shared_us = leader_clock(true_due_us);
+        for (int i = 0; i < n; ++i) {
+            // Invert the follower clock to the true instant its deadline falls on
+            const int64_t due_local_us = sync_clock_shared_to_local(&wall[i].clk, due_shared_us);
+            int64_t true_us = due_local_us - wall[i].offset_us;
+            true_us -= follower_clock(&wall[i], true_us) - due_local_us;
+            CHECK_NEAR(true_us, true_due_us, wall[i].clk.rtt_us / 2 + 100);
+        }
+    }
+}
+
+int main(void)
+{
+    test_packet_codec();
+    test_asset_id();
+    test_offset();
+    test_drift();
+    test_wall();
+    if (s_failures) {
+        fprintf(stderr, "%d check(s) failed\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("test_sync_clock: all checks passed\n");
+    return EXIT_SUCCESS;
+}
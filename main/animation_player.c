@@ -6,6 +6,25 @@
 
 #include "animation_player.h"
 #include "animation_decoder.h"
+#include "frame_transition.h"
+#include "pixel_scalers.h"
+#include "color_pipeline.h"
+#include "frame_background.h"
+#include "display_orientation.h"
+#include "osd.h"
+#include "perf_trace.h"
+#include "metrics.h"
+#include "task_stats.h"
+#include "task_topology.h"
+#include "config_store.h"
+#include "boot_profile.h"
+#include "asset_health.h"
+#include "thumb_cache.h"
+#include "power_mgmt.h"
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+#include "sync_wall.h"
+#include "sync_clock.h"
+#endif
 #include "app_lcd.h"
 #include "esp_log.h"
 #include "esp_err.h"
@@ -13,6 +32,7 @@
 #include "esp_heap_caps.h"
 #include "esp_task_wdt.h"
 #include "esp_random.h"
+#include "nvs.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
@@ -22,6 +42,7 @@
 #include <dirent.h>
 #include <sys/stat.h>
 #include <errno.h>
+#include <stdatomic.h>
 
 #ifndef __has_include
 #define __has_include(x) 0
@@ -50,10 +71,56 @@
 #define TAG "anim_player"
 
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
-#define MAX(a, b) ((a) > (b) ? (a) : (b))
 
-#define DIGIT_WIDTH  5
-#define DIGIT_HEIGHT 7
+
+#if CONFIG_P3A_TRANSITION_CROSSFADE
+#define P3A_TRANSITION_TYPE FRAME_TRANSITION_CROSSFADE
+#elif CONFIG_P3A_TRANSITION_WIPE
+#define P3A_TRANSITION_TYPE FRAME_TRANSITION_WIPE
+#elif CONFIG_P3A_TRANSITION_IRIS
+#define P3A_TRANSITION_TYPE FRAME_TRANSITION_IRIS
+#else
+#define P3A_TRANSITION_TYPE FRAME_TRANSITION_NONE
+#endif
+
+#ifndef CONFIG_P3A_TRANSITION_FRAMES
+#define CONFIG_P3A_TRANSITION_FRAMES 0
+#endif
+
+// How a canvas is mapped onto the panel
+typedef enum {
+    SCALING_MODE_STRETCH,   // Scale each axis independently to the full panel
+    SCALING_MODE_FIT,       // Largest aspect-preserving size that fits, letterboxed
+    SCALING_MODE_FILL,      // Smallest aspect-preserving size that covers the panel, cropped
+    SCALING_MODE_CENTER,    // Native size centred (large canvases fall back to fit)
+    SCALING_MODE_INTEGER,   // Largest whole-number scale that fits (falls back to fit)
+} scaling_mode_t;
+
+#if CONFIG_P3A_SCALING_MODE_STRETCH
+#define P3A_SCALING_MODE SCALING_MODE_STRETCH
+#elif CONFIG_P3A_SCALING_MODE_FILL
+#define P3A_SCALING_MODE SCALING_MODE_FILL
+#elif CONFIG_P3A_SCALING_MODE_CENTER
+#define P3A_SCALING_MODE SCALING_MODE_CENTER
+#elif CONFIG_P3A_SCALING_MODE_INTEGER
+#define P3A_SCALING_MODE SCALING_MODE_INTEGER
+#else
+#define P3A_SCALING_MODE SCALING_MODE_FIT
+#endif
+
+#if CONFIG_P3A_PIXEL_SCALER_SCALE2X
+#define P3A_PIXEL_SCALER PIXEL_SCALER_SCALE2X
+#elif CONFIG_P3A_PIXEL_SCALER_SCALE3X
+#define P3A_PIXEL_SCALER PIXEL_SCALER_SCALE3X
+#elif CONFIG_P3A_PIXEL_SCALER_XBR_LITE
+#define P3A_PIXEL_SCALER PIXEL_SCALER_XBR_LITE
+#else
+#define P3A_PIXEL_SCALER PIXEL_SCALER_NONE
+#endif
+
+#ifndef CONFIG_P3A_LETTERBOX_COLOR
+#define CONFIG_P3A_LETTERBOX_COLOR 0x000000
+#endif
 
 // Asset file type
 typedef enum {
@@ -67,8 +134,7 @@ typedef enum {
 typedef struct {
     char **filenames;
     asset_type_t *types;
-    bool *health_flags;  // true = file is ok, false = file has issues
-    size_t count;
+    size_t count;  // Failure records for s_sd_file_list live in asset_health.c
     size_t current_index;
     char *animations_dir;
 } app_lcd_sd_file_list_t;
@@ -88,19 +154,32 @@ typedef struct {
     uint8_t native_buffer_active;
     size_t native_frame_size;
     
-    // Upscale lookup tables
-    uint16_t *upscale_lookup_x;
-    uint16_t *upscale_lookup_y;
+    // Optional edge-aware pre-scale of the native frame; the lookup tables then index into it
+    pixel_scaler_t prescaler;
+    uint8_t *prescaled_frame;
+    
+    // Upscale lookup tables, indexed relative to the content rectangle. Entries are byte
+    // offsets into the source frame, so rotated (transposed) layouts use the same kernel.
+    uint32_t *upscale_lookup_x;
+    uint32_t *upscale_lookup_y;
     int upscale_src_w, upscale_src_h;
+    // Content rectangle on the panel; everything outside it is letterbox border
+    int upscale_dst_x, upscale_dst_y;
     int upscale_dst_w, upscale_dst_h;
     
+    // Area of the view the artwork is scaled into; zero size means the whole view.
+    // Gallery tiles get a grid cell and skip the LCD-sized prefetch buffer.
+    int viewport_x, viewport_y;
+    int viewport_w, viewport_h;
+    bool gallery_tile;
+    
     // Prefetched first frame (LCD-sized, already upscaled)
     uint8_t *prefetched_first_frame;
     bool first_frame_ready;
     bool decoder_at_frame_1;  // True if decoder has advanced past frame 0
-    bool prefetch_pending;    // True if prefetch needs to be done (by render task)
     uint32_t prefetched_first_frame_delay_ms;  // Delay for the prefetched first frame
     uint32_t current_frame_delay_ms;  // Delay for the most recently decoded frame
+    size_t next_frame_index;  // Frame the decoder produces next; reaching frame_count means the loop is on its last frame
     
     bool ready;  // True when fully loaded and ready to play
 } animation_buffer_t;
@@ -113,19 +192,106 @@ static size_t s_frame_buffer_bytes = 0;
 static size_t s_frame_row_stride_bytes = 0;
 
 static SemaphoreHandle_t s_vsync_sem = NULL;
+static SemaphoreHandle_t s_render_wake_sem = NULL;  // Cuts the render task's waits short for user navigation
 static TaskHandle_t s_anim_task = NULL;
 
-// Double buffer system
-static animation_buffer_t s_front_buffer = {0};  // Currently playing animation
-static animation_buffer_t s_back_buffer = {0};   // Next animation (preloaded)
-static size_t s_next_asset_index = 0;             // Index of animation to load into back buffer
-static bool s_swap_requested = false;            // Flag to request buffer swap
-static bool s_loader_busy = false;               // Flag to prevent duplicate loader triggers
+// Animation slot pool. The render task plays the slot in SLOT_PLAYING; the loader fills the others
+// from a priority queue of load requests: the artwork to show next first, then the neighbour of the
+// one on screen. The state says which task may touch a slot:
+//   SLOT_EMPTY     nothing loaded                                 loader may claim it
+//   SLOT_LOADING   file and decoder being set up                  loader
+//   SLOT_DECODED   loaded, first frame not prefetched yet         render task (prefetch)
+//   SLOT_READY     first frame prefetched, waiting to be shown    read-only; loader may evict it
+//   SLOT_PLAYING   on screen                                      render task
+//   SLOT_RETIRING  replaced on screen, waiting to be unloaded     loader
+// Transitions between two tasks (READY to PLAYING or LOADING) use compare-and-swap.
+typedef enum {
+    SLOT_EMPTY,
+    SLOT_LOADING,
+    SLOT_DECODED,
+    SLOT_READY,
+    SLOT_PLAYING,
+    SLOT_RETIRING,
+} slot_state_t;
+
+typedef enum {
+    LOAD_PRIORITY_PRELOAD,     // Neighbour of the artwork on screen, loaded speculatively
+    LOAD_PRIORITY_SPECULATIVE, // Predicted destination of a fling that is still in progress
+    LOAD_PRIORITY_SCHEDULED,   // Auto-swap target, shown at a loop boundary
+    LOAD_PRIORITY_GALLERY,     // Tile of the gallery page on screen, loaded into the tile itself
+    LOAD_PRIORITY_SHOW,        // Navigation target, shown as soon as it is ready
+} load_priority_t;
+
+typedef struct {
+    animation_buffer_t anim;   // First member: s_front_buffer points here
+    atomic_uint state;         // slot_state_t
+    load_priority_t priority;  // Of the request that filled the slot, guarded by s_buffer_mutex
+} anim_slot_t;
+
+#define ANIM_SLOT_COUNT  CONFIG_P3A_ANIM_SLOT_COUNT
+static anim_slot_t s_slots[ANIM_SLOT_COUNT];
+static animation_buffer_t *_Atomic s_front_buffer = &s_slots[0].anim;  // Currently playing animation
+
+// Pending load requests, highest priority first and oldest first within a priority
+typedef struct {
+    size_t asset_index;
+    load_priority_t priority;
+    uint32_t seq;
+    int tile;                  // Gallery tile to load into, -1 for a slot
+} load_request_t;
+
+#define LOAD_QUEUE_LEN  16     // A whole gallery page and the navigation requests around it
+static load_request_t s_load_queue[LOAD_QUEUE_LEN];  // Guarded by s_buffer_mutex, like the three below
+static size_t s_load_queue_len = 0;
+static uint32_t s_load_seq = 0;
+static size_t s_loading_asset = SIZE_MAX;            // Asset the loader is working on
+static int s_loading_tile = -1;                      // ... the gallery tile it goes into, -1 for a slot
+static load_priority_t s_loading_priority;           // ... and the priority it was requested with
+static atomic_bool s_load_cancel = false;            // The in-flight load is no longer wanted
+
+// Loads check the cancel token between stages and between read chunks of this size
+#define LOAD_CHUNK_BYTES  (64 * 1024)
+#define LOAD_CANCELLED    ESP_ERR_NOT_FINISHED
+
+// What a cancelled load had read, resumed when the same file is requested again (loader task only)
+typedef struct {
+    char *path;
+    uint8_t *data;
+    size_t size;
+    size_t filled;
+} partial_read_t;
+static partial_read_t s_partial_read;
+
+// Player state word shared by the API, the loader and the render task. The render task reads it once
+// per frame and changes it with compare-and-swap, so it never waits on s_buffer_mutex; the API and the
+// loader still take the mutex among themselves around the file list, the load queue and the swap
+// parameters below.
+#define PLAYER_PAUSED            (1U << 0)
+#define PLAYER_SWAP_REQUESTED    (1U << 1)   // Show the swap target once its slot is ready
+#define PLAYER_SWAP_AT_LOOP_END  (1U << 2)   // ... on a loop boundary inside the scheduled window
+#define PLAYER_GALLERY_RELOAD    (1U << 3)   // Gallery grid or page changed
+#define PLAYER_SCRUBBING         (1U << 4)   // Frames follow s_scrub_permille instead of the clock
+static atomic_uint s_player_state = 0;
+static atomic_int s_scrub_permille = 0;     // Scrub position in thousandths of the panel width
+
+// Swap parameters, written by the API under s_buffer_mutex and read by the render task through the
+// sequence counter (odd while a write is in progress).
+// Scheduled swap: the target is preloaded ahead of time and swapped in once the front animation
+// is on the last frame of a loop at or after not_before_us, or at deadline_us at the latest
+typedef struct {
+    size_t target_index;                         // Asset to show
+    int64_t not_before_us;
+    int64_t deadline_us;
+    int64_t requested_us;                        // When the pending user swap was requested (0 if scheduled)
+    int steps;                                   // Artworks the change moves by, negative backward
+} swap_params_t;
+static swap_params_t s_swap_params = {0};
+static atomic_uint s_swap_params_seq = 0;
+
 static TaskHandle_t s_loader_task = NULL;        // Background loader task handle
+static _Atomic int64_t s_front_shown_since_us = 0;  // When the artwork (or gallery page) on screen appeared
 static SemaphoreHandle_t s_loader_sem = NULL;    // Semaphore to signal loader task
-static SemaphoreHandle_t s_buffer_mutex = NULL;  // Mutex for buffer synchronization
-
-static bool s_anim_paused = false;
+static SemaphoreHandle_t s_buffer_mutex = NULL;  // Serializes the API and the loader (not the render task)
 
 // Parallel upscaling workers - use buffer-specific lookup tables
 static TaskHandle_t s_upscale_worker_top = NULL;
@@ -133,20 +299,96 @@ static TaskHandle_t s_upscale_worker_bottom = NULL;
 static TaskHandle_t s_upscale_main_task = NULL;
 static const uint8_t *s_upscale_src_buffer = NULL;
 static uint8_t *s_upscale_dst_buffer = NULL;
-static const uint16_t *s_upscale_lookup_x = NULL;
-static const uint16_t *s_upscale_lookup_y = NULL;
+static const uint32_t *s_upscale_lookup_x = NULL;
+static const uint32_t *s_upscale_lookup_y = NULL;
 static int s_upscale_src_w = 0;
 static int s_upscale_src_h = 0;
+static int s_upscale_dst_x = 0;
+static int s_upscale_dst_y = 0;
+static int s_upscale_dst_w = 0;
+static int s_upscale_dst_h = 0;
 static int s_upscale_row_start_top = 0;
 static int s_upscale_row_end_top = 0;
 static int s_upscale_row_start_bottom = 0;
 static int s_upscale_row_end_bottom = 0;
 static volatile bool s_upscale_worker_top_done = false;
 static volatile bool s_upscale_worker_bottom_done = false;
+static const frame_transition_t *s_upscale_transition = NULL;  // Blended into rows after upscale when set
+static const color_pipeline_t *s_upscale_color = NULL;         // Colour correction tables, NULL for identity
+static const frame_background_t *s_upscale_background = NULL; // Composited under alpha, NULL for opaque assets
+static const osd_layer_t *s_upscale_osd = NULL;                // Composed over rows after upscale when set
+static bool s_upscale_osd_all_rows = false;                    // Also compose into border rows (border repainted)
+static const frame_background_t *s_frame_background = NULL;    // Background latched for the current frame
+
+// Worker job: rows passed to run_upscale_workers() are source rows for a pre-scale, panel rows otherwise
+// Gallery jobs ignore the rows and work through the tiles in s_gallery_work instead
+typedef enum {
+    UPSCALE_JOB_BLIT,
+    UPSCALE_JOB_PRESCALE,
+    UPSCALE_JOB_GALLERY,
+} upscale_job_t;
+static upscale_job_t s_upscale_job = UPSCALE_JOB_BLIT;
+static pixel_scaler_t s_prescale_scaler = PIXEL_SCALER_NONE;
+static const uint8_t *s_prescale_src = NULL;
+static uint8_t *s_prescale_dst = NULL;
+static int s_prescale_src_w = 0;
+static int s_prescale_src_h = 0;
+
+// Gallery mode: several artworks in a grid, each on its own decoder and timeline
+#define GALLERY_MAX_GRID 3
+#define GALLERY_MAX_TILES (GALLERY_MAX_GRID * GALLERY_MAX_GRID)
+
+#ifndef CONFIG_P3A_GALLERY_GRID
+#define CONFIG_P3A_GALLERY_GRID 1
+#endif
+#ifndef CONFIG_P3A_GALLERY_GUTTER
+#define CONFIG_P3A_GALLERY_GUTTER 8
+#endif
+
+// The render task lays out a page with every tile QUEUED; the loader takes each through LOADING to
+// READY or FAILED. Only READY tiles are drawn, and only the render task touches them then.
+typedef enum {
+    TILE_EMPTY,
+    TILE_QUEUED,
+    TILE_LOADING,
+    TILE_READY,
+    TILE_FAILED,
+} tile_state_t;
+
+typedef struct {
+    animation_buffer_t anim;
+    atomic_uint state;       // tile_state_t
+    int64_t next_due_us;     // When the tile's next frame should be shown
+    uint32_t cost_us;        // Last decode + blit time, used to balance the workers
+    uint8_t stale_mask;      // LCD buffers that do not show the latest decoded frame yet
+    bool has_frame;
+    bool decoded;            // Set by the worker when this tick's decode succeeded
+    bool failed;             // Decoder error while playing; the tile keeps its last frame
+} gallery_tile_t;
+
+static gallery_tile_t s_gallery_tiles[GALLERY_MAX_TILES];
+static int s_gallery_grid = 0;              // Grid shown by the render task, 0 for single-artwork playback
+static int s_gallery_tile_count = 0;
+static int s_gallery_requested_grid = 0;    // Requests below are guarded by s_buffer_mutex
+static size_t s_gallery_first_index = 0;    // Asset shown in the first tile
+static size_t s_gallery_next_index = 0;     // Asset after the last tile, start of the next page
+// Work for the current tick: tiles per worker in due order, and which of them decode a new frame
+static uint8_t s_gallery_work[2][GALLERY_MAX_TILES];
+static int s_gallery_work_count[2] = {0};
+static uint16_t s_gallery_decode_mask = 0;
+
+// Animation change transition: snapshot of the outgoing frame blended over the incoming frames
+static uint8_t *s_transition_from_frame = NULL;
+static frame_transition_t s_transition = {0};
 
 static uint8_t s_render_buffer_index = 0;
 static uint8_t s_last_display_buffer = 0;
 
+// Letterbox border bookkeeping: each LCD buffer is filled once per content-rectangle change
+static uint32_t s_border_generation = 1;
+static uint32_t s_lcd_border_generation[EXAMPLE_LCD_BUF_NUM] = {0};
+static bool s_osd_in_border = false;  // Last OSD layer reached outside the content rectangle
+
 static int64_t s_last_frame_present_us = 0;
 static int64_t s_last_duration_update_us = 0;
 static int s_latest_frame_duration_ms = 0;
@@ -154,21 +396,110 @@ static char s_frame_duration_text[11] = "";
 static int64_t s_frame_processing_start_us = 0;  // When current frame processing started
 static uint32_t s_target_frame_delay_ms = 16;     // Target delay for current frame
 
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+// Sync wall: the front animation's timeline on the shared clock
+#define SYNC_WALL_SLOT_US       ((int64_t)CONFIG_P3A_SYNC_WALL_SLOT_MS * 1000)
+#define SYNC_WALL_RESYNC_US     (2 * SYNC_WALL_SLOT_US)  // Further behind than this restarts the timeline
+static bool s_sync_anchored = false;          // First frame has been placed on a shared slot boundary
+static int64_t s_sync_due_shared_us = 0;      // Shared time the frame being rendered is due on screen
+#endif
+
 static app_lcd_sd_file_list_t s_sd_file_list = {0};
+
+#if CONFIG_P3A_FAST_BOOT_LAST_ASSET
+#define LAST_ASSET_NVS_NAMESPACE   "p3a_player"
+#define LAST_ASSET_NVS_KEY         "last_asset"
+// An artwork must stay on screen this long before it becomes the start-up artwork
+#define LOADER_IDLE_TICKS          pdMS_TO_TICKS(CONFIG_P3A_FAST_BOOT_SAVE_DELAY_MS)
+static bool s_enumeration_pending = false;  // Set by init, cleared by the loader task once the list is published
+static char s_last_asset_path[256] = {0};   // Path stored in NVS, only touched by init and the loader task
+#else
+#define LOADER_IDLE_TICKS          portMAX_DELAY
+#endif
 static bool s_sd_mounted = false;
 
-static const uint8_t digit_font[10][DIGIT_HEIGHT] = {
-    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},
-    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x1F},
-    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},
-    {0x0E, 0x11, 0x01, 0x06, 0x01, 0x11, 0x0E},
-    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},
-    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},
-    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},
-    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},
-    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},
-    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},
-};
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+#define THUMB_CACHE_PATH           BSP_SD_MOUNT_POINT "/p3a_thumbs.bin"
+// The thumbnail job makes one thumbnail each time the loader has been idle this long
+#define THUMB_IDLE_TICKS           pdMS_TO_TICKS(CONFIG_P3A_THUMB_IDLE_MS)
+static size_t s_thumb_cursor = SIZE_MAX;         // Next play-order position to check, SIZE_MAX when done (loader task)
+static atomic_bool s_thumb_cancel = false;       // A load request arrived; the thumbnail job gives way
+#endif
+
+// Take the buffer mutex. Contended takes are traced and reported to task_stats. A take still blocked
+// after the inversion bound checks whether the holder is running: a preempted holder is how priority
+// inversions on this mutex show up.
+static inline bool buffer_mutex_take(void)
+{
+    if (!s_buffer_mutex) {
+        return false;
+    }
+    if (xSemaphoreTake(s_buffer_mutex, 0) == pdTRUE) {
+        return true;
+    }
+    TaskHandle_t holder = xSemaphoreGetMutexHolder(s_buffer_mutex);
+    UBaseType_t holder_priority = holder ? uxTaskPriorityGet(holder) : 0;
+    const int64_t wait_start_us = esp_timer_get_time();
+    bool holder_preempted = false;
+    PERF_TRACE_BEGIN(PERF_TRACE_BUFFER_MUTEX);
+    bool taken = (xSemaphoreTake(s_buffer_mutex, task_stats_inversion_bound_ticks()) == pdTRUE);
+    if (!taken) {
+        TaskHandle_t late_holder = xSemaphoreGetMutexHolder(s_buffer_mutex);
+        holder_preempted = late_holder && eTaskGetState(late_holder) == eReady;
+        if (late_holder && late_holder != holder) {
+            holder = late_holder;
+            holder_priority = uxTaskPriorityGet(late_holder);
+        }
+        taken = (xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE);
+    }
+    PERF_TRACE_END(PERF_TRACE_BUFFER_MUTEX);
+    task_stats_note_lock_wait(holder, holder_priority, esp_timer_get_time() - wait_start_us, holder_preempted);
+    return taken;
+}
+
+static inline unsigned player_state_get(void)
+{
+    return atomic_load_explicit(&s_player_state, memory_order_acquire);
+}
+
+// Clear and set state bits in one step, provided every bit of require is set. Returns the state
+// before the call; the update was applied if (old & require) == require.
+static unsigned player_state_update(unsigned require, unsigned clear, unsigned set)
+{
+    unsigned state = player_state_get();
+    do {
+        if ((state & require) != require) {
+            return state;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&s_player_state, &state, (state & ~clear) | set,
+                                                    memory_order_acq_rel, memory_order_acquire));
+    return state;
+}
+
+// Publish new swap parameters (caller holds s_buffer_mutex). The write runs in a critical section so
+// the render task cannot preempt it on the same core and spin on an odd sequence number.
+static portMUX_TYPE s_swap_params_lock = portMUX_INITIALIZER_UNLOCKED;
+static void swap_params_store(const swap_params_t *params)
+{
+    portENTER_CRITICAL(&s_swap_params_lock);
+    atomic_fetch_add_explicit(&s_swap_params_seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    s_swap_params = *params;
+    atomic_fetch_add_explicit(&s_swap_params_seq, 1, memory_order_release);
+    portEXIT_CRITICAL(&s_swap_params_lock);
+}
+
+static swap_params_t swap_params_load(void)
+{
+    swap_params_t params;
+    unsigned seq;
+    do {
+        seq = atomic_load_explicit(&s_swap_params_seq, memory_order_acquire);
+        params = s_swap_params;
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1U) || seq != atomic_load_explicit(&s_swap_params_seq, memory_order_relaxed));
+    return params;
+}
 
 static inline uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b)
 {
@@ -184,16 +515,6 @@ static inline app_lcd_color_t app_lcd_make_color(uint8_t r, uint8_t g, uint8_t b
 {
     return rgb565(r, g, b);
 }
-
-static inline void app_lcd_store_pixel(uint8_t *frame, int x, int y, app_lcd_color_t color)
-{
-    uint16_t *dst_row = (uint16_t *)(frame + (size_t)y * s_frame_row_stride_bytes);
-    const size_t row_pixels = s_frame_row_stride_bytes / sizeof(uint16_t);
-    if ((size_t)x >= row_pixels) {
-        return;
-    }
-    dst_row[x] = color;
-}
 #elif CONFIG_LCD_PIXEL_FORMAT_RGB888
 typedef uint32_t app_lcd_color_t;
 
@@ -201,190 +522,248 @@ static inline app_lcd_color_t app_lcd_make_color(uint8_t r, uint8_t g, uint8_t b
 {
     return ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
 }
-
-static inline void app_lcd_store_pixel(uint8_t *frame, int x, int y, app_lcd_color_t color)
-{
-    uint8_t *row = frame + (size_t)y * s_frame_row_stride_bytes;
-    const size_t idx = (size_t)x * 3U;
-    if ((idx + 2) >= s_frame_row_stride_bytes) {
-        return;
-    }
-    row[idx + 0] = (uint8_t)color;
-    row[idx + 1] = (uint8_t)(color >> 8);
-    row[idx + 2] = (uint8_t)(color >> 16);
-}
 #else
 #error "Unsupported LCD pixel format"
 #endif
 
-static inline void draw_pixel(uint8_t *frame, int x, int y, app_lcd_color_t color)
-{
-    if (!frame) {
-        return;
-    }
-    if (x < 0 || x >= EXAMPLE_LCD_H_RES || y < 0 || y >= EXAMPLE_LCD_V_RES) {
-        return;
-    }
-    app_lcd_store_pixel(frame, x, y, color);
-}
-
-static int char_pixel_width(char c, int scale)
+// Slow path for assets with alpha: composite each pixel over the background, then pack it
+static void blit_composited_row(const uint8_t *src_row, const uint32_t *lookup_x,
+                                uint8_t *dst_buffer, int dst_x0, int dst_w, int dst_y,
+                                const color_pipeline_t *color, const frame_background_t *background)
 {
-    if (scale <= 0) {
-        scale = 1;
-    }
-    if (c >= '0' && c <= '9') {
-        return (DIGIT_WIDTH * scale) + scale;
-    }
-    if (c == '.' || c == ',') {
-        return scale * 2;
-    }
-    if (c == '-') {
-        return (DIGIT_WIDTH * scale) + scale;
+#if CONFIG_LCD_PIXEL_FORMAT_RGB565
+    uint16_t *dst_row = (uint16_t *)(dst_buffer + (size_t)dst_y * s_frame_row_stride_bytes) + dst_x0;
+#else
+    uint8_t *dst_row = dst_buffer + (size_t)dst_y * s_frame_row_stride_bytes + (size_t)dst_x0 * 3U;
+    const size_t row_limit = s_frame_row_stride_bytes - (size_t)dst_x0 * 3U;
+#endif
+    for (int dst_x = 0; dst_x < dst_w; ++dst_x) {
+        const uint8_t *pixel = src_row + lookup_x[dst_x];
+        uint8_t rgb[3];
+        frame_background_composite(background, pixel, dst_x0 + dst_x, dst_y, rgb);
+#if CONFIG_LCD_PIXEL_FORMAT_RGB565
+        dst_row[dst_x] = color ? color_pipeline_pack565(color, rgb[0], rgb[1], rgb[2], dst_x0 + dst_x, dst_y)
+                               : rgb565(rgb[0], rgb[1], rgb[2]);
+#else
+        const size_t idx = (size_t)dst_x * 3U;
+        if ((idx + 2) < row_limit) {
+            dst_row[idx + 0] = color ? color->lut8_b[rgb[2]] : rgb[2]; // B
+            dst_row[idx + 1] = color ? color->lut8_g[rgb[1]] : rgb[1]; // G
+            dst_row[idx + 2] = color ? color->lut8_r[rgb[0]] : rgb[0]; // R
+        }
+#endif
     }
-    return scale * 3;
 }
 
-static void draw_char(uint8_t *frame, char c, int x, int y, int scale, app_lcd_color_t color)
+// Upscale the rows of the content rectangle that fall inside [row_start, row_end).
+// Rows and columns outside the content rectangle (letterbox border) are left untouched.
+// Colour correction and dithering happen here too, through the tables in `color`.
+// Alpha is composited over `background` when set; opaque assets pass NULL and skip it.
+static void blit_webp_frame_rows(const uint8_t *src_rgba, int src_w, int src_h,
+                                 uint8_t *dst_buffer, int dst_x0, int dst_y0, int dst_w, int dst_h,
+                                 int row_start, int row_end,
+                                 const uint32_t *lookup_x, const uint32_t *lookup_y,
+                                 const color_pipeline_t *color, const frame_background_t *background)
 {
-    if (!frame) {
+    if (!src_rgba || !dst_buffer || src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0) {
         return;
     }
-    if (scale <= 0) {
-        scale = 1;
-    }
-    if (c == ' ') {
+    
+    if (row_start < dst_y0) row_start = dst_y0;
+    if (row_end > dst_y0 + dst_h) row_end = dst_y0 + dst_h;
+    if (row_start >= row_end) return;
+    
+    if (!lookup_x || !lookup_y) {
+        ESP_LOGE(TAG, "Upscale lookup tables not initialized");
         return;
     }
-    if (c == '.' || c == ',') {
-        const int dot_size = MAX(1, scale / 2);
-        const int base_x = x;
-        const int base_y = y + (DIGIT_HEIGHT * scale) - dot_size - 1;
-        for (int dy = 0; dy < dot_size; ++dy) {
-            for (int dx = 0; dx < dot_size; ++dx) {
-                draw_pixel(frame, base_x + dx, base_y + dy, color);
-            }
+    
+    for (int dst_y = row_start; dst_y < row_end; ++dst_y) {
+        // Row and column offsets are independent, whatever the rotation: for 90/270 degrees
+        // the "row" offset selects a source column and the column offsets walk down it
+        const uint8_t *src_row = src_rgba + lookup_y[dst_y - dst_y0];
+        
+        if (background) {
+            blit_composited_row(src_row, lookup_x, dst_buffer, dst_x0, dst_w, dst_y, color, background);
+            continue;
         }
-        return;
-    }
-    if (c == '-') {
-        const int line_height = MAX(1, scale / 2);
-        const int base_y = y + (DIGIT_HEIGHT * scale) / 2;
-        for (int dy = 0; dy < line_height; ++dy) {
-            for (int dx = 0; dx < DIGIT_WIDTH * scale; ++dx) {
-                draw_pixel(frame, x + dx, base_y + dy, color);
+        
+#if CONFIG_LCD_PIXEL_FORMAT_RGB565
+        uint16_t *dst_row = (uint16_t *)(dst_buffer + (size_t)dst_y * s_frame_row_stride_bytes) + dst_x0;
+        if (color) {
+            for (int dst_x = 0; dst_x < dst_w; ++dst_x) {
+                const uint8_t *pixel = src_row + lookup_x[dst_x];
+                dst_row[dst_x] = color_pipeline_pack565(color, pixel[0], pixel[1], pixel[2], dst_x0 + dst_x, dst_y);
             }
+            continue;
         }
-        return;
-    }
-    if (c < '0' || c > '9') {
-        return;
-    }
-
-    const uint8_t *glyph = digit_font[c - '0'];
-    for (int row = 0; row < DIGIT_HEIGHT; ++row) {
-        const uint8_t bits = glyph[row];
-        for (int col = 0; col < DIGIT_WIDTH; ++col) {
-            if ((bits >> (DIGIT_WIDTH - 1 - col)) & 0x01) {
-                const int px = x + col * scale;
-                const int py = y + row * scale;
-                for (int dy = 0; dy < scale; ++dy) {
-                    for (int dx = 0; dx < scale; ++dx) {
-                        draw_pixel(frame, px + dx, py + dy, color);
-                    }
+        for (int dst_x = 0; dst_x < dst_w; ++dst_x) {
+            const uint8_t *pixel = src_row + lookup_x[dst_x];
+            dst_row[dst_x] = rgb565(pixel[0], pixel[1], pixel[2]);
+        }
+#else
+        uint8_t *dst_row = dst_buffer + (size_t)dst_y * s_frame_row_stride_bytes + (size_t)dst_x0 * 3U;
+        const size_t row_limit = s_frame_row_stride_bytes - (size_t)dst_x0 * 3U;
+        if (color) {
+            for (int dst_x = 0; dst_x < dst_w; ++dst_x) {
+                const uint8_t *pixel = src_row + lookup_x[dst_x];
+                const size_t idx = (size_t)dst_x * 3U;
+                if ((idx + 2) < row_limit) {
+                    dst_row[idx + 0] = color->lut8_b[pixel[2]];
+                    dst_row[idx + 1] = color->lut8_g[pixel[1]];
+                    dst_row[idx + 2] = color->lut8_r[pixel[0]];
                 }
             }
+            continue;
+        }
+        for (int dst_x = 0; dst_x < dst_w; ++dst_x) {
+            const uint8_t *pixel = src_row + lookup_x[dst_x];
+            const size_t idx = (size_t)dst_x * 3U;
+            if ((idx + 2) < row_limit) {
+                dst_row[idx + 0] = pixel[2]; // B
+                dst_row[idx + 1] = pixel[1]; // G
+                dst_row[idx + 2] = pixel[0]; // R
+            }
         }
+#endif
     }
 }
 
-static void draw_text(uint8_t *frame, const char *text, int x, int y, int scale, app_lcd_color_t color)
+// Fill one row span [x0, x1) with the letterbox colour
+static void fill_row_span(uint8_t *row, int x0, int x1, app_lcd_color_t color)
 {
-    if (!frame || !text) {
-        return;
+    if (x0 < 0) x0 = 0;
+    if (x1 > EXAMPLE_LCD_H_RES) x1 = EXAMPLE_LCD_H_RES;
+    if (x0 >= x1) return;
+    
+#if CONFIG_LCD_PIXEL_FORMAT_RGB565
+    uint16_t *px = (uint16_t *)row;
+    for (int x = x0; x < x1; ++x) {
+        px[x] = color;
     }
-    if (scale <= 0) {
-        scale = 1;
+#else
+    if (color == 0) {
+        memset(row + (size_t)x0 * 3U, 0, (size_t)(x1 - x0) * 3U);
+        return;
     }
-    int cursor_x = x;
-    for (const char *ch = text; *ch; ++ch) {
-        draw_char(frame, *ch, cursor_x, y, scale, color);
-        cursor_x += char_pixel_width(*ch, scale);
+    for (int x = x0; x < x1; ++x) {
+        uint8_t *px = row + (size_t)x * 3U;
+        px[0] = (uint8_t)color;
+        px[1] = (uint8_t)(color >> 8);
+        px[2] = (uint8_t)(color >> 16);
     }
+#endif
 }
 
-static int measure_text_width(const char *text, int scale)
+// Paint everything outside the buffer's content rectangle with the letterbox colour
+static void fill_letterbox_border(uint8_t *frame, const animation_buffer_t *buf)
 {
-    if (!text || scale <= 0) {
-        return 0;
+    if (!frame || !buf) {
+        return;
     }
-    int width = 0;
-    for (const char *ch = text; *ch; ++ch) {
-        width += char_pixel_width(*ch, scale);
+    const app_lcd_color_t color = app_lcd_make_color((CONFIG_P3A_LETTERBOX_COLOR >> 16) & 0xFF,
+                                                     (CONFIG_P3A_LETTERBOX_COLOR >> 8) & 0xFF,
+                                                     CONFIG_P3A_LETTERBOX_COLOR & 0xFF);
+    const int x0 = buf->upscale_dst_x;
+    const int x1 = buf->upscale_dst_x + buf->upscale_dst_w;
+    const int y0 = buf->upscale_dst_y;
+    const int y1 = buf->upscale_dst_y + buf->upscale_dst_h;
+    
+    for (int y = 0; y < EXAMPLE_LCD_V_RES; ++y) {
+        uint8_t *row = frame + (size_t)y * s_frame_row_stride_bytes;
+        if (y < y0 || y >= y1) {
+            fill_row_span(row, 0, EXAMPLE_LCD_H_RES, color);
+        } else {
+            fill_row_span(row, 0, x0, color);
+            fill_row_span(row, x1, EXAMPLE_LCD_H_RES, color);
+        }
     }
-    return width;
 }
 
-static void draw_text_top_right(uint8_t *frame, const char *text, int margin_x, int margin_y, int scale, app_lcd_color_t color)
+// Decode a gallery tile's next frame into its spare native buffer (and pre-scale it)
+static void gallery_decode_tile(gallery_tile_t *tile)
 {
-    if (!frame || !text) {
+    animation_buffer_t *buf = &tile->anim;
+    uint8_t *target = (buf->native_buffer_active == 0) ? buf->native_frame_b2 : buf->native_frame_b1;
+    
+    esp_err_t err = animation_decoder_decode_next(buf->decoder, target);
+    if (err == ESP_ERR_INVALID_STATE) {
+        animation_decoder_reset(buf->decoder);
+        err = animation_decoder_decode_next(buf->decoder, target);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Gallery tile (asset %zu) stopped: %s", buf->asset_index, esp_err_to_name(err));
+        tile->failed = true;
         return;
     }
     
-    if (scale <= 0) {
-        scale = 1;
+    uint32_t delay_ms = 1;
+    if (animation_decoder_get_frame_delay(buf->decoder, &delay_ms) != ESP_OK || delay_ms == 0) {
+        delay_ms = 1;
     }
-    const int width = measure_text_width(text, scale);
-    int draw_x = EXAMPLE_LCD_H_RES - margin_x - width;
-    if (draw_x < 0) {
-        draw_x = 0;
+    buf->current_frame_delay_ms = delay_ms;
+    buf->native_buffer_active = (buf->native_buffer_active == 0) ? 1 : 0;
+    
+    if (buf->prescaler != PIXEL_SCALER_NONE && buf->prescaled_frame) {
+        const int canvas_h = (int)buf->decoder_info.canvas_height;
+        pixel_scaler_run_rows(buf->prescaler, target, (int)buf->decoder_info.canvas_width, canvas_h,
+                              buf->prescaled_frame, 0, canvas_h);
     }
-    draw_text(frame, text, draw_x, margin_y, scale, color);
+    tile->has_frame = true;
+    tile->decoded = true;
 }
 
-static void blit_webp_frame_rows(const uint8_t *src_rgba, int src_w, int src_h,
-                                 uint8_t *dst_buffer, int dst_w, int dst_h,
-                                 int row_start, int row_end,
-                                 const uint16_t *lookup_x, const uint16_t *lookup_y)
+// Draw a tile's latest frame into its cell of an LCD buffer
+static void gallery_blit_tile(const gallery_tile_t *tile, uint8_t *dst)
 {
-    if (!src_rgba || !dst_buffer || src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0) {
-        return;
-    }
-    
-    if (row_start < 0) row_start = 0;
-    if (row_end > dst_h) row_end = dst_h;
-    if (row_start >= row_end) return;
-    
-    if (!lookup_x || !lookup_y) {
-        ESP_LOGE(TAG, "Upscale lookup tables not initialized");
-        return;
+    const animation_buffer_t *buf = &tile->anim;
+    const uint8_t *src = (buf->native_buffer_active == 0) ? buf->native_frame_b1 : buf->native_frame_b2;
+    if (buf->prescaler != PIXEL_SCALER_NONE && buf->prescaled_frame) {
+        src = buf->prescaled_frame;
+    }
+    blit_webp_frame_rows(src, buf->upscale_src_w, buf->upscale_src_h, dst,
+                         buf->upscale_dst_x, buf->upscale_dst_y, buf->upscale_dst_w, buf->upscale_dst_h,
+                         buf->upscale_dst_y, buf->upscale_dst_y + buf->upscale_dst_h,
+                         buf->upscale_lookup_x, buf->upscale_lookup_y, s_upscale_color,
+                         buf->decoder_info.has_transparency ? s_frame_background : NULL);
+}
+
+static void run_gallery_work(int worker)
+{
+    for (int i = 0; i < s_gallery_work_count[worker]; ++i) {
+        const int index = s_gallery_work[worker][i];
+        gallery_tile_t *tile = &s_gallery_tiles[index];
+        const int64_t start_us = esp_timer_get_time();
+        if (s_gallery_decode_mask & (1U << index)) {
+            gallery_decode_tile(tile);
+        }
+        if (tile->has_frame) {
+            gallery_blit_tile(tile, s_upscale_dst_buffer);
+        }
+        tile->cost_us = (uint32_t)(esp_timer_get_time() - start_us);
     }
-    
-    for (int dst_y = row_start; dst_y < row_end; ++dst_y) {
-        const uint16_t src_y = lookup_y[dst_y];
-        const uint8_t *src_row = src_rgba + (size_t)src_y * src_w * 4;
-        
-#if CONFIG_LCD_PIXEL_FORMAT_RGB565
-        uint16_t *dst_row = (uint16_t *)(dst_buffer + (size_t)dst_y * s_frame_row_stride_bytes);
-        for (int dst_x = 0; dst_x < dst_w; ++dst_x) {
-            const uint16_t src_x = lookup_x[dst_x];
-            const uint8_t *pixel = src_row + (size_t)src_x * 4;
-            dst_row[dst_x] = rgb565(pixel[0], pixel[1], pixel[2]);
+}
+
+// True when the upscaler rewrites every pixel under the OSD layer on each frame
+static bool osd_layer_inside_content(const osd_layer_t *layer, const animation_buffer_t *buf)
+{
+    return layer->x0 >= buf->upscale_dst_x && layer->x1 <= buf->upscale_dst_x + buf->upscale_dst_w &&
+           layer->y0 >= buf->upscale_dst_y && layer->y1 <= buf->upscale_dst_y + buf->upscale_dst_h;
+}
+
+// Overlay the OSD on freshly written rows. Border rows keep their OSD pixels until the border
+// is repainted, so they are only composed on frames that repaint it.
+static void compose_osd_rows(int row_start, int row_end)
+{
+    if (!s_upscale_osd_all_rows) {
+        if (row_start < s_upscale_dst_y) {
+            row_start = s_upscale_dst_y;
         }
-#else
-        uint8_t *dst_row = dst_buffer + (size_t)dst_y * s_frame_row_stride_bytes;
-        for (int dst_x = 0; dst_x < dst_w; ++dst_x) {
-            const uint16_t src_x = lookup_x[dst_x];
-            const uint8_t *pixel = src_row + (size_t)src_x * 4;
-            const size_t idx = (size_t)dst_x * 3U;
-            if ((idx + 2) < s_frame_row_stride_bytes) {
-                dst_row[idx + 0] = pixel[2]; // B
-                dst_row[idx + 1] = pixel[1]; // G
-                dst_row[idx + 2] = pixel[0]; // R
-            }
+        if (row_end > s_upscale_dst_y + s_upscale_dst_h) {
+            row_end = s_upscale_dst_y + s_upscale_dst_h;
         }
-#endif
     }
+    osd_compose_rows(s_upscale_osd, s_upscale_dst_buffer, s_frame_row_stride_bytes, row_start, row_end);
 }
 
 static void upscale_worker_top_task(void *arg)
@@ -399,17 +778,35 @@ static void upscale_worker_top_task(void *arg)
         
         // Memory barrier to ensure we see all shared variables set by main task
         MEMORY_BARRIER();
+        PERF_TRACE_BEGIN(PERF_TRACE_UPSCALE_ROWS);
         
-        if (s_upscale_src_buffer && s_upscale_dst_buffer && 
+        if (s_upscale_job == UPSCALE_JOB_PRESCALE) {
+            pixel_scaler_run_rows(s_prescale_scaler, s_prescale_src, s_prescale_src_w, s_prescale_src_h,
+                                  s_prescale_dst, s_upscale_row_start_top, s_upscale_row_end_top);
+        } else if (s_upscale_job == UPSCALE_JOB_GALLERY) {
+            run_gallery_work(0);
+        } else if (s_upscale_src_buffer && s_upscale_dst_buffer && 
             s_upscale_row_start_top < s_upscale_row_end_top) {
             blit_webp_frame_rows(s_upscale_src_buffer,
                                 s_upscale_src_w, s_upscale_src_h,
                                 s_upscale_dst_buffer,
-                                EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES,
+                                s_upscale_dst_x, s_upscale_dst_y,
+                                s_upscale_dst_w, s_upscale_dst_h,
                                 s_upscale_row_start_top, s_upscale_row_end_top,
-                                s_upscale_lookup_x, s_upscale_lookup_y);
+                                s_upscale_lookup_x, s_upscale_lookup_y,
+                                s_upscale_color, s_upscale_background);
+        }
+        
+        if (s_upscale_job == UPSCALE_JOB_BLIT && s_upscale_transition && s_upscale_dst_buffer) {
+            frame_transition_apply_rows(s_upscale_transition, s_upscale_dst_buffer,
+                                        s_upscale_row_start_top, s_upscale_row_end_top);
+        }
+        
+        if (s_upscale_job == UPSCALE_JOB_BLIT && s_upscale_osd && s_upscale_dst_buffer) {
+            compose_osd_rows(s_upscale_row_start_top, s_upscale_row_end_top);
         }
         
+        PERF_TRACE_END(PERF_TRACE_UPSCALE_ROWS);
         // Memory barrier to ensure all writes to dst_buffer are visible to other cores/DMA
         MEMORY_BARRIER();
         
@@ -432,17 +829,35 @@ static void upscale_worker_bottom_task(void *arg)
         
         // Memory barrier to ensure we see all shared variables set by main task
         MEMORY_BARRIER();
+        PERF_TRACE_BEGIN(PERF_TRACE_UPSCALE_ROWS);
         
-        if (s_upscale_src_buffer && s_upscale_dst_buffer && 
+        if (s_upscale_job == UPSCALE_JOB_PRESCALE) {
+            pixel_scaler_run_rows(s_prescale_scaler, s_prescale_src, s_prescale_src_w, s_prescale_src_h,
+                                  s_prescale_dst, s_upscale_row_start_bottom, s_upscale_row_end_bottom);
+        } else if (s_upscale_job == UPSCALE_JOB_GALLERY) {
+            run_gallery_work(1);
+        } else if (s_upscale_src_buffer && s_upscale_dst_buffer && 
             s_upscale_row_start_bottom < s_upscale_row_end_bottom) {
             blit_webp_frame_rows(s_upscale_src_buffer,
                                 s_upscale_src_w, s_upscale_src_h,
                                 s_upscale_dst_buffer,
-                                EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES,
+                                s_upscale_dst_x, s_upscale_dst_y,
+                                s_upscale_dst_w, s_upscale_dst_h,
                                 s_upscale_row_start_bottom, s_upscale_row_end_bottom,
-                                s_upscale_lookup_x, s_upscale_lookup_y);
+                                s_upscale_lookup_x, s_upscale_lookup_y,
+                                s_upscale_color, s_upscale_background);
+        }
+        
+        if (s_upscale_job == UPSCALE_JOB_BLIT && s_upscale_transition && s_upscale_dst_buffer) {
+            frame_transition_apply_rows(s_upscale_transition, s_upscale_dst_buffer,
+                                        s_upscale_row_start_bottom, s_upscale_row_end_bottom);
+        }
+        
+        if (s_upscale_job == UPSCALE_JOB_BLIT && s_upscale_osd && s_upscale_dst_buffer) {
+            compose_osd_rows(s_upscale_row_start_bottom, s_upscale_row_end_bottom);
         }
         
+        PERF_TRACE_END(PERF_TRACE_UPSCALE_ROWS);
         // Memory barrier to ensure all writes to dst_buffer are visible to other cores/DMA
         MEMORY_BARRIER();
         
@@ -453,65 +868,30 @@ static void upscale_worker_bottom_task(void *arg)
     }
 }
 
-// Render next frame from animation buffer
-static int render_next_frame(animation_buffer_t *buf, uint8_t *dest_buffer, int target_w, int target_h, bool use_prefetched)
+// Point the upscale workers at a buffer's lookup tables and content rectangle
+static void set_upscale_params(const animation_buffer_t *buf, const uint8_t *src, uint8_t *dst)
 {
-    if (!buf || !buf->ready || !dest_buffer || !buf->decoder) {
-        return -1;
-    }
-    
-    // If prefetched frame is available and we're on the first frame, use it
-    if (use_prefetched && buf->first_frame_ready && buf->prefetched_first_frame) {
-        memcpy(dest_buffer, buf->prefetched_first_frame, s_frame_buffer_bytes);
-        buf->first_frame_ready = false;  // Clear flag so we don't use it again
-        return (int)buf->prefetched_first_frame_delay_ms;
-    }
-    
-    if (!buf->native_frame_b1 || !buf->native_frame_b2) {
-        ESP_LOGE(TAG, "Native frame buffers not allocated");
-        return -1;
-    }
-
-    uint8_t *decode_buffer = (buf->native_buffer_active == 0) ? buf->native_frame_b1 : buf->native_frame_b2;
-    
-    esp_err_t err = animation_decoder_decode_next(buf->decoder, decode_buffer);
-    if (err == ESP_ERR_INVALID_STATE) {
-        // End of animation, reset
-        animation_decoder_reset(buf->decoder);
-        err = animation_decoder_decode_next(buf->decoder, decode_buffer);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Animation decoder could not restart");
-            return -1;
-        }
-    } else if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to decode frame: %s", esp_err_to_name(err));
-        return -1;
-    }
-    
-    // Get frame delay after decoding
-    uint32_t frame_delay_ms = 1;
-    esp_err_t delay_err = animation_decoder_get_frame_delay(buf->decoder, &frame_delay_ms);
-    if (delay_err != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to get frame delay, using default");
-        frame_delay_ms = 1;
-    }
-    buf->current_frame_delay_ms = frame_delay_ms;
-    
-    buf->native_buffer_active = (buf->native_buffer_active == 0) ? 1 : 0;
-    
-    const uint8_t *src_for_upscale = decode_buffer;
-    
-    // Set up shared parameters for workers
-    s_upscale_src_buffer = src_for_upscale;
-    s_upscale_dst_buffer = dest_buffer;
+    s_upscale_src_buffer = src;
+    s_upscale_dst_buffer = dst;
     s_upscale_lookup_x = buf->upscale_lookup_x;
     s_upscale_lookup_y = buf->upscale_lookup_y;
     s_upscale_src_w = buf->upscale_src_w;
     s_upscale_src_h = buf->upscale_src_h;
-    s_upscale_main_task = xTaskGetCurrentTaskHandle();
-    
-    const int dst_h = target_h;
+    s_upscale_dst_x = buf->upscale_dst_x;
+    s_upscale_dst_y = buf->upscale_dst_y;
+    s_upscale_dst_w = buf->upscale_dst_w;
+    s_upscale_dst_h = buf->upscale_dst_h;
+}
+
+// Split rows [0, dst_h) between both upscale workers and wait until both have finished.
+// Callers set s_upscale_job and its parameters (set_upscale_params() for blits) beforehand;
+// a blit with a NULL source skips the upscale and only applies s_upscale_transition.
+static bool run_upscale_workers(int dst_h)
+{
     const int mid_row = dst_h / 2;
+    const int64_t start_us = esp_timer_get_time();
+    
+    s_upscale_main_task = xTaskGetCurrentTaskHandle();
     
     s_upscale_worker_top_done = false;
     s_upscale_worker_bottom_done = false;
@@ -536,6 +916,7 @@ static int render_next_frame(animation_buffer_t *buf, uint8_t *dest_buffer, int
     const uint32_t all_bits = (1UL << 0) | (1UL << 1);
     uint32_t notification_value = 0;
     
+    PERF_TRACE_BEGIN(PERF_TRACE_UPSCALE_WAIT);
     while ((notification_value & all_bits) != all_bits) {
         uint32_t received_bits = 0;
         if (xTaskNotifyWait(0, UINT32_MAX, &received_bits, pdMS_TO_TICKS(50)) == pdTRUE) {
@@ -545,71 +926,412 @@ static int render_next_frame(animation_buffer_t *buf, uint8_t *dest_buffer, int
             taskYIELD();
         }
     }
-    
-    if (!s_upscale_worker_top_done || !s_upscale_worker_bottom_done) {
-        ESP_LOGW(TAG, "Upscale workers may not have completed properly");
-    }
+    PERF_TRACE_END(PERF_TRACE_UPSCALE_WAIT);
+    metrics_observe_us(METRICS_UPSCALE_TIME, esp_timer_get_time() - start_us);
     
     // Memory barrier to ensure all worker writes are visible before DMA
     MEMORY_BARRIER();
-
-    return (int)buf->current_frame_delay_ms;
+    
+    return s_upscale_worker_top_done && s_upscale_worker_bottom_done;
 }
 
-static bool lcd_panel_refresh_done_cb(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t *edata, void *user_ctx)
+// Upscale a decoded native frame into dst: optional edge-aware pre-scale, then the nearest pass.
+// Both phases are split across the worker pair; the second starts once every pre-scaled row exists.
+static bool upscale_frame(const animation_buffer_t *buf, const uint8_t *native_frame, uint8_t *dst, int dst_h)
 {
-    (void)panel;
-    (void)edata;
-    SemaphoreHandle_t sem = (SemaphoreHandle_t)user_ctx;
-    BaseType_t higher_prio_task_woken = pdFALSE;
-    if (sem) {
-        xSemaphoreGiveFromISR(sem, &higher_prio_task_woken);
+    const uint8_t *src = native_frame;
+    bool ok = true;
+    
+    if (buf->prescaler != PIXEL_SCALER_NONE && buf->prescaled_frame) {
+        s_upscale_job = UPSCALE_JOB_PRESCALE;
+        s_prescale_scaler = buf->prescaler;
+        s_prescale_src = native_frame;
+        s_prescale_dst = buf->prescaled_frame;
+        s_prescale_src_w = (int)buf->decoder_info.canvas_width;
+        s_prescale_src_h = (int)buf->decoder_info.canvas_height;
+        ok = run_upscale_workers(s_prescale_src_h);
+        s_upscale_job = UPSCALE_JOB_BLIT;
+        src = buf->prescaled_frame;
+    }
+    
+    set_upscale_params(buf, src, dst);
+    s_upscale_background = buf->decoder_info.has_transparency ? s_frame_background : NULL;
+    return run_upscale_workers(dst_h) && ok;
+}
+
+// Render next frame from animation buffer
+static int render_next_frame(animation_buffer_t *buf, uint8_t *dest_buffer, int target_w, int target_h, bool use_prefetched)
+{
+    if (!buf || !buf->ready || !dest_buffer || !buf->decoder) {
+        return -1;
+    }
+    
+    s_upscale_transition = frame_transition_active(&s_transition) ? &s_transition : NULL;
+    s_upscale_color = color_pipeline_begin_frame();
+    s_frame_background = frame_background_begin_frame();
+    
+    // If prefetched frame is available and we're on the first frame, use it
+    if (use_prefetched && buf->first_frame_ready && buf->prefetched_first_frame) {
+        memcpy(dest_buffer, buf->prefetched_first_frame, s_frame_buffer_bytes);
+        buf->first_frame_ready = false;  // Clear flag so we don't use it again
+        if (s_upscale_transition || s_upscale_osd) {
+            // Nothing to upscale, let the workers only blend the outgoing frame in and overlay the OSD
+            s_upscale_src_buffer = NULL;
+            s_upscale_dst_buffer = dest_buffer;
+            if (!run_upscale_workers(target_h)) {
+                ESP_LOGW(TAG, "Upscale workers may not have completed transition blend");
+            }
+        }
+        return (int)buf->prefetched_first_frame_delay_ms;
+    }
+    
+    if (!buf->native_frame_b1 || !buf->native_frame_b2) {
+        ESP_LOGE(TAG, "Native frame buffers not allocated");
+        return -1;
+    }
+
+    uint8_t *decode_buffer = (buf->native_buffer_active == 0) ? buf->native_frame_b1 : buf->native_frame_b2;
+    
+    PERF_TRACE_BEGIN(PERF_TRACE_DECODE);
+    const int64_t decode_start_us = esp_timer_get_time();
+    esp_err_t err = animation_decoder_decode_next(buf->decoder, decode_buffer);
+    bool restarted = false;
+    if (err == ESP_ERR_INVALID_STATE) {
+        // End of animation, reset
+        animation_decoder_reset(buf->decoder);
+        buf->next_frame_index = 0;
+        restarted = true;
+        err = animation_decoder_decode_next(buf->decoder, decode_buffer);
+    }
+    PERF_TRACE_END(PERF_TRACE_DECODE);
+    metrics_observe_us(METRICS_DECODE_TIME, esp_timer_get_time() - decode_start_us);
+    if (restarted && err != ESP_OK) {
+        ESP_LOGE(TAG, "Animation decoder could not restart");
+        return -1;
+    } else if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to decode frame: %s", esp_err_to_name(err));
+        return -1;
+    }
+    buf->next_frame_index++;
+    
+    // Get frame delay after decoding
+    uint32_t frame_delay_ms = 1;
+    esp_err_t delay_err = animation_decoder_get_frame_delay(buf->decoder, &frame_delay_ms);
+    if (delay_err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to get frame delay, using default");
+        frame_delay_ms = 1;
+    }
+    buf->current_frame_delay_ms = frame_delay_ms;
+    
+    buf->native_buffer_active = (buf->native_buffer_active == 0) ? 1 : 0;
+    
+    if (!upscale_frame(buf, decode_buffer, dest_buffer, target_h)) {
+        ESP_LOGW(TAG, "Upscale workers may not have completed properly");
+    }
+
+    return (int)buf->current_frame_delay_ms;
+}
+
+static bool lcd_panel_refresh_done_cb(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t *edata, void *user_ctx)
+{
+    (void)panel;
+    (void)edata;
+    SemaphoreHandle_t sem = (SemaphoreHandle_t)user_ctx;
+    BaseType_t higher_prio_task_woken = pdFALSE;
+    if (sem) {
+        xSemaphoreGiveFromISR(sem, &higher_prio_task_woken);
     }
     return higher_prio_task_woken == pdTRUE;
 }
 
 // Forward declarations - must be before functions that use them
 static size_t get_next_asset_index(size_t current_index);
-static void swap_buffers(void);
-static esp_err_t load_animation_into_buffer(size_t asset_index, animation_buffer_t *buf);
+static bool swap_buffers(anim_slot_t *slot, int64_t requested_us);
+static esp_err_t load_animation_into_buffer(size_t asset_index, animation_buffer_t *buf, const atomic_bool *cancel);
 static void unload_animation_buffer(animation_buffer_t *buf);
 static esp_err_t prefetch_first_frame(animation_buffer_t *buf);
 static int render_next_frame(animation_buffer_t *buf, uint8_t *dest_buffer, int target_w, int target_h, bool use_prefetched);
 static void discard_failed_swap_request(size_t failed_asset_index, esp_err_t error);
+#if CONFIG_P3A_FAST_BOOT_LAST_ASSET
+static void finish_deferred_enumeration(void);
+static void save_last_asset_path(void);
+#endif
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+static void thumb_job_step(void);
+#endif
+
+static inline slot_state_t slot_state(const anim_slot_t *slot)
+{
+    return (slot_state_t)atomic_load_explicit(&slot->state, memory_order_acquire);
+}
+
+static inline bool slot_transition(anim_slot_t *slot, slot_state_t from, slot_state_t to)
+{
+    unsigned expected = from;
+    return atomic_compare_exchange_strong_explicit(&slot->state, &expected, to,
+                                                   memory_order_acq_rel, memory_order_acquire);
+}
+
+// Slot, other than the one on screen, holding a loaded copy of the asset; NULL if there is none
+static anim_slot_t *find_loaded_slot(size_t asset_index)
+{
+    for (int i = 0; i < ANIM_SLOT_COUNT; ++i) {
+        const slot_state_t state = slot_state(&s_slots[i]);
+        if ((state == SLOT_DECODED || state == SLOT_READY) && s_slots[i].anim.asset_index == asset_index) {
+            return &s_slots[i];
+        }
+    }
+    return NULL;
+}
+
+// Whether the asset is loaded, being loaded or queued (caller holds s_buffer_mutex)
+static bool asset_pending_or_loaded(size_t asset_index)
+{
+    if ((s_loading_tile < 0 && s_loading_asset == asset_index) || find_loaded_slot(asset_index)) {
+        return true;
+    }
+    for (size_t i = 0; i < s_load_queue_len; ++i) {
+        if (s_load_queue[i].tile < 0 && s_load_queue[i].asset_index == asset_index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Queue a load request (caller holds s_buffer_mutex). A request for an asset that is already queued
+// only raises its priority; when the queue is full the lowest-priority request makes room.
+static void load_queue_push(size_t asset_index, load_priority_t priority)
+{
+    for (size_t i = 0; i < s_load_queue_len; ++i) {
+        if (s_load_queue[i].tile < 0 && s_load_queue[i].asset_index == asset_index) {
+            if (priority > s_load_queue[i].priority) {
+                s_load_queue[i].priority = priority;
+            }
+            return;
+        }
+    }
+    if (s_load_queue_len == LOAD_QUEUE_LEN) {
+        // Gallery tiles are never evicted; their page is waiting on them
+        int victim = -1;
+        for (size_t i = 0; i < s_load_queue_len; ++i) {
+            if (s_load_queue[i].tile < 0 &&
+                (victim < 0 || s_load_queue[i].priority < s_load_queue[victim].priority)) {
+                victim = (int)i;
+            }
+        }
+        if (victim < 0 || s_load_queue[victim].priority >= priority) {
+            return;
+        }
+        s_load_queue[victim] = s_load_queue[--s_load_queue_len];
+    }
+    s_load_queue[s_load_queue_len++] = (load_request_t){
+        .asset_index = asset_index,
+        .priority = priority,
+        .seq = s_load_seq++,
+        .tile = -1,
+    };
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+    atomic_store(&s_thumb_cancel, true);
+#endif
+}
 
-// Discard a failed swap request and restore system to responsive state
+// Queue the load of a gallery tile (caller holds s_buffer_mutex, the tile is QUEUED)
+static void load_queue_push_tile(size_t asset_index, int tile)
+{
+    // The queue holds a whole page, so a full queue always has a slot request to evict
+    if (s_load_queue_len == LOAD_QUEUE_LEN) {
+        size_t victim = 0;
+        for (size_t i = 1; i < s_load_queue_len; ++i) {
+            if (s_load_queue[victim].tile >= 0 ||
+                (s_load_queue[i].tile < 0 && s_load_queue[i].priority < s_load_queue[victim].priority)) {
+                victim = i;
+            }
+        }
+        s_load_queue[victim] = s_load_queue[--s_load_queue_len];
+    }
+    s_load_queue[s_load_queue_len++] = (load_request_t){
+        .asset_index = asset_index,
+        .priority = LOAD_PRIORITY_GALLERY,
+        .seq = s_load_seq++,
+        .tile = tile,
+    };
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+    atomic_store(&s_thumb_cancel, true);
+#endif
+}
+
+// The gallery page changes (caller holds s_buffer_mutex): drop the queued tile loads and cancel the
+// one in flight
+static void load_queue_drop_tiles(void)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < s_load_queue_len; ++i) {
+        if (s_load_queue[i].tile < 0) {
+            s_load_queue[kept++] = s_load_queue[i];
+        }
+    }
+    s_load_queue_len = kept;
+    if (s_loading_tile >= 0) {
+        atomic_store(&s_load_cancel, true);
+    }
+}
+
+// Position of the request to serve next (caller holds s_buffer_mutex), -1 if the queue is empty
+static int load_queue_best(void)
+{
+    int best = -1;
+    for (size_t i = 0; i < s_load_queue_len; ++i) {
+        if (best < 0 || s_load_queue[i].priority > s_load_queue[best].priority ||
+            (s_load_queue[i].priority == s_load_queue[best].priority &&
+             (int32_t)(s_load_queue[i].seq - s_load_queue[best].seq) < 0)) {
+            best = (int)i;
+        }
+    }
+    return best;
+}
+
+static void load_queue_remove(int pos)
+{
+    s_load_queue[pos] = s_load_queue[--s_load_queue_len];
+}
+
+// Navigation moved on to asset_index (caller holds s_buffer_mutex): drop the requests for anything
+// else, cancel the in-flight load if it is for another asset, and let loaded artworks that were
+// wanted for an earlier target be evicted like preloads
+static void load_queue_retarget(size_t asset_index)
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < s_load_queue_len; ++i) {
+        if (s_load_queue[i].asset_index == asset_index || s_load_queue[i].tile >= 0) {
+            s_load_queue[kept++] = s_load_queue[i];
+        }
+    }
+    s_load_queue_len = kept;
+    
+    if (s_loading_asset != SIZE_MAX && s_loading_tile < 0 && s_loading_asset != asset_index) {
+        atomic_store(&s_load_cancel, true);
+        ESP_LOGD(TAG, "Cancelling load of index %zu, navigation moved to %zu", s_loading_asset, asset_index);
+    }
+    for (int i = 0; i < ANIM_SLOT_COUNT; ++i) {
+        if (s_slots[i].anim.asset_index != asset_index) {
+            s_slots[i].priority = LOAD_PRIORITY_PRELOAD;
+        }
+    }
+}
+
+// Free the artworks the render task has replaced on screen (loader task)
+static void release_retired_slots(void)
+{
+    for (int i = 0; i < ANIM_SLOT_COUNT; ++i) {
+        if (slot_state(&s_slots[i]) == SLOT_RETIRING) {
+            unload_animation_buffer(&s_slots[i].anim);
+            s_slots[i].anim.asset_index = SIZE_MAX;
+            atomic_store(&s_slots[i].state, SLOT_EMPTY);
+        }
+    }
+}
+
+// Claim a slot for a load (loader task, holding s_buffer_mutex): an empty one, else the loaded
+// artwork with the lowest priority not above the request's that is not the pending swap target
+static anim_slot_t *claim_slot(load_priority_t priority)
+{
+    for (int i = 0; i < ANIM_SLOT_COUNT; ++i) {
+        if (slot_transition(&s_slots[i], SLOT_EMPTY, SLOT_LOADING)) {
+            return &s_slots[i];
+        }
+    }
+    
+    const size_t target = (player_state_get() & PLAYER_SWAP_REQUESTED) ? swap_params_load().target_index : SIZE_MAX;
+    anim_slot_t *victim = NULL;
+    for (int i = 0; i < ANIM_SLOT_COUNT; ++i) {
+        anim_slot_t *slot = &s_slots[i];
+        if (slot_state(slot) == SLOT_READY && slot->anim.asset_index != target && slot->priority <= priority &&
+            (!victim || slot->priority < victim->priority)) {
+            victim = slot;
+        }
+    }
+    // The render task only takes READY slots that are the swap target, but it may have just done so
+    if (!victim || !slot_transition(victim, SLOT_READY, SLOT_LOADING)) {
+        return NULL;
+    }
+    ESP_LOGD(TAG, "Evicting preloaded index %zu", victim->anim.asset_index);
+    unload_animation_buffer(&victim->anim);
+    return victim;
+}
+
+// Take the next request worth loading and claim a slot for it (a gallery tile brings its own buffer
+// and gets *slot_out NULL). Returns false when there is nothing to load.
+static bool loader_next_request(load_request_t *request, anim_slot_t **slot_out)
+{
+    *slot_out = NULL;
+    if (!buffer_mutex_take()) {
+        return false;
+    }
+    bool found = false;
+    int pos;
+    while (!found && (pos = load_queue_best()) >= 0) {
+        *request = s_load_queue[pos];
+        if (request->tile >= 0) {
+            load_queue_remove(pos);
+            unsigned expected = TILE_QUEUED;
+            found = atomic_compare_exchange_strong(&s_gallery_tiles[request->tile].state, &expected, TILE_LOADING);
+        } else if (request->asset_index >= s_sd_file_list.count || find_loaded_slot(request->asset_index)) {
+            load_queue_remove(pos);
+            continue;
+        } else {
+            // Without a free slot the request waits for the next swap or prefetch to wake the loader
+            anim_slot_t *slot = claim_slot(request->priority);
+            if (!slot) {
+                break;
+            }
+            load_queue_remove(pos);
+            slot->priority = request->priority;
+            *slot_out = slot;
+            found = true;
+        }
+        if (found) {
+            s_loading_asset = request->asset_index;
+            s_loading_tile = request->tile;
+            s_loading_priority = request->priority;
+            atomic_store(&s_load_cancel, false);
+        }
+    }
+    xSemaphoreGive(s_buffer_mutex);
+    return found;
+}
+
+// Preload the artwork after the one on screen so that the next swap can start right away. With two
+// slots there is no room for it next to a pending change.
+static void queue_preload(void)
+{
+    if (ANIM_SLOT_COUNT < 3 || !buffer_mutex_take()) {
+        return;
+    }
+    // No swap pending, so the front slot cannot change under us
+    const animation_buffer_t *front = s_front_buffer;
+    if (!(player_state_get() & PLAYER_SWAP_REQUESTED) && s_gallery_requested_grid < 2 &&
+        front->ready && front->asset_index < s_sd_file_list.count) {
+        const size_t next_index = get_next_asset_index(front->asset_index);
+        if (next_index != front->asset_index && !asset_pending_or_loaded(next_index)) {
+            load_queue_push(next_index, LOAD_PRIORITY_PRELOAD);
+        }
+    }
+    xSemaphoreGive(s_buffer_mutex);
+}
+
+// A load failed: drop the swap request waiting for it and restore system to responsive state
 static void discard_failed_swap_request(size_t failed_asset_index, esp_err_t error)
 {
-    if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-        // Clear swap request flag - this swap attempt failed
-        bool had_swap_request = s_swap_requested;
-        s_swap_requested = false;
-        
-        // Reset loader busy flag - loader is done with this attempt
-        s_loader_busy = false;
-        
-        // Ensure back buffer is in a clean state (unload any partial state)
-        if (s_back_buffer.decoder || s_back_buffer.file_data) {
-            unload_animation_buffer(&s_back_buffer);
+    if (buffer_mutex_take()) {
+        bool had_swap_request = false;
+        if ((player_state_get() & PLAYER_SWAP_REQUESTED) && swap_params_load().target_index == failed_asset_index) {
+            player_state_update(0, PLAYER_SWAP_REQUESTED | PLAYER_SWAP_AT_LOOP_END, 0);
+            had_swap_request = true;
         }
         
-        // Advance to next asset index for future attempts
-        size_t next_index = get_next_asset_index(failed_asset_index);
-        s_next_asset_index = next_index;
-        
         // Check if no healthy files are available
-        if (next_index == failed_asset_index && s_sd_file_list.health_flags) {
-            // Check if there are any healthy files at all
-            bool any_healthy = false;
-            for (size_t i = 0; i < s_sd_file_list.count; i++) {
-                if (s_sd_file_list.health_flags[i]) {
-                    any_healthy = true;
-                    break;
-                }
-            }
-            if (!any_healthy) {
-                ESP_LOGW(TAG, "No healthy animation files available. System remains responsive but will not auto-swap.");
-            }
+        if (asset_health_healthy_count() == 0) {
+            ESP_LOGW(TAG, "No healthy animation files available. System remains responsive but will not auto-swap.");
         }
         
         xSemaphoreGive(s_buffer_mutex);
@@ -625,130 +1347,667 @@ static void discard_failed_swap_request(size_t failed_asset_index, esp_err_t err
     }
 }
 
-// Background loader task - loads animations into back buffer and prefetches first frame
+static void record_load_metrics(esp_err_t err, int64_t load_start_us)
+{
+    if (err == LOAD_CANCELLED) {
+        metrics_add(METRICS_LOADS_CANCELLED, 1);
+    } else {
+        metrics_observe_us(METRICS_LOAD_TIME, esp_timer_get_time() - load_start_us);
+        metrics_add(err == ESP_OK ? METRICS_LOADS : METRICS_LOAD_FAILURES, 1);
+    }
+}
+
+// The loader let go of the request it was working on
+static void loader_request_done(void)
+{
+    if (buffer_mutex_take()) {
+        s_loading_asset = SIZE_MAX;
+        s_loading_tile = -1;
+        xSemaphoreGive(s_buffer_mutex);
+    }
+}
+
+// Load a gallery tile the render task queued; the page draws it from the next tick on
+static void load_into_tile(const load_request_t *request)
+{
+    gallery_tile_t *tile = &s_gallery_tiles[request->tile];
+    ESP_LOGD(TAG, "Loader task: Loading index %zu into gallery tile %d", request->asset_index, request->tile);
+    
+    const int64_t load_start_us = esp_timer_get_time();
+    esp_err_t err = load_animation_into_buffer(request->asset_index, &tile->anim, &s_load_cancel);
+    record_load_metrics(err, load_start_us);
+    if (err == ESP_OK) {
+        tile->next_due_us = esp_timer_get_time();
+        tile->stale_mask = 0xFF;
+        atomic_store(&tile->state, TILE_READY);
+    } else {
+        unload_animation_buffer(&tile->anim);
+        atomic_store(&tile->state, (err == LOAD_CANCELLED) ? TILE_EMPTY : TILE_FAILED);
+        if (err != LOAD_CANCELLED) {
+            ESP_LOGW(TAG, "Gallery tile %d: failed to load index %zu: %s", request->tile, request->asset_index,
+                     esp_err_to_name(err));
+        }
+    }
+    loader_request_done();
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+    if (err == ESP_OK) {
+        thumb_cache_check(s_sd_file_list.filenames[request->asset_index], (uint32_t)tile->anim.file_size);
+    }
+#endif
+}
+
+// Load one request into its claimed slot and hand the slot to the render task for the prefetch
+static void load_into_slot(anim_slot_t *slot, const load_request_t *request)
+{
+    ESP_LOGD(TAG, "Loader task: Loading animation index %zu (priority %d)", request->asset_index, (int)request->priority);
+    
+    const int64_t load_start_us = esp_timer_get_time();
+    esp_err_t err = load_animation_into_buffer(request->asset_index, &slot->anim, &s_load_cancel);
+    const bool cancelled = (err == LOAD_CANCELLED);
+    record_load_metrics(err, load_start_us);
+    
+    if (err != ESP_OK) {
+        unload_animation_buffer(&slot->anim);
+        slot->anim.asset_index = SIZE_MAX;
+        atomic_store(&slot->state, SLOT_EMPTY);
+    } else {
+        // The prefetch is done by the render task to avoid racing the upscale workers
+        slot->anim.ready = false;  // Not ready until prefetch completes
+        atomic_store(&slot->state, SLOT_DECODED);
+    }
+    loader_request_done();
+    
+    if (cancelled) {
+        ESP_LOGD(TAG, "Loader task: Load of index %zu cancelled", request->asset_index);
+    } else if (err != ESP_OK) {
+        // Discard the failed swap request and restore system to responsive state
+        discard_failed_swap_request(request->asset_index, err);
+    } else {
+        ESP_LOGD(TAG, "Loader task: Successfully loaded animation index %zu (prefetch pending)", request->asset_index);
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+        // The file list only changes on this task, so the name is safe to use without the mutex
+        thumb_cache_check(s_sd_file_list.filenames[request->asset_index], (uint32_t)slot->anim.file_size);
+#endif
+    }
+}
+
+// Background loader task - serves the load queue and recycles retired slots
 static void animation_loader_task(void *arg)
 {
     (void)arg;
     
+#if CONFIG_P3A_FAST_BOOT_LAST_ASSET
+    // Playback started from the cached artwork; build the file list now that the first frame is up
+    if (s_enumeration_pending) {
+        finish_deferred_enumeration();
+    }
+#endif
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+    // Opened here rather than in init so that start-up does not wait for the SD card
+    if (thumb_cache_open(THUMB_CACHE_PATH, EXAMPLE_LCD_BIT_PER_PIXEL / 8) == ESP_OK) {
+        s_thumb_cursor = 0;
+    }
+#endif
+    
     while (true) {
-        // Wait for signal to load next animation
-        if (xSemaphoreTake(s_loader_sem, portMAX_DELAY) != pdTRUE) {
+        TickType_t idle_ticks = LOADER_IDLE_TICKS;
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+        if (s_thumb_cursor != SIZE_MAX && THUMB_IDLE_TICKS < idle_ticks) {
+            idle_ticks = THUMB_IDLE_TICKS;
+        }
+#endif
+        // Wait for a request, a swap or a finished prefetch
+        if (xSemaphoreTake(s_loader_sem, idle_ticks) != pdTRUE) {
+#if CONFIG_P3A_FAST_BOOT_LAST_ASSET
+            // Nothing to load for a while: the artwork on screen has settled, remember it for the next boot
+            save_last_asset_path();
+#endif
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+            if (s_thumb_cursor != SIZE_MAX) {
+                power_mgmt_busy_begin();
+                thumb_job_step();
+                power_mgmt_busy_end();
+            }
+#endif
             continue;
         }
         
-        size_t asset_index_to_load;
-        bool swap_was_requested = false;
+        release_retired_slots();
+        queue_preload();
         
-        // Get the asset index to load
-        if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-            asset_index_to_load = s_next_asset_index;
-            swap_was_requested = s_swap_requested;
-            s_loader_busy = true;  // Mark loader as busy
-            xSemaphoreGive(s_buffer_mutex);
-        } else {
-            continue;
+        load_request_t request;
+        anim_slot_t *slot;
+        while (loader_next_request(&request, &slot)) {
+            power_mgmt_busy_begin();
+            if (slot) {
+                load_into_slot(slot, &request);
+            } else {
+                load_into_tile(&request);
+            }
+            power_mgmt_busy_end();
         }
+    }
+}
+
+// Snapshot the frame currently on screen so the next frames can blend away from it
+static void start_swap_transition(void)
+{
+    if (P3A_TRANSITION_TYPE == FRAME_TRANSITION_NONE || !s_transition_from_frame || !s_lcd_buffers) {
+        return;
+    }
+    if (!s_front_buffer->ready || s_last_display_buffer >= s_buffer_count) {
+        return;
+    }
+    const uint8_t *on_screen = s_lcd_buffers[s_last_display_buffer];
+    if (!on_screen) {
+        return;
+    }
+    
+    memcpy(s_transition_from_frame, on_screen, s_frame_buffer_bytes);
+    frame_transition_begin(&s_transition, P3A_TRANSITION_TYPE, s_transition_from_frame,
+                           (uint16_t)CONFIG_P3A_TRANSITION_FRAMES,
+                           EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES,
+                           s_frame_row_stride_bytes, EXAMPLE_LCD_BIT_PER_PIXEL / 8);
+}
+
+// Lay out the gallery tiles after a grid change or page turn and queue their loads on the loader
+// task. Runs on the render task, so the tiles are never touched by the workers while they are
+// replaced. The request is only picked up when the mutex is free and no tile is mid-load (the
+// load is cancelled); otherwise PLAYER_GALLERY_RELOAD stays set and the next tick retries.
+static void gallery_apply_request(void)
+{
+    if (xSemaphoreTake(s_buffer_mutex, 0) != pdTRUE) {
+        return;
+    }
+    load_queue_drop_tiles();
+    if (s_loading_tile >= 0) {
+        xSemaphoreGive(s_buffer_mutex);
+        return;
+    }
+    int grid = s_gallery_requested_grid;
+    size_t first = (s_gallery_grid > 0) ? s_gallery_first_index : s_front_buffer->asset_index;
+    if (first >= s_sd_file_list.count) {
+        first = 0;    // The start-up artwork is not in the list
+    }
+    player_state_update(0, PLAYER_GALLERY_RELOAD, 0);
+    
+    // No tile is queued or loading any more, so the old page can go while the mutex is held
+    for (int i = 0; i < s_gallery_tile_count; ++i) {
+        unload_animation_buffer(&s_gallery_tiles[i].anim);
+    }
+    memset(s_gallery_tiles, 0, sizeof(s_gallery_tiles));
+    s_gallery_tile_count = 0;
+    s_gallery_grid = 0;
+    
+    if (grid >= 2 && s_sd_file_list.count == 0) {
+        grid = 0;
+    }
+    if (grid >= 2) {
+        const int view_w = DISPLAY_ORIENTATION_TRANSPOSED ? EXAMPLE_LCD_V_RES : EXAMPLE_LCD_H_RES;
+        const int view_h = DISPLAY_ORIENTATION_TRANSPOSED ? EXAMPLE_LCD_H_RES : EXAMPLE_LCD_V_RES;
+        const int gutter = CONFIG_P3A_GALLERY_GUTTER;
+        const int cell_w = (view_w - gutter * (grid + 1)) / grid;
+        const int cell_h = (view_h - gutter * (grid + 1)) / grid;
         
-        ESP_LOGD(TAG, "Loader task: Loading animation index %zu into back buffer", asset_index_to_load);
-        
-        // Load animation into back buffer
-        esp_err_t err = load_animation_into_buffer(asset_index_to_load, &s_back_buffer);
-        if (err != ESP_OK) {
-            // Discard the failed swap request and restore system to responsive state
-            discard_failed_swap_request(asset_index_to_load, err);
+        // Tiles are drawn as the loader fills them, in page order; the page keeps animating meanwhile
+        size_t index = first;
+        for (int cell = 0; cell < grid * grid; ++cell) {
+            gallery_tile_t *tile = &s_gallery_tiles[cell];
+            tile->anim.gallery_tile = true;
+            tile->anim.viewport_x = gutter + (cell % grid) * (cell_w + gutter);
+            tile->anim.viewport_y = gutter + (cell / grid) * (cell_h + gutter);
+            tile->anim.viewport_w = cell_w;
+            tile->anim.viewport_h = cell_h;
+            atomic_store(&tile->state, TILE_QUEUED);
+            load_queue_push_tile(index, cell);
+            index = get_next_asset_index(index);
+        }
+        s_gallery_tile_count = grid * grid;
+        s_gallery_grid = grid;
+        // Settled here, so a page turn requested from now on starts after this page
+        s_gallery_first_index = first;
+        s_gallery_next_index = index;
+    }
+    xSemaphoreGive(s_buffer_mutex);
+    
+    frame_transition_cancel(&s_transition);
+    s_border_generation++;
+    if (grid < 2) {
+        ESP_LOGI(TAG, "Gallery off, single artwork playback");
+        return;
+    }
+    xSemaphoreGive(s_loader_sem);
+    atomic_store(&s_front_shown_since_us, esp_timer_get_time());
+    ESP_LOGI(TAG, "Gallery %dx%d queued %d artworks from index %zu", grid, grid, s_gallery_tile_count, first);
+}
+
+// Advance the tiles that are due and redraw every tile the LCD buffer has not shown yet.
+// Returns false, leaving the buffer untouched, when it already shows the latest frame of every tile.
+static bool render_gallery_frame(uint8_t *frame, uint8_t buffer_index, uint8_t buffer_count, bool repaint,
+                                 int64_t now_us, int *row_start, int *row_end)
+{
+    const uint8_t buffer_bit = (uint8_t)(1U << buffer_index);
+    uint8_t order[GALLERY_MAX_TILES];
+    int count = 0;
+    uint16_t decode_mask = 0;
+    int failed = 0;
+    
+    for (int i = 0; i < s_gallery_tile_count; ++i) {
+        gallery_tile_t *tile = &s_gallery_tiles[i];
+        const unsigned state = atomic_load(&tile->state);
+        if (state != TILE_READY) {
+            failed += (state == TILE_FAILED);
             continue;
         }
-        
-        // Mark buffer as needing prefetch (will be done by render task to avoid race condition)
-        if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-            s_back_buffer.prefetch_pending = true;
-            s_back_buffer.ready = false;  // Not ready until prefetch completes
-            // If swap was requested, keep the flag set so render loop performs swap after prefetch
-            if (swap_was_requested) {
-                s_swap_requested = true;
-                ESP_LOGD(TAG, "Loader task: Swap was requested, will swap after prefetch");
+        tile->decoded = false;
+        const bool due = !tile->failed && tile->next_due_us <= now_us;
+        if (due) {
+            decode_mask |= (uint16_t)(1U << i);
+        }
+        if (repaint || due || (tile->stale_mask & buffer_bit)) {
+            order[count++] = (uint8_t)i;
+        }
+    }
+    if (failed > 0 && failed == s_gallery_tile_count && !(player_state_get() & PLAYER_GALLERY_RELOAD) &&
+        xSemaphoreTake(s_buffer_mutex, 0) == pdTRUE) {
+        ESP_LOGE(TAG, "Gallery could not load any artwork, back to single artwork playback");
+        s_gallery_requested_grid = 0;
+        player_state_update(0, 0, PLAYER_GALLERY_RELOAD);
+        xSemaphoreGive(s_buffer_mutex);
+    }
+    if (count == 0 && !repaint) {
+        return false;
+    }
+    
+    // Earliest deadline first, each tile to the worker with less estimated work queued
+    for (int i = 1; i < count; ++i) {
+        const uint8_t key = order[i];
+        int j = i - 1;
+        while (j >= 0 && s_gallery_tiles[order[j]].next_due_us > s_gallery_tiles[key].next_due_us) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = key;
+    }
+    uint32_t load[2] = {0, 0};
+    s_gallery_work_count[0] = 0;
+    s_gallery_work_count[1] = 0;
+    for (int i = 0; i < count; ++i) {
+        const int worker = (load[0] <= load[1]) ? 0 : 1;
+        s_gallery_work[worker][s_gallery_work_count[worker]++] = order[i];
+        load[worker] += s_gallery_tiles[order[i]].cost_us + 1U;
+    }
+    
+    if (repaint) {
+        const app_lcd_color_t color = app_lcd_make_color((CONFIG_P3A_LETTERBOX_COLOR >> 16) & 0xFF,
+                                                         (CONFIG_P3A_LETTERBOX_COLOR >> 8) & 0xFF,
+                                                         CONFIG_P3A_LETTERBOX_COLOR & 0xFF);
+        for (int y = 0; y < EXAMPLE_LCD_V_RES; ++y) {
+            fill_row_span(frame + (size_t)y * s_frame_row_stride_bytes, 0, EXAMPLE_LCD_H_RES, color);
+        }
+    }
+    
+    s_upscale_color = color_pipeline_begin_frame();
+    s_frame_background = frame_background_begin_frame();
+    s_upscale_dst_buffer = frame;
+    s_gallery_decode_mask = decode_mask;
+    s_upscale_job = UPSCALE_JOB_GALLERY;
+    if (!run_upscale_workers(0)) {
+        ESP_LOGW(TAG, "Upscale workers may not have completed gallery tiles");
+    }
+    s_upscale_job = UPSCALE_JOB_BLIT;
+    
+    const uint8_t all_buffers = (uint8_t)((1U << buffer_count) - 1U);
+    int y0 = EXAMPLE_LCD_V_RES, y1 = 0;
+    for (int i = 0; i < count; ++i) {
+        gallery_tile_t *tile = &s_gallery_tiles[order[i]];
+        if (tile->decoded) {
+            // Stay on the tile's own timeline; after a stall restart it rather than catch up
+            const int64_t delay_us = (int64_t)tile->anim.current_frame_delay_ms * 1000;
+            tile->next_due_us += delay_us;
+            if (tile->next_due_us <= now_us) {
+                tile->next_due_us = now_us + delay_us;
             }
-            s_loader_busy = false;  // Mark loader as not busy (prefetch will be handled by render task)
-            xSemaphoreGive(s_buffer_mutex);
+            tile->stale_mask = all_buffers;
         }
-        
-        ESP_LOGD(TAG, "Loader task: Successfully loaded animation index %zu (prefetch_pending=true)", asset_index_to_load);
+        tile->stale_mask &= (uint8_t)~buffer_bit;
+        if (tile->anim.upscale_dst_y < y0) {
+            y0 = tile->anim.upscale_dst_y;
+        }
+        if (tile->anim.upscale_dst_y + tile->anim.upscale_dst_h > y1) {
+            y1 = tile->anim.upscale_dst_y + tile->anim.upscale_dst_h;
+        }
+    }
+    *row_start = repaint ? 0 : y0;
+    *row_end = repaint ? EXAMPLE_LCD_V_RES : y1;
+    return true;
+}
+
+// Navigation feedback: the loading spinner while the swap target loads, and the edge the user
+// navigated towards, lit until the new artwork's first frame replaces it
+static void update_nav_feedback(bool swap_requested, const swap_params_t *params, bool target_ready)
+{
+    osd_set_icon(OSD_ICON_LOADING, swap_requested && !target_ready);
+    const bool user_waiting = swap_requested && params->requested_us != 0 && !target_ready;
+    osd_set_edge(!user_waiting ? OSD_EDGE_NONE : (params->steps > 0) ? OSD_EDGE_RIGHT : OSD_EDGE_LEFT);
+}
+
+// Latch the OSD layer for the next frame; pixels outside the content rectangle are only replaced
+// when the border is repainted
+static const osd_layer_t *begin_osd_frame(bool *changed)
+{
+    const osd_layer_t *osd = osd_begin_frame(esp_timer_get_time(), changed);
+    const bool osd_in_border = osd && !osd_layer_inside_content(osd, s_front_buffer);
+    if (*changed && (osd_in_border || s_osd_in_border || s_gallery_grid > 0)) {
+        s_border_generation++;
+    }
+    s_osd_in_border = osd_in_border;
+    return osd;
+}
+
+// Navigation during the pacing wait: overlay the new OSD on the frame on screen and present it
+// again right away, as the paused path does, and on the rendered frame still waiting for its time
+static void present_osd_update(uint8_t *held_frame, uint8_t *pending_frame)
+{
+    const unsigned state = player_state_get();
+    const bool swap_requested = (state & PLAYER_SWAP_REQUESTED) != 0;
+    const swap_params_t params = swap_requested ? swap_params_load() : (swap_params_t){0};
+    anim_slot_t *target = swap_requested ? find_loaded_slot(params.target_index) : NULL;
+    update_nav_feedback(swap_requested, &params, target && slot_state(target) == SLOT_READY);
+
+    bool changed = false;
+    const osd_layer_t *osd = begin_osd_frame(&changed);
+    if (!osd || !changed) {
+        return;
+    }
+    power_mgmt_busy_begin();
+    uint8_t *frames[2] = { pending_frame, (held_frame != pending_frame) ? held_frame : NULL };
+    for (int i = 0; i < 2; ++i) {
+        if (!frames[i]) {
+            continue;
+        }
+        osd_compose_rows(osd, frames[i], s_frame_row_stride_bytes, 0, EXAMPLE_LCD_V_RES);
+#if APP_LCD_HAVE_CACHE_MSYNC && defined(CONFIG_P3A_LCD_ENABLE_CACHE_FLUSH)
+        esp_cache_msync(frames[i], s_frame_buffer_bytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+#endif
+    }
+    // With a single buffer the rendered frame already overwrote the one on screen
+    if (frames[1] && app_lcd_get_brightness() != 0) {
+        esp_lcd_panel_draw_bitmap(s_display_handle, 0, 0, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, held_frame);
+    }
+    power_mgmt_busy_end();
+}
+
+// Wait until due_us (esp_timer clock) before presenting pending_frame. A navigation request ends
+// the sleep early to show its feedback on held_frame, the frame on screen, then the wait resumes.
+static void pacing_wait_until(int64_t due_us, uint8_t *held_frame, uint8_t *pending_frame)
+{
+    PERF_TRACE_BEGIN(PERF_TRACE_PACING_WAIT);
+    while (true) {
+        const int64_t wait_us = due_us - esp_timer_get_time();
+        const TickType_t ticks = (wait_us > 0) ? pdMS_TO_TICKS((wait_us + 500) / 1000) : 0;
+        if (ticks == 0 || xSemaphoreTake(s_render_wake_sem, ticks) != pdTRUE) {
+            break;
+        }
+        present_osd_update(held_frame, pending_frame);
     }
+    PERF_TRACE_END(PERF_TRACE_PACING_WAIT);
+}
+
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+// Put the frame about to be rendered on the shared timeline. Returns false while the shared clock
+// is not locked, in which case local pacing applies. A new timeline always starts from the first
+// frame on the next slot boundary, so players that got the same animation within a slot agree.
+static bool sync_wall_schedule_frame(animation_buffer_t *buf, bool first_frame)
+{
+    if (!sync_wall_is_locked()) {
+        s_sync_anchored = false;
+        return false;
+    }
+    if (!s_sync_anchored) {
+        if (!first_frame) {
+            animation_decoder_reset(buf->decoder);
+            buf->next_frame_index = 0;
+        }
+        const int64_t now_shared_us = sync_wall_local_to_shared(esp_timer_get_time());
+        s_sync_due_shared_us = (now_shared_us / SYNC_WALL_SLOT_US + 1) * SYNC_WALL_SLOT_US;
+        s_sync_anchored = true;
+    }
+    return true;
+}
+
+// Sleep until the rendered frame's deadline. Late frames go out at once so playback catches up.
+static int64_t sync_wall_wait_due(uint8_t *held_frame, uint8_t *pending_frame)
+{
+    const int64_t due_us = sync_wall_shared_to_local(s_sync_due_shared_us);
+    pacing_wait_until(due_us, held_frame, pending_frame);
+    return due_us;
+}
+
+// Record how far the frame missed its deadline and advance the timeline by its delay
+static void sync_wall_frame_presented(int64_t due_us, int frame_delay_ms)
+{
+    const int64_t error_us = esp_timer_get_time() - due_us;
+    sync_wall_note_frame(error_us);
+    if (error_us > SYNC_WALL_RESYNC_US) {
+        ESP_LOGW(TAG, "Sync wall: %lld ms behind, restarting timeline", (long long)(error_us / 1000));
+        sync_wall_note_resync();
+        s_sync_anchored = false;
+        return;
+    }
+    s_sync_due_shared_us += (int64_t)frame_delay_ms * 1000;
+}
+
+#if CONFIG_P3A_SYNC_WALL_LEADER
+static _Atomic uint32_t s_sync_announced_id = 0;  // Artwork followers were last told to show
+
+// Beacon the artwork at index with its swap window (esp_timer clock) so that followers show it
+// too. Their play orders are shuffled independently, so it is identified by file name.
+static void sync_wall_announce_index(size_t index, int64_t not_before_us, int64_t deadline_us)
+{
+    if (index >= s_sd_file_list.count) {
+        return;
+    }
+    const sync_wall_asset_t asset = {
+        .asset_id = sync_clock_asset_id(s_sd_file_list.filenames[index]),
+        .not_before_us = sync_wall_local_to_shared(not_before_us),
+        .deadline_us = sync_wall_local_to_shared(deadline_us),
+    };
+    atomic_store(&s_sync_announced_id, asset.asset_id);
+    sync_wall_announce_asset(&asset);
+}
+#endif
+#endif
+
+// Scrub frames are shown at most this far apart, whatever the artwork's own frame delays
+#define SCRUB_FRAME_MS   16
+// Frames decoded and dropped per tick on the way to the scrub target; longer jumps take several ticks
+#define SCRUB_MAX_SKIP   8
+
+// Position the decoder of the artwork on screen for the frame the scrub points at (render task).
+// One panel width of drag runs through one loop, starting from the frame shown when scrubbing began.
+// The decoder only runs forward, so going back restarts the loop. Returns false when the frame on
+// screen already is the target.
+static bool scrub_seek(animation_buffer_t *buf, size_t *origin, bool begin)
+{
+    const size_t count = buf->decoder_info.frame_count;
+    if (!buf->decoder || count < 2) {
+        return false;
+    }
+    const size_t shown = (buf->next_frame_index + count - 1) % count;
+    if (begin) {
+        *origin = shown;
+    }
+    const int64_t offset = (int64_t)atomic_load(&s_scrub_permille) * (int64_t)count / 1000;
+    int64_t target = ((int64_t)*origin + offset) % (int64_t)count;
+    if (target < 0) {
+        target += (int64_t)count;
+    }
+    if ((size_t)target == shown) {
+        return false;
+    }
+    
+    if ((size_t)target < buf->next_frame_index) {
+        animation_decoder_reset(buf->decoder);
+        buf->next_frame_index = 0;
+    }
+    // Skipped frames go to the buffer the next frame is decoded into anyway
+    uint8_t *scratch = (buf->native_buffer_active == 0) ? buf->native_frame_b1 : buf->native_frame_b2;
+    for (int skipped = 0; buf->next_frame_index < (size_t)target && skipped < SCRUB_MAX_SKIP; ++skipped) {
+        if (animation_decoder_decode_next(buf->decoder, scratch) != ESP_OK) {
+            break;
+        }
+        buf->next_frame_index++;
+    }
+    buf->first_frame_ready = false;
+    return true;
+}
+
+// True once a scheduled swap may happen: the dwell is over and the front animation shows the last
+// frame of its loop, or the deadline has passed
+static bool scheduled_swap_due(int64_t now_us, int64_t not_before_us, int64_t deadline_us)
+{
+    if (now_us >= deadline_us) {
+        return true;
+    }
+    if (now_us < not_before_us) {
+        return false;
+    }
+    const size_t frame_count = s_front_buffer->decoder_info.frame_count;
+    return !s_front_buffer->ready || frame_count == 0 || s_front_buffer->next_frame_index >= frame_count;
 }
 
 static void lcd_animation_task(void *arg)
 {
     (void)arg;
-    const app_lcd_color_t color_red = app_lcd_make_color(0xFF, 0x20, 0x20);
-    const app_lcd_color_t color_white = app_lcd_make_color(0xFF, 0xFF, 0xFF);
-
     const bool use_vsync = (s_buffer_count > 1) && (s_vsync_sem != NULL);
     const uint8_t buffer_count = (s_buffer_count == 0) ? 1 : s_buffer_count;
     bool use_prefetched = false;  // Track if we should use prefetched frame after swap
+    bool was_scrubbing = false;
+    size_t scrub_origin = 0;      // Frame on screen when scrubbing started
 
     while (true) {
         if (use_vsync) {
+            PERF_TRACE_BEGIN(PERF_TRACE_VSYNC_WAIT);
             xSemaphoreTake(s_vsync_sem, portMAX_DELAY);
+            PERF_TRACE_END(PERF_TRACE_VSYNC_WAIT);
         }
+        // Full speed from here until the frame is handed to the panel, minus the pacing wait
+        power_mgmt_busy_begin();
 
-        bool paused_local = false;
-        bool swap_requested = false;
-        bool back_buffer_ready = false;
-        bool back_buffer_prefetch_pending = false;
-        
-        // Check for swap request and buffer state (must hold mutex for atomic check)
-        if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-            paused_local = s_anim_paused;
-            swap_requested = s_swap_requested;
-            back_buffer_ready = s_back_buffer.ready;
-            back_buffer_prefetch_pending = s_back_buffer.prefetch_pending;
-            xSemaphoreGive(s_buffer_mutex);
+        // One load of the state word covers pause, swap and gallery requests; nothing here waits on the mutex
+        unsigned state = player_state_get();
+        const bool paused_local = (state & PLAYER_PAUSED) != 0;
+        const bool scrubbing = (state & PLAYER_SCRUBBING) != 0;
+
+        if (state & PLAYER_GALLERY_RELOAD) {
+            gallery_apply_request();
         }
 
-        // Handle prefetch if pending (must be done in render task to avoid race with upscale workers)
-        if (back_buffer_prefetch_pending) {
-            esp_err_t prefetch_err = prefetch_first_frame(&s_back_buffer);
-            if (prefetch_err == ESP_OK) {
-                // Prefetch successful, mark buffer as ready
-                if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-                    s_back_buffer.prefetch_pending = false;
-                    s_back_buffer.ready = true;
-                    // If swap was requested, it's now ready to swap
-                    if (s_swap_requested) {
-                        ESP_LOGD(TAG, "Render task: Prefetch complete, swap ready");
-                    }
-                    xSemaphoreGive(s_buffer_mutex);
-                }
-            } else {
+        const bool swap_requested = (state & PLAYER_SWAP_REQUESTED) != 0;
+        const swap_params_t swap_params = swap_requested ? swap_params_load() : (swap_params_t){0};
+
+        // Prefetch one newly loaded artwork per tick, the swap target first (must be done in render task
+        // to avoid race with upscale workers). The loader is woken as eviction may now free a slot.
+        anim_slot_t *prefetch_slot = NULL;
+        for (int i = 0; i < ANIM_SLOT_COUNT; ++i) {
+            if (slot_state(&s_slots[i]) == SLOT_DECODED &&
+                (!prefetch_slot || (swap_requested && s_slots[i].anim.asset_index == swap_params.target_index))) {
+                prefetch_slot = &s_slots[i];
+            }
+        }
+        if (prefetch_slot) {
+            PERF_TRACE_BEGIN(PERF_TRACE_PREFETCH);
+            esp_err_t prefetch_err = prefetch_first_frame(&prefetch_slot->anim);
+            PERF_TRACE_END(PERF_TRACE_PREFETCH);
+            if (prefetch_err != ESP_OK) {
+                // Mark prefetch as done even on failure, so we don't retry forever (swap still allowed)
                 ESP_LOGW(TAG, "Render task: Prefetch failed: %s", esp_err_to_name(prefetch_err));
-                // Mark prefetch as done even on failure, so we don't retry forever
-                if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-                    s_back_buffer.prefetch_pending = false;
-                    s_back_buffer.ready = true;  // Allow swap even if prefetch failed
-                    xSemaphoreGive(s_buffer_mutex);
-                }
             }
-            // Re-read state after prefetch
-            if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-                swap_requested = s_swap_requested;
-                back_buffer_ready = s_back_buffer.ready;
-                xSemaphoreGive(s_buffer_mutex);
-                ESP_LOGD(TAG, "Render task: Prefetch completed, buffer ready");
+            prefetch_slot->anim.ready = true;
+            atomic_store(&prefetch_slot->state, SLOT_READY);
+            xSemaphoreGive(s_loader_sem);
+            ESP_LOGD(TAG, "Render task: Prefetched index %zu", prefetch_slot->anim.asset_index);
+        }
+
+        anim_slot_t *swap_slot = NULL;
+        for (int i = 0; swap_requested && i < ANIM_SLOT_COUNT; ++i) {
+            if (slot_state(&s_slots[i]) == SLOT_READY && s_slots[i].anim.asset_index == swap_params.target_index) {
+                swap_slot = &s_slots[i];
             }
         }
+        // Tap feedback lights up on this frame already
+        update_nav_feedback(swap_requested, &swap_params, swap_slot != NULL);
+#if defined(CONFIG_P3A_LCD_DISPLAY_FRAME_DURATIONS)
+        osd_set_text(OSD_TEXT_FRAME_TIME, s_frame_duration_text, swap_requested ? 0xFF2020 : 0xFFFFFF);
+#endif
 
-        // Perform buffer swap if requested and back buffer is ready
-        if (swap_requested && back_buffer_ready) {
-            swap_buffers();
+        // Perform buffer swap if requested and the target is ready (held back while the gallery is shown
+        // or the user scrubs). A scheduled swap also waits for the loop boundary, so the new first frame
+        // replaces the last one.
+        if (swap_slot && s_gallery_grid == 0 && !scrubbing &&
+            (!(state & PLAYER_SWAP_AT_LOOP_END) ||
+             scheduled_swap_due(esp_timer_get_time(), swap_params.not_before_us, swap_params.deadline_us)) &&
+            swap_buffers(swap_slot, swap_params.requested_us)) {
             use_prefetched = true;  // Use prefetched frame on first render after swap
-            // Note: Next animation will be loaded on-demand when next swap gesture occurs
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+            s_sync_anchored = false;
+#endif
+        }
+
+        // While scrubbing a frame is only rendered when the position has moved to another one; playback
+        // (or the pause) carries on from there afterwards
+        bool scrub_frame = false;
+        if (scrubbing && s_gallery_grid == 0 && s_front_buffer->ready) {
+            scrub_frame = scrub_seek(s_front_buffer, &scrub_origin, !was_scrubbing);
+            if (scrub_frame) {
+                use_prefetched = false;
+            }
         }
+        was_scrubbing = scrubbing;
+        const bool playing = (!paused_local && !scrubbing) || scrub_frame;
 
         uint8_t *frame = NULL;
         int frame_delay_ms = 1;
         uint32_t prev_frame_delay_ms = s_target_frame_delay_ms;  // Track delay of frame currently on screen
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+        bool sync_frame = false;  // Frame is presented at its shared-clock deadline
+#endif
+
+        bool osd_changed = false;
+        const osd_layer_t *osd = begin_osd_frame(&osd_changed);
+        // Frame on screen until this tick's one is presented
+        uint8_t *held_frame = (s_last_display_buffer < buffer_count) ? s_lcd_buffers[s_last_display_buffer] : NULL;
 
-        if (!paused_local && s_front_buffer.ready) {
+        if (!paused_local && s_gallery_grid > 0) {
+            // Gallery ticks only produce a frame when some tile has something new to show
+            s_frame_processing_start_us = esp_timer_get_time();
+            uint8_t *target = s_lcd_buffers[s_render_buffer_index];
+            const bool repaint = s_lcd_border_generation[s_render_buffer_index] != s_border_generation;
+            int row_start = 0, row_end = 0;
+            if (target && render_gallery_frame(target, s_render_buffer_index, buffer_count, repaint,
+                                               s_frame_processing_start_us, &row_start, &row_end)) {
+                if (osd) {
+                    osd_compose_rows(osd, target, s_frame_row_stride_bytes, 0, EXAMPLE_LCD_V_RES);
+                    row_start = (osd->y0 < row_start) ? osd->y0 : row_start;
+                    row_end = (osd->y1 > row_end) ? osd->y1 : row_end;
+                }
+                s_lcd_border_generation[s_render_buffer_index] = s_border_generation;
+#if APP_LCD_HAVE_CACHE_MSYNC && defined(CONFIG_P3A_LCD_ENABLE_CACHE_FLUSH)
+                PERF_TRACE_BEGIN(PERF_TRACE_CACHE_FLUSH);
+                esp_err_t msync_err = esp_cache_msync(target + (size_t)row_start * s_frame_row_stride_bytes,
+                                                      (size_t)(row_end - row_start) * s_frame_row_stride_bytes,
+                                                      ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+                PERF_TRACE_END(PERF_TRACE_CACHE_FLUSH);
+                if (msync_err != ESP_OK) {
+                    ESP_LOGW(TAG, "Cache sync failed: %s", esp_err_to_name(msync_err));
+                }
+#endif
+                frame = target;
+                s_last_display_buffer = s_render_buffer_index;
+                s_render_buffer_index = (s_render_buffer_index + 1) % buffer_count;
+            }
+        } else if (playing && s_front_buffer->ready) {
             // Record when frame processing starts
             s_frame_processing_start_us = esp_timer_get_time();
             
@@ -757,27 +2016,54 @@ static void lcd_animation_task(void *arg)
                 // Save previous frame delay before decoding next frame
                 prev_frame_delay_ms = s_target_frame_delay_ms;
                 
-                frame_delay_ms = render_next_frame(&s_front_buffer, frame, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, use_prefetched);
+                // The border only changes on swaps, so each LCD buffer is painted once per animation.
+                // A transition blends the whole panel, which leaves the border stale afterwards.
+                const bool transition_frame = frame_transition_active(&s_transition);
+                const bool prefetched_frame = use_prefetched && s_front_buffer->first_frame_ready;
+                if (use_prefetched) {
+                    metrics_add(prefetched_frame ? METRICS_PREFETCH_HITS : METRICS_PREFETCH_MISSES, 1);
+                }
+                bool border_dirty = false;
+                if (prefetched_frame) {
+                    border_dirty = true;  // Whole prefetched frame is copied, border included
+                } else if (transition_frame ||
+                           s_lcd_border_generation[s_render_buffer_index] != s_border_generation) {
+                    fill_letterbox_border(frame, s_front_buffer);
+                    border_dirty = true;
+                }
+                
+                s_upscale_osd = osd;
+                s_upscale_osd_all_rows = border_dirty;
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+                sync_frame = !scrub_frame && sync_wall_schedule_frame(s_front_buffer, prefetched_frame);
+#endif
+                PERF_TRACE_BEGIN(PERF_TRACE_RENDER_FRAME);
+                frame_delay_ms = render_next_frame(s_front_buffer, frame, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, use_prefetched);
+                PERF_TRACE_END(PERF_TRACE_RENDER_FRAME);
                 use_prefetched = false;  // Only use prefetched frame once
+                frame_transition_advance(&s_transition);
+                s_lcd_border_generation[s_render_buffer_index] = transition_frame ? 0 : s_border_generation;
                 if (frame_delay_ms < 0) {
                     frame_delay_ms = 1;
                 }
+                if (scrub_frame && frame_delay_ms > SCRUB_FRAME_MS) {
+                    frame_delay_ms = SCRUB_FRAME_MS;
+                }
                 s_target_frame_delay_ms = (uint32_t)frame_delay_ms;
                 s_latest_frame_duration_ms = frame_delay_ms;
-#if defined(CONFIG_P3A_LCD_DISPLAY_FRAME_DURATIONS)
-                const int text_scale = 3;
-                const int margin = text_scale * 2;
-
-                app_lcd_color_t color_text = color_white;
-                if (swap_requested) {
-                    color_text = color_red;
-                }
-
-                draw_text_top_right(frame, s_frame_duration_text, margin, margin, text_scale, color_text);
-#endif
 
 #if APP_LCD_HAVE_CACHE_MSYNC && defined(CONFIG_P3A_LCD_ENABLE_CACHE_FLUSH)
-                esp_err_t msync_err = esp_cache_msync(frame, s_frame_buffer_bytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M);
+                // Flush only the content rows unless the border was touched this frame
+                uint8_t *flush_start = frame;
+                size_t flush_bytes = s_frame_buffer_bytes;
+                if (!border_dirty && s_front_buffer->upscale_dst_h > 0) {
+                    flush_start = frame + (size_t)s_front_buffer->upscale_dst_y * s_frame_row_stride_bytes;
+                    flush_bytes = (size_t)s_front_buffer->upscale_dst_h * s_frame_row_stride_bytes;
+                }
+                PERF_TRACE_BEGIN(PERF_TRACE_CACHE_FLUSH);
+                esp_err_t msync_err = esp_cache_msync(flush_start, flush_bytes,
+                                                      ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+                PERF_TRACE_END(PERF_TRACE_CACHE_FLUSH);
                 if (msync_err != ESP_OK) {
                     ESP_LOGW(TAG, "Cache sync failed: %s", esp_err_to_name(msync_err));
                 }
@@ -791,42 +2077,67 @@ static void lcd_animation_task(void *arg)
                 reuse_index = 0;
             }
             frame = s_lcd_buffers[reuse_index];
-            frame_delay_ms = 50;
-            s_target_frame_delay_ms = 50;
+            if (frame && osd && osd_changed) {
+                // Nothing is re-rendered while paused: overlay the new OSD on the held frame.
+                // Elements that disappear stay visible until playback resumes.
+                osd_compose_rows(osd, frame, s_frame_row_stride_bytes, 0, EXAMPLE_LCD_V_RES);
+#if APP_LCD_HAVE_CACHE_MSYNC && defined(CONFIG_P3A_LCD_ENABLE_CACHE_FLUSH)
+                esp_cache_msync(frame, s_frame_buffer_bytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+#endif
+            }
+            // Poll faster while scrubbing so the next position shows without delay
+            frame_delay_ms = scrubbing ? SCRUB_FRAME_MS : 50;
+            s_target_frame_delay_ms = (uint32_t)frame_delay_ms;
             s_last_frame_present_us = 0;
             s_frame_processing_start_us = 0;
         }
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+        if (!sync_frame) {
+            s_sync_anchored = false;  // Paused or gallery: restart the shared timeline on resume
+        }
+#endif
 
         if (!frame) {
             s_last_frame_present_us = 0;
             s_frame_processing_start_us = 0;
+            power_mgmt_busy_end();
             vTaskDelay(pdMS_TO_TICKS(10));
             continue;
         }
         
         // Calculate residual wait time before DMA
         // Use previous frame's delay since that's the frame currently on screen
-        if (!paused_local && s_front_buffer.ready && !APP_LCD_MAX_SPEED_PLAYBACK_ENABLED) {
+        power_mgmt_busy_end();
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+        int64_t sync_due_us = 0;
+        if (sync_frame) {
+            sync_due_us = sync_wall_wait_due(held_frame, frame);
+        } else
+#endif
+        if (playing && s_front_buffer->ready && s_gallery_grid == 0 && !APP_LCD_MAX_SPEED_PLAYBACK_ENABLED) {
             const int64_t now_us = esp_timer_get_time();
             const int64_t processing_time_us = now_us - s_frame_processing_start_us;
             const int64_t target_delay_us = (int64_t)prev_frame_delay_ms * 1000;
             
             if (processing_time_us < target_delay_us) {
-                // Need to wait for the remainder
-                const int64_t residual_us = target_delay_us - processing_time_us;
-                if (residual_us > 0) {
-                    // Convert to milliseconds, with minimum 1 tick
-                    const TickType_t residual_ticks = pdMS_TO_TICKS((residual_us + 500) / 1000);
-                    if (residual_ticks > 0) {
-                        vTaskDelay(residual_ticks);
-                    }
-                }
+                // Wait for the remainder; navigation meanwhile shows its feedback on the frame on screen
+                pacing_wait_until(s_frame_processing_start_us + target_delay_us, held_frame, frame);
             }
             // If processing_time_us >= target_delay_us, we've already exceeded target, skip wait
+            if (processing_time_us > target_delay_us) {
+                metrics_add(METRICS_FRAMES_LATE, 1);
+            }
         }
+        power_mgmt_busy_begin();
         const bool blank_display = (app_lcd_get_brightness() == 0);
+        power_mgmt_set_display_lit(!blank_display);
         if (blank_display) {
             memset(frame, 0, s_frame_buffer_bytes);
+            for (uint8_t i = 0; i < buffer_count && i < EXAMPLE_LCD_BUF_NUM; ++i) {
+                if (s_lcd_buffers[i] == frame) {
+                    s_lcd_border_generation[i] = 0;
+                }
+            }
 #if APP_LCD_HAVE_CACHE_MSYNC && defined(CONFIG_P3A_LCD_ENABLE_CACHE_FLUSH)
             esp_err_t blank_msync_err = esp_cache_msync(frame, s_frame_buffer_bytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M);
             if (blank_msync_err != ESP_OK) {
@@ -835,18 +2146,32 @@ static void lcd_animation_task(void *arg)
 #endif
         }
 
+        PERF_TRACE_BEGIN(PERF_TRACE_PRESENT);
+        const int64_t present_start_us = esp_timer_get_time();
         esp_err_t draw_err = esp_lcd_panel_draw_bitmap(s_display_handle, 0, 0,
                                                        EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, frame);
+        PERF_TRACE_END(PERF_TRACE_PRESENT);
+        metrics_observe_us(METRICS_PRESENT_TIME, esp_timer_get_time() - present_start_us);
+        power_mgmt_busy_end();
         
         if (draw_err != ESP_OK) {
             ESP_LOGE(TAG, "Panel draw failed: %s", esp_err_to_name(draw_err));
             vTaskDelay(pdMS_TO_TICKS(10));
             continue;
         }
+        boot_profile_first_frame();
+        if (playing) {
+            metrics_add(METRICS_FRAMES_PRESENTED, 1);
+        }
 
         // Record DMA completion time and calculate frame duration
-        if (!paused_local && s_front_buffer.ready) {
+        if (playing && s_front_buffer->ready) {
             const int64_t now_us = esp_timer_get_time();
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+            if (sync_frame) {
+                sync_wall_frame_presented(sync_due_us, frame_delay_ms);
+            }
+#endif
 
             // Update duration display (use actual measured time between DMA completions)
             if (s_last_frame_present_us != 0) {
@@ -865,7 +2190,7 @@ static void lcd_animation_task(void *arg)
         }
 
         TickType_t delay_ticks;
-        if (paused_local) {
+        if (!playing) {
             delay_ticks = pdMS_TO_TICKS(frame_delay_ms);
         } else if (APP_LCD_MAX_SPEED_PLAYBACK_ENABLED) {
             delay_ticks = 1;
@@ -877,32 +2202,29 @@ static void lcd_animation_task(void *arg)
             delay_ticks = 1;
         }
 
-        vTaskDelay(delay_ticks);
+        // Paused or held: navigation starts the next tick at once
+        xSemaphoreTake(s_render_wake_sem, delay_ticks);
     }
 }
 
-static void free_sd_file_list(void)
+static void free_sd_file_list(app_lcd_sd_file_list_t *list)
 {
-    if (s_sd_file_list.filenames) {
-        for (size_t i = 0; i < s_sd_file_list.count; i++) {
-            free(s_sd_file_list.filenames[i]);
+    if (list->filenames) {
+        for (size_t i = 0; i < list->count; i++) {
+            free(list->filenames[i]);
         }
-        free(s_sd_file_list.filenames);
-        s_sd_file_list.filenames = NULL;
-    }
-    if (s_sd_file_list.types) {
-        free(s_sd_file_list.types);
-        s_sd_file_list.types = NULL;
+        free(list->filenames);
+        list->filenames = NULL;
     }
-    if (s_sd_file_list.health_flags) {
-        free(s_sd_file_list.health_flags);
-        s_sd_file_list.health_flags = NULL;
+    if (list->types) {
+        free(list->types);
+        list->types = NULL;
     }
-    s_sd_file_list.count = 0;
-    s_sd_file_list.current_index = 0;
-    if (s_sd_file_list.animations_dir) {
-        free(s_sd_file_list.animations_dir);
-        s_sd_file_list.animations_dir = NULL;
+    list->count = 0;
+    list->current_index = 0;
+    if (list->animations_dir) {
+        free(list->animations_dir);
+        list->animations_dir = NULL;
     }
 }
 
@@ -1030,41 +2352,34 @@ static int compare_strings(const void *a, const void *b)
 }
 
 // Shuffle the animation file list using Fisher-Yates algorithm
-static void shuffle_animation_file_list(void)
+static void shuffle_animation_file_list(app_lcd_sd_file_list_t *list)
 {
-    if (s_sd_file_list.count <= 1) {
+    if (list->count <= 1) {
         return;  // Nothing to shuffle
     }
     
     // Fisher-Yates shuffle
-    for (size_t i = s_sd_file_list.count - 1; i > 0; i--) {
+    for (size_t i = list->count - 1; i > 0; i--) {
         size_t j = esp_random() % (i + 1);
         
         // Swap filenames
-        char *temp_filename = s_sd_file_list.filenames[i];
-        s_sd_file_list.filenames[i] = s_sd_file_list.filenames[j];
-        s_sd_file_list.filenames[j] = temp_filename;
+        char *temp_filename = list->filenames[i];
+        list->filenames[i] = list->filenames[j];
+        list->filenames[j] = temp_filename;
         
         // Swap types to keep them in sync
-        asset_type_t temp_type = s_sd_file_list.types[i];
-        s_sd_file_list.types[i] = s_sd_file_list.types[j];
-        s_sd_file_list.types[j] = temp_type;
-        
-        // Swap health flags to keep them in sync
-        if (s_sd_file_list.health_flags) {
-            bool temp_health = s_sd_file_list.health_flags[i];
-            s_sd_file_list.health_flags[i] = s_sd_file_list.health_flags[j];
-            s_sd_file_list.health_flags[j] = temp_health;
-        }
+        asset_type_t temp_type = list->types[i];
+        list->types[i] = list->types[j];
+        list->types[j] = temp_type;
     }
     
     ESP_LOGI(TAG, "Randomized animation file list order");
 }
 
 
-static esp_err_t enumerate_animation_files(const char *dir_path)
+static esp_err_t enumerate_animation_files(app_lcd_sd_file_list_t *list, const char *dir_path)
 {
-    free_sd_file_list();
+    free_sd_file_list(list);
 
     DIR *dir = opendir(dir_path);
     if (!dir) {
@@ -1111,51 +2426,34 @@ static esp_err_t enumerate_animation_files(const char *dir_path)
     }
 
     size_t dir_path_len = strlen(dir_path);
-    s_sd_file_list.animations_dir = (char *)malloc(dir_path_len + 1);
-    if (!s_sd_file_list.animations_dir) {
+    list->animations_dir = (char *)malloc(dir_path_len + 1);
+    if (!list->animations_dir) {
         ESP_LOGE(TAG, "Failed to allocate directory path string");
         closedir(dir);
         return ESP_ERR_NO_MEM;
     }
-    strcpy(s_sd_file_list.animations_dir, dir_path);
+    strcpy(list->animations_dir, dir_path);
 
-    s_sd_file_list.filenames = (char **)malloc(anim_count * sizeof(char *));
-    if (!s_sd_file_list.filenames) {
+    list->filenames = (char **)malloc(anim_count * sizeof(char *));
+    if (!list->filenames) {
         ESP_LOGE(TAG, "Failed to allocate filename array");
-        free(s_sd_file_list.animations_dir);
-        s_sd_file_list.animations_dir = NULL;
+        free(list->animations_dir);
+        list->animations_dir = NULL;
         closedir(dir);
         return ESP_ERR_NO_MEM;
     }
 
-    s_sd_file_list.types = (asset_type_t *)malloc(anim_count * sizeof(asset_type_t));
-    if (!s_sd_file_list.types) {
+    list->types = (asset_type_t *)malloc(anim_count * sizeof(asset_type_t));
+    if (!list->types) {
         ESP_LOGE(TAG, "Failed to allocate type array");
-        free(s_sd_file_list.filenames);
-        free(s_sd_file_list.animations_dir);
-        s_sd_file_list.filenames = NULL;
-        s_sd_file_list.animations_dir = NULL;
+        free(list->filenames);
+        free(list->animations_dir);
+        list->filenames = NULL;
+        list->animations_dir = NULL;
         closedir(dir);
         return ESP_ERR_NO_MEM;
     }
 
-    s_sd_file_list.health_flags = (bool *)malloc(anim_count * sizeof(bool));
-    if (!s_sd_file_list.health_flags) {
-        ESP_LOGE(TAG, "Failed to allocate health flags array");
-        free(s_sd_file_list.filenames);
-        free(s_sd_file_list.types);
-        free(s_sd_file_list.animations_dir);
-        s_sd_file_list.filenames = NULL;
-        s_sd_file_list.types = NULL;
-        s_sd_file_list.animations_dir = NULL;
-        closedir(dir);
-        return ESP_ERR_NO_MEM;
-    }
-    
-    // Initialize all files as healthy (file is ok)
-    for (size_t i = 0; i < anim_count; i++) {
-        s_sd_file_list.health_flags[i] = true;
-    }
 
     size_t idx = 0;
     while ((entry = readdir(dir)) != NULL) {
@@ -1192,49 +2490,46 @@ static esp_err_t enumerate_animation_files(const char *dir_path)
             
             if (is_anim) {
                 size_t name_len = strlen(name);
-                s_sd_file_list.filenames[idx] = (char *)malloc(name_len + 1);
-                if (!s_sd_file_list.filenames[idx]) {
+                list->filenames[idx] = (char *)malloc(name_len + 1);
+                if (!list->filenames[idx]) {
                     for (size_t i = 0; i < idx; i++) {
-                        free(s_sd_file_list.filenames[i]);
+                        free(list->filenames[i]);
                     }
-                    free(s_sd_file_list.filenames);
-                    free(s_sd_file_list.types);
-                    free(s_sd_file_list.health_flags);
-                    free(s_sd_file_list.animations_dir);
-                    s_sd_file_list.filenames = NULL;
-                    s_sd_file_list.types = NULL;
-                    s_sd_file_list.health_flags = NULL;
-                    s_sd_file_list.animations_dir = NULL;
+                    free(list->filenames);
+                    free(list->types);
+                    free(list->animations_dir);
+                    list->filenames = NULL;
+                    list->types = NULL;
+                    list->animations_dir = NULL;
                     closedir(dir);
                     return ESP_ERR_NO_MEM;
                 }
-                strcpy(s_sd_file_list.filenames[idx], name);
-                s_sd_file_list.types[idx] = get_asset_type(name);
+                strcpy(list->filenames[idx], name);
+                list->types[idx] = get_asset_type(name);
                 idx++;
             }
         }
     }
     closedir(dir);
 
-    s_sd_file_list.count = anim_count;
+    list->count = anim_count;
 
-    qsort(s_sd_file_list.filenames, s_sd_file_list.count, sizeof(char *), compare_strings);
+    qsort(list->filenames, list->count, sizeof(char *), compare_strings);
     // Re-sort types array to match sorted filenames
-    // Note: health_flags don't need re-sorting since they're all initialized to true
-    for (size_t i = 0; i < s_sd_file_list.count; i++) {
-        s_sd_file_list.types[i] = get_asset_type(s_sd_file_list.filenames[i]);
+    for (size_t i = 0; i < list->count; i++) {
+        list->types[i] = get_asset_type(list->filenames[i]);
     }
 
-    ESP_LOGI(TAG, "Found %zu animation files in %s", s_sd_file_list.count, dir_path);
-    // for (size_t i = 0; i < s_sd_file_list.count; i++) {
-    //     ESP_LOGI(TAG, "  [%zu] %s (%s)", i, s_sd_file_list.filenames[i],
-    //              s_sd_file_list.types[i] == ASSET_TYPE_WEBP ? "WebP" : "GIF");
+    ESP_LOGI(TAG, "Found %zu animation files in %s", list->count, dir_path);
+    // for (size_t i = 0; i < list->count; i++) {
+    //     ESP_LOGI(TAG, "  [%zu] %s (%s)", i, list->filenames[i],
+    //              list->types[i] == ASSET_TYPE_WEBP ? "WebP" : "GIF");
     // }
 
     // Randomize the file list order after enumeration
-    shuffle_animation_file_list();
+    shuffle_animation_file_list(list);
 
-    s_sd_file_list.current_index = 0;
+    list->current_index = 0;
     return ESP_OK;
 }
 
@@ -1251,7 +2546,7 @@ static esp_err_t enumerate_animation_files(const char *dir_path)
 static void filter_file_list_for_debug(void)
 {
     if (s_sd_file_list.count == 0 || !s_sd_file_list.filenames || 
-        !s_sd_file_list.types || !s_sd_file_list.health_flags) {
+        !s_sd_file_list.types) {
         return;
     }
 
@@ -1336,13 +2631,11 @@ static void filter_file_list_for_debug(void)
     // Create new arrays with only the selected files
     char **new_filenames = (char **)malloc(keep_count * sizeof(char *));
     asset_type_t *new_types = (asset_type_t *)malloc(keep_count * sizeof(asset_type_t));
-    bool *new_health_flags = (bool *)malloc(keep_count * sizeof(bool));
 
-    if (!new_filenames || !new_types || !new_health_flags) {
+    if (!new_filenames || !new_types) {
         ESP_LOGE(TAG, "DEBUG: Failed to allocate filtered file list arrays");
         free(new_filenames);
         free(new_types);
-        free(new_health_flags);
         return;
     }
 
@@ -1358,13 +2651,11 @@ static void filter_file_list_for_debug(void)
             }
             free(new_filenames);
             free(new_types);
-            free(new_health_flags);
             ESP_LOGE(TAG, "DEBUG: Failed to allocate filename in filtered list");
             return;
         }
         strcpy(new_filenames[i], s_sd_file_list.filenames[src_idx]);
         new_types[i] = s_sd_file_list.types[src_idx];
-        new_health_flags[i] = s_sd_file_list.health_flags[src_idx];
     }
 
     // Free old arrays
@@ -1373,14 +2664,13 @@ static void filter_file_list_for_debug(void)
     }
     free(s_sd_file_list.filenames);
     free(s_sd_file_list.types);
-    free(s_sd_file_list.health_flags);
 
     // Replace with filtered arrays
     s_sd_file_list.filenames = new_filenames;
     s_sd_file_list.types = new_types;
-    s_sd_file_list.health_flags = new_health_flags;
     s_sd_file_list.count = keep_count;
     s_sd_file_list.current_index = 0;
+    asset_health_reset(keep_count);
 
     ESP_LOGI(TAG, "DEBUG: Filtered file list to %zu files (1 jpg, 1 gif, 1 png, 1 webp, %zu random)", 
              keep_count, random_count);
@@ -1389,8 +2679,40 @@ static void filter_file_list_for_debug(void)
 // END TEMPORARY DEBUG FUNCTION
 // ============================================================================
 
-static esp_err_t load_animation_file_from_sd(const char *filepath, uint8_t **data_out, size_t *size_out)
+// Drop the kept data of a cancelled read
+static void partial_read_discard(void)
+{
+    free(s_partial_read.path);
+    free(s_partial_read.data);
+    memset(&s_partial_read, 0, sizeof(s_partial_read));
+}
+
+// Keep what a cancelled load has read so far, replacing any older partial read. Takes ownership of data.
+static void partial_read_keep(const char *filepath, uint8_t *data, size_t size, size_t filled)
+{
+    partial_read_discard();
+    s_partial_read.path = strdup(filepath);
+    if (!s_partial_read.path) {
+        free(data);
+        return;
+    }
+    s_partial_read.data = data;
+    s_partial_read.size = size;
+    s_partial_read.filled = filled;
+    ESP_LOGD(TAG, "Keeping %zu of %zu bytes of %s for a later request", filled, size, filepath);
+}
+
+// Read a whole file into a new buffer. With a cancellation token (loader task only) the file is read in
+// chunks, the token is checked between them, and LOAD_CANCELLED is returned once it is set. Resumable
+// reads (artwork loads) keep what a cancelled read got, to pick it up on the next request for the same
+// file; other reads (thumbnails) drop it and never touch the kept data.
+static esp_err_t load_animation_file_from_sd(const char *filepath, const atomic_bool *cancel, bool resumable,
+                                             uint8_t **data_out, size_t *size_out)
 {
+    if (cancel && atomic_load(cancel)) {
+        return LOAD_CANCELLED;
+    }
+
     FILE *f = fopen(filepath, "rb");
     if (!f) {
         ESP_LOGE(TAG, "Failed to open file: %s", filepath);
@@ -1407,7 +2729,22 @@ static esp_err_t load_animation_file_from_sd(const char *filepath, uint8_t **dat
         return ESP_ERR_INVALID_SIZE;
     }
 
-    uint8_t *buffer = (uint8_t *)heap_caps_malloc((size_t)file_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    // Pick up where a cancelled read of the same file stopped
+    uint8_t *buffer = NULL;
+    size_t bytes_read = 0;
+    if (cancel && resumable && s_partial_read.path && strcmp(s_partial_read.path, filepath) == 0 &&
+        s_partial_read.size == (size_t)file_size) {
+        buffer = s_partial_read.data;
+        bytes_read = s_partial_read.filled;
+        s_partial_read.data = NULL;
+        partial_read_discard();
+        fseek(f, (long)bytes_read, SEEK_SET);
+        ESP_LOGD(TAG, "Resuming read of %s at %zu of %ld bytes", filepath, bytes_read, file_size);
+    }
+
+    if (!buffer) {
+        buffer = (uint8_t *)heap_caps_malloc((size_t)file_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
     if (!buffer) {
         buffer = (uint8_t *)malloc((size_t)file_size);
         if (!buffer) {
@@ -1417,7 +2754,25 @@ static esp_err_t load_animation_file_from_sd(const char *filepath, uint8_t **dat
         }
     }
 
-    size_t bytes_read = fread(buffer, 1, (size_t)file_size, f);
+    const size_t chunk_bytes = cancel ? LOAD_CHUNK_BYTES : (size_t)file_size;
+    while (bytes_read < (size_t)file_size) {
+        if (cancel && atomic_load(cancel)) {
+            fclose(f);
+            if (resumable) {
+                partial_read_keep(filepath, buffer, (size_t)file_size, bytes_read);
+            } else {
+                free(buffer);
+            }
+            return LOAD_CANCELLED;
+        }
+        const size_t want = ((size_t)file_size - bytes_read < chunk_bytes) ? (size_t)file_size - bytes_read : chunk_bytes;
+        const size_t got = fread(buffer + bytes_read, 1, want, f);
+        metrics_add(METRICS_SD_READ_BYTES, got);
+        bytes_read += got;
+        if (got != want) {
+            break;
+        }
+    }
     fclose(f);
 
     if (bytes_read != (size_t)file_size) {
@@ -1454,12 +2809,18 @@ static void unload_animation_buffer(animation_buffer_t *buf)
     buf->native_buffer_active = 0;
     buf->native_frame_size = 0;
     
+    heap_caps_free(buf->prescaled_frame);
+    buf->prescaled_frame = NULL;
+    buf->prescaler = PIXEL_SCALER_NONE;
+    
     heap_caps_free(buf->upscale_lookup_x);
     heap_caps_free(buf->upscale_lookup_y);
     buf->upscale_lookup_x = NULL;
     buf->upscale_lookup_y = NULL;
     buf->upscale_src_w = 0;
     buf->upscale_src_h = 0;
+    buf->upscale_dst_x = 0;
+    buf->upscale_dst_y = 0;
     buf->upscale_dst_w = 0;
     buf->upscale_dst_h = 0;
     
@@ -1467,94 +2828,224 @@ static void unload_animation_buffer(animation_buffer_t *buf)
     buf->prefetched_first_frame = NULL;
     buf->first_frame_ready = false;
     buf->decoder_at_frame_1 = false;
-    buf->prefetch_pending = false;
     buf->prefetched_first_frame_delay_ms = 1;
     buf->current_frame_delay_ms = 1;
+    buf->next_frame_index = 0;
     
     buf->ready = false;
     memset(&buf->decoder_info, 0, sizeof(buf->decoder_info));
     buf->asset_index = 0;
 }
 
-// Calculate next animation index in play order, skipping unhealthy files
+// Calculate next animation index in play order, skipping quarantined files
 // Returns current_index if no healthy files are found (to avoid infinite loops)
 static size_t get_next_asset_index(size_t current_index)
 {
-    if (s_sd_file_list.count == 0) {
-        return 0;
+    return asset_health_next(current_index, s_sd_file_list.count);
+}
+
+// Calculate previous animation index in play order, skipping quarantined files
+// Returns current_index if no healthy files are found (to avoid infinite loops)
+static size_t get_previous_asset_index(size_t current_index)
+{
+    return asset_health_prev(current_index, s_sd_file_list.count);
+}
+
+// Put a READY slot on screen by swapping the front pointer (render task only) and retire the slot it
+// replaces. requested_us is when the user asked for the change, 0 for a scheduled swap.
+static bool swap_buffers(anim_slot_t *slot, int64_t requested_us)
+{
+    PERF_TRACE_BEGIN(PERF_TRACE_SWAP);
+    if (!slot_transition(slot, SLOT_READY, SLOT_PLAYING)) {
+        PERF_TRACE_END(PERF_TRACE_SWAP);
+        return false;
     }
+    start_swap_transition();
+    anim_slot_t *old_front = (anim_slot_t *)atomic_exchange(&s_front_buffer, &slot->anim);
+    old_front->anim.ready = false;
+    atomic_store(&old_front->state, SLOT_RETIRING);
     
-    // If health flags aren't available, fall back to simple increment
-    if (!s_sd_file_list.health_flags) {
-        return (current_index + 1) % s_sd_file_list.count;
+    const int64_t now_us = esp_timer_get_time();
+    atomic_store(&s_front_shown_since_us, now_us);
+    if (requested_us != 0) {
+        metrics_observe_us(METRICS_SWAP_LATENCY, now_us - requested_us);
     }
     
-    // Search for next healthy file, wrapping around if necessary
-    size_t start_index = (current_index + 1) % s_sd_file_list.count;
-    size_t checked = 0;
+    // New content rectangle, every LCD buffer needs its border repainted once
+    s_border_generation++;
     
-    while (checked < s_sd_file_list.count) {
-        if (s_sd_file_list.health_flags[start_index]) {
-            return start_index;  // Found a healthy file
-        }
-        start_index = (start_index + 1) % s_sd_file_list.count;
-        checked++;
+    // The request is done unless navigation has meanwhile moved on to another target
+    if (swap_params_load().target_index == slot->anim.asset_index) {
+        player_state_update(0, PLAYER_SWAP_REQUESTED | PLAYER_SWAP_AT_LOOP_END, 0);
+    }
+    metrics_add(METRICS_SWAPS, 1);
+#if CONFIG_P3A_SYNC_WALL_ENABLE && CONFIG_P3A_SYNC_WALL_LEADER
+    // Swaps that were not announced when requested, like the first artwork, are announced as they happen
+    const size_t index = slot->anim.asset_index;
+    if (index < s_sd_file_list.count &&
+        sync_clock_asset_id(s_sd_file_list.filenames[index]) != atomic_load(&s_sync_announced_id)) {
+        sync_wall_announce_index(index, now_us, now_us);
     }
+#endif
     
-    // No healthy files found, return current_index to avoid infinite loops
-    return current_index;
+    // Let the loader free the retired slot and preload the next artwork
+    xSemaphoreGive(s_loader_sem);
+    
+    ESP_LOGI(TAG, "Buffers swapped: front now playing index %zu", slot->anim.asset_index);
+    PERF_TRACE_END(PERF_TRACE_SWAP);
+    return true;
 }
 
-// Calculate previous animation index in play order, skipping unhealthy files
-// Returns current_index if no healthy files are found (to avoid infinite loops)
-static size_t get_previous_asset_index(size_t current_index)
+// Size of the canvas in the viewer's frame for the configured scaling mode
+static void compute_scaled_size(int canvas_w, int canvas_h, int panel_w, int panel_h, int *out_w, int *out_h)
 {
-    if (s_sd_file_list.count == 0) {
-        return 0;
-    }
+    scaling_mode_t mode = P3A_SCALING_MODE;
     
-    // If health flags aren't available, fall back to simple decrement
-    if (!s_sd_file_list.health_flags) {
-        return (current_index == 0) ? (s_sd_file_list.count - 1) : (current_index - 1);
+    if (mode == SCALING_MODE_CENTER && (canvas_w > panel_w || canvas_h > panel_h)) {
+        mode = SCALING_MODE_FIT;
+    }
+    if (mode == SCALING_MODE_INTEGER) {
+        const int scale_x = panel_w / canvas_w;
+        const int scale_y = panel_h / canvas_h;
+        const int scale = (scale_x < scale_y) ? scale_x : scale_y;
+        if (scale >= 1) {
+            *out_w = canvas_w * scale;
+            *out_h = canvas_h * scale;
+            return;
+        }
+        mode = SCALING_MODE_FIT;
     }
     
-    // Search for previous healthy file, wrapping around if necessary
-    size_t start_index = (current_index == 0) ? (s_sd_file_list.count - 1) : (current_index - 1);
-    size_t checked = 0;
-    
-    while (checked < s_sd_file_list.count) {
-        if (s_sd_file_list.health_flags[start_index]) {
-            return start_index;  // Found a healthy file
+    // Compare canvas_w/canvas_h against panel_w/panel_h without division
+    const bool wider = (int64_t)canvas_w * panel_h >= (int64_t)canvas_h * panel_w;
+    switch (mode) {
+    case SCALING_MODE_STRETCH:
+        *out_w = panel_w;
+        *out_h = panel_h;
+        break;
+    case SCALING_MODE_CENTER:
+        *out_w = canvas_w;
+        *out_h = canvas_h;
+        break;
+    case SCALING_MODE_FILL:
+        if (wider) {
+            *out_h = panel_h;
+            *out_w = (int)(((int64_t)canvas_w * panel_h) / canvas_h);
+        } else {
+            *out_w = panel_w;
+            *out_h = (int)(((int64_t)canvas_h * panel_w) / canvas_w);
         }
-        start_index = (start_index == 0) ? (s_sd_file_list.count - 1) : (start_index - 1);
-        checked++;
+        break;
+    case SCALING_MODE_FIT:
+    default:
+        if (wider) {
+            *out_w = panel_w;
+            *out_h = (int)(((int64_t)canvas_h * panel_w) / canvas_w);
+        } else {
+            *out_h = panel_h;
+            *out_w = (int)(((int64_t)canvas_w * panel_h) / canvas_h);
+        }
+        break;
+    }
+    if (*out_w < 1) *out_w = 1;
+    if (*out_h < 1) *out_h = 1;
+}
+
+// One view axis of the scaled canvas and how it maps to source memory
+typedef struct {
+    int offset;       // View coordinate of the first scaled canvas pixel (may precede clip_start when cropped)
+    int scaled;       // Scaled canvas extent along this axis
+    int src_extent;   // Source pixels along this axis
+    uint32_t stride;  // Source bytes per step along this axis
+    int clip_start;   // Viewport range [clip_start, clip_end) along this axis
+    int clip_end;
+} axis_map_t;
+
+// View coordinate controlled by a panel column (is_column) or row, after rotation and flips
+static int panel_axis_view_coord(bool is_column, int panel_pos)
+{
+    int x = is_column ? panel_pos : 0;
+    int y = is_column ? 0 : panel_pos;
+    display_orientation_panel_to_view(&x, &y, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES);
+    // Columns drive view x unless the view is transposed, rows drive the other axis
+    return (is_column != DISPLAY_ORIENTATION_TRANSPOSED) ? x : y;
+}
+
+static uint32_t axis_source_offset(const axis_map_t *axis, int view_pos)
+{
+    int src = ((view_pos - axis->offset) * axis->src_extent) / axis->scaled;
+    if (src < 0) {
+        src = 0;
+    } else if (src >= axis->src_extent) {
+        src = axis->src_extent - 1;
+    }
+    return (uint32_t)src * axis->stride;
+}
+
+// Contiguous range of panel columns (or rows) that show the scaled canvas
+static void panel_axis_range(bool is_column, const axis_map_t *axis, int *start, int *count)
+{
+    const int panel_extent = is_column ? EXAMPLE_LCD_H_RES : EXAMPLE_LCD_V_RES;
+    int lo = (axis->offset > axis->clip_start) ? axis->offset : axis->clip_start;
+    int hi = axis->offset + axis->scaled;
+    if (hi > axis->clip_end) {
+        hi = axis->clip_end;
+    }
+    *start = -1;
+    *count = 0;
+    for (int p = 0; p < panel_extent; ++p) {
+        const int v = panel_axis_view_coord(is_column, p);
+        if (v >= lo && v < hi) {
+            if (*start < 0) {
+                *start = p;
+            }
+            (*count)++;
+        }
+    }
+    if (*start < 0) {
+        *start = 0;
     }
-    
-    // No healthy files found, return current_index to avoid infinite loops
-    return current_index;
 }
 
-// Atomically swap front and back buffers
-static void swap_buffers(void)
+static bool decoder_type_for_asset(asset_type_t type, animation_decoder_type_t *out)
 {
-    if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-        animation_buffer_t temp = s_front_buffer;
-        s_front_buffer = s_back_buffer;
-        s_back_buffer = temp;
-        
-        // Clear swap request and reset back buffer ready flag
-        s_swap_requested = false;
-        s_back_buffer.ready = false;  // Back buffer needs to be reloaded
-        s_back_buffer.first_frame_ready = false;  // Clear prefetch flag
-        s_back_buffer.prefetch_pending = false;  // Clear prefetch pending flag
-        
-        xSemaphoreGive(s_buffer_mutex);
-        
-        ESP_LOGI(TAG, "Buffers swapped: front now playing index %zu", s_front_buffer.asset_index);
+    switch (type) {
+    case ASSET_TYPE_WEBP:
+        *out = ANIMATION_DECODER_TYPE_WEBP;
+        return true;
+    case ASSET_TYPE_GIF:
+        *out = ANIMATION_DECODER_TYPE_GIF;
+        return true;
+    case ASSET_TYPE_PNG:
+        *out = ANIMATION_DECODER_TYPE_PNG;
+        return true;
+    case ASSET_TYPE_JPEG:
+        *out = ANIMATION_DECODER_TYPE_JPEG;
+        return true;
+    default:
+        return false;
     }
 }
 
 // Initialize animation decoder and allocate buffers for a given animation buffer
+// Undo a partly done init_animation_decoder_for_buffer(); the file data stays with the caller
+static void release_decoder_for_buffer(animation_buffer_t *buf)
+{
+    animation_decoder_unload(&buf->decoder);
+    free(buf->native_frame_b1);
+    free(buf->native_frame_b2);
+    buf->native_frame_b1 = NULL;
+    buf->native_frame_b2 = NULL;
+    buf->native_frame_size = 0;
+    heap_caps_free(buf->prescaled_frame);
+    buf->prescaled_frame = NULL;
+    buf->prescaler = PIXEL_SCALER_NONE;
+    heap_caps_free(buf->upscale_lookup_x);
+    heap_caps_free(buf->upscale_lookup_y);
+    buf->upscale_lookup_x = NULL;
+    buf->upscale_lookup_y = NULL;
+}
+
 static esp_err_t init_animation_decoder_for_buffer(animation_buffer_t *buf, asset_type_t type, const uint8_t *data, size_t size)
 {
     if (!buf) {
@@ -1562,15 +3053,7 @@ static esp_err_t init_animation_decoder_for_buffer(animation_buffer_t *buf, asse
     }
     
     animation_decoder_type_t decoder_type;
-    if (type == ASSET_TYPE_WEBP) {
-        decoder_type = ANIMATION_DECODER_TYPE_WEBP;
-    } else if (type == ASSET_TYPE_GIF) {
-        decoder_type = ANIMATION_DECODER_TYPE_GIF;
-    } else if (type == ASSET_TYPE_PNG) {
-        decoder_type = ANIMATION_DECODER_TYPE_PNG;
-    } else if (type == ASSET_TYPE_JPEG) {
-        decoder_type = ANIMATION_DECODER_TYPE_JPEG;
-    } else {
+    if (!decoder_type_for_asset(type, &decoder_type)) {
         return ESP_ERR_INVALID_ARG;
     }
     
@@ -1580,6 +3063,13 @@ static esp_err_t init_animation_decoder_for_buffer(animation_buffer_t *buf, asse
         return err;
     }
 
+    // Indexed formats resolve transparency against a solid background once, in the palette
+    // lookup, instead of per pixel at blit time
+    uint8_t bg_rgb[3];
+    if (frame_background_uniform_color(bg_rgb)) {
+        (void)animation_decoder_set_background(buf->decoder, bg_rgb[0], bg_rgb[1], bg_rgb[2]);
+    }
+
     err = animation_decoder_get_info(buf->decoder, &buf->decoder_info);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to get decoder info");
@@ -1589,6 +3079,11 @@ static esp_err_t init_animation_decoder_for_buffer(animation_buffer_t *buf, asse
 
     const int canvas_w = (int)buf->decoder_info.canvas_width;
     const int canvas_h = (int)buf->decoder_info.canvas_height;
+    if (canvas_w <= 0 || canvas_h <= 0) {
+        ESP_LOGE(TAG, "Invalid canvas size %dx%d", canvas_w, canvas_h);
+        animation_decoder_unload(&buf->decoder);
+        return ESP_ERR_INVALID_SIZE;
+    }
     buf->native_frame_size = (size_t)canvas_w * canvas_h * 4; // RGBA
     
     buf->native_frame_b1 = (uint8_t *)malloc(buf->native_frame_size);
@@ -1609,52 +3104,195 @@ static esp_err_t init_animation_decoder_for_buffer(animation_buffer_t *buf, asse
     
     buf->native_buffer_active = 0;
     
-    const int target_w = EXAMPLE_LCD_H_RES;
-    const int target_h = EXAMPLE_LCD_V_RES;
+    // Scaling is laid out in the viewer's frame, which is the panel turned by the rotation
+    int vp_x = 0, vp_y = 0;
+    int vp_w = DISPLAY_ORIENTATION_TRANSPOSED ? EXAMPLE_LCD_V_RES : EXAMPLE_LCD_H_RES;
+    int vp_h = DISPLAY_ORIENTATION_TRANSPOSED ? EXAMPLE_LCD_H_RES : EXAMPLE_LCD_V_RES;
+    if (buf->viewport_w > 0 && buf->viewport_h > 0) {
+        vp_x = buf->viewport_x;
+        vp_y = buf->viewport_y;
+        vp_w = buf->viewport_w;
+        vp_h = buf->viewport_h;
+    }
+    
+    // Scaled canvas size and its offset in the view; offsets before the viewport crop (fill mode)
+    int scaled_w = 0, scaled_h = 0;
+    compute_scaled_size(canvas_w, canvas_h, vp_w, vp_h, &scaled_w, &scaled_h);
+    const int offset_x = vp_x + (vp_w - scaled_w) / 2;
+    const int offset_y = vp_y + (vp_h - scaled_h) / 2;
+    
+    // Pre-scale only while the result is still magnified by the nearest pass
+    heap_caps_free(buf->prescaled_frame);
+    buf->prescaled_frame = NULL;
+    buf->prescaler = pixel_scaler_select(P3A_PIXEL_SCALER, canvas_w, canvas_h, scaled_w, scaled_h);
+    if (buf->prescaler != PIXEL_SCALER_NONE) {
+        const size_t factor = (size_t)pixel_scaler_factor(buf->prescaler);
+        const size_t prescaled_size = buf->native_frame_size * factor * factor;
+        buf->prescaled_frame = (uint8_t *)heap_caps_malloc(prescaled_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!buf->prescaled_frame) {
+            ESP_LOGW(TAG, "Failed to allocate %zu byte pre-scale buffer, using nearest neighbour only", prescaled_size);
+            buf->prescaler = PIXEL_SCALER_NONE;
+        }
+    }
+    const int src_w = canvas_w * pixel_scaler_factor(buf->prescaler);
+    const int src_h = canvas_h * pixel_scaler_factor(buf->prescaler);
+    
+    // Panel columns each control one view axis (view x, or view y when transposed), and so do
+    // panel rows. Columns/rows whose view coordinate lands on the scaled canvas form the
+    // content rectangle; each gets the byte offset of the source column/row it samples.
+    const axis_map_t x_axis = { offset_x, scaled_w, src_w, 4U, vp_x, vp_x + vp_w };
+    const axis_map_t y_axis = { offset_y, scaled_h, src_h, (uint32_t)src_w * 4U, vp_y, vp_y + vp_h };
+    const axis_map_t col_axis = DISPLAY_ORIENTATION_TRANSPOSED ? y_axis : x_axis;
+    const axis_map_t row_axis = DISPLAY_ORIENTATION_TRANSPOSED ? x_axis : y_axis;
+    
+    int content_x = 0, target_w = 0, content_y = 0, target_h = 0;
+    panel_axis_range(true, &col_axis, &content_x, &target_w);
+    panel_axis_range(false, &row_axis, &content_y, &target_h);
+    if (target_w <= 0 || target_h <= 0) {
+        ESP_LOGE(TAG, "Empty content rectangle for %dx%d canvas", canvas_w, canvas_h);
+        release_decoder_for_buffer(buf);
+        return ESP_ERR_INVALID_SIZE;
+    }
     
     heap_caps_free(buf->upscale_lookup_x);
     heap_caps_free(buf->upscale_lookup_y);
+    buf->upscale_lookup_y = NULL;
     
-    buf->upscale_lookup_x = (uint16_t *)heap_caps_malloc((size_t)target_w * sizeof(uint16_t), MALLOC_CAP_INTERNAL);
+    buf->upscale_lookup_x = (uint32_t *)heap_caps_malloc((size_t)target_w * sizeof(uint32_t), MALLOC_CAP_INTERNAL);
     if (!buf->upscale_lookup_x) {
         ESP_LOGE(TAG, "Failed to allocate upscale lookup X");
-        unload_animation_buffer(buf);
+        release_decoder_for_buffer(buf);
         return ESP_ERR_NO_MEM;
     }
     
-    buf->upscale_lookup_y = (uint16_t *)heap_caps_malloc((size_t)target_h * sizeof(uint16_t), MALLOC_CAP_INTERNAL);
+    buf->upscale_lookup_y = (uint32_t *)heap_caps_malloc((size_t)target_h * sizeof(uint32_t), MALLOC_CAP_INTERNAL);
     if (!buf->upscale_lookup_y) {
         ESP_LOGE(TAG, "Failed to allocate upscale lookup Y");
-        unload_animation_buffer(buf);
+        release_decoder_for_buffer(buf);
         return ESP_ERR_NO_MEM;
     }
     
-    for (int dst_x = 0; dst_x < target_w; ++dst_x) {
-        int src_x = (dst_x * canvas_w) / target_w;
-        if (src_x >= canvas_w) {
-            src_x = canvas_w - 1;
-        }
-        buf->upscale_lookup_x[dst_x] = (uint16_t)src_x;
+    for (int i = 0; i < target_w; ++i) {
+        buf->upscale_lookup_x[i] = axis_source_offset(&col_axis, panel_axis_view_coord(true, content_x + i));
     }
-    
-    for (int dst_y = 0; dst_y < target_h; ++dst_y) {
-        int src_y = (dst_y * canvas_h) / target_h;
-        if (src_y >= canvas_h) {
-            src_y = canvas_h - 1;
-        }
-        buf->upscale_lookup_y[dst_y] = (uint16_t)src_y;
+    for (int i = 0; i < target_h; ++i) {
+        buf->upscale_lookup_y[i] = axis_source_offset(&row_axis, panel_axis_view_coord(false, content_y + i));
     }
     
-    buf->upscale_src_w = canvas_w;
-    buf->upscale_src_h = canvas_h;
+    buf->upscale_src_w = src_w;
+    buf->upscale_src_h = src_h;
+    buf->upscale_dst_x = content_x;
+    buf->upscale_dst_y = content_y;
     buf->upscale_dst_w = target_w;
     buf->upscale_dst_h = target_h;
 
     return ESP_OK;
 }
 
-// Load animation file and initialize decoder into specified buffer
-static esp_err_t load_animation_into_buffer(size_t asset_index, animation_buffer_t *buf)
+// Failure reason recorded for an error from load_animation_file_from_sd()
+static asset_failure_reason_t read_failure_reason(esp_err_t err)
+{
+    switch (err) {
+    case ESP_ERR_NO_MEM:
+        return ASSET_FAILURE_NO_MEM;
+    case ESP_ERR_INVALID_SIZE:
+        return ASSET_FAILURE_READ;
+    default:
+        return ASSET_FAILURE_OPEN;
+    }
+}
+
+// Load an animation file and initialize its decoder into the specified buffer. asset_index is
+// recorded in the buffer and names the failure record to update; indices past the file list (the
+// cached start-up artwork before enumeration has finished) leave the flags alone.
+// The load runs in stages (open, chunked read, decoder init); a set cancel token stops it at the next
+// stage boundary with LOAD_CANCELLED, keeping the file data for a later request. The first-frame
+// prefetch is the last stage and runs on the render task.
+static esp_err_t load_animation_path_into_buffer(const char *filepath, asset_type_t type,
+                                                 size_t asset_index, animation_buffer_t *buf,
+                                                 const atomic_bool *cancel)
+{
+    if (!filepath || !buf) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Unload previous animation in this buffer
+    unload_animation_buffer(buf);
+
+    uint8_t *file_data = NULL;
+    size_t file_size = 0;
+    PERF_TRACE_BEGIN(PERF_TRACE_LOAD_FILE);
+    esp_err_t err = load_animation_file_from_sd(filepath, cancel, true, &file_data, &file_size);
+    PERF_TRACE_END(PERF_TRACE_LOAD_FILE);
+    if (err == LOAD_CANCELLED) {
+        return err;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to load file from SD: %s", esp_err_to_name(err));
+        // Quarantine the file; it is retried later in case the card only glitched
+        if (asset_index < s_sd_file_list.count) {
+            asset_health_record_failure(asset_index, read_failure_reason(err), err);
+        }
+        return err;
+    }
+
+    if (cancel && atomic_load(cancel)) {
+        partial_read_keep(filepath, file_data, file_size, file_size);
+        return LOAD_CANCELLED;
+    }
+
+    buf->file_data = file_data;
+    buf->file_size = file_size;
+    buf->type = type;
+    buf->asset_index = asset_index;
+
+    err = init_animation_decoder_for_buffer(buf, type, file_data, file_size);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize animation decoder '%s': %s", filepath, esp_err_to_name(err));
+        if (asset_index < s_sd_file_list.count) {
+            asset_health_record_failure(asset_index,
+                                        (err == ESP_ERR_NO_MEM) ? ASSET_FAILURE_NO_MEM : ASSET_FAILURE_DECODE, err);
+        }
+        free(file_data);
+        buf->file_data = NULL;
+        buf->file_size = 0;
+        return err;
+    }
+    
+    // Clear any failure record since loading succeeded
+    if (asset_index < s_sd_file_list.count) {
+        asset_health_record_success(asset_index);
+    }
+
+    // Decoder setup is the most expensive stage to repeat, but its state is per slot; keep the file data
+    if (cancel && atomic_load(cancel)) {
+        buf->file_data = NULL;
+        buf->file_size = 0;
+        unload_animation_buffer(buf);
+        partial_read_keep(filepath, file_data, file_size, file_size);
+        return LOAD_CANCELLED;
+    }
+
+    // Allocate prefetched frame buffer (LCD-sized); gallery tiles are drawn straight from the decoder
+    if (!buf->gallery_tile) {
+        buf->prefetched_first_frame = (uint8_t *)malloc(s_frame_buffer_bytes);
+        if (!buf->prefetched_first_frame) {
+            ESP_LOGE(TAG, "Failed to allocate prefetched frame buffer");
+            unload_animation_buffer(buf);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    buf->first_frame_ready = false;
+    buf->decoder_at_frame_1 = false;
+    buf->next_frame_index = 0;
+
+    ESP_LOGI(TAG, "Loaded animation into buffer: %s (index %zu)", filepath, asset_index);
+
+    return ESP_OK;
+}
+
+// Load the animation at asset_index of the file list into the specified buffer
+static esp_err_t load_animation_into_buffer(size_t asset_index, animation_buffer_t *buf, const atomic_bool *cancel)
 {
     if (!buf) {
         return ESP_ERR_INVALID_ARG;
@@ -1670,9 +3308,6 @@ static esp_err_t load_animation_into_buffer(size_t asset_index, animation_buffer
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Unload previous animation in this buffer
-    unload_animation_buffer(buf);
-
     const char *filename = s_sd_file_list.filenames[asset_index];
     const char *animations_dir = s_sd_file_list.animations_dir;
     asset_type_t type = s_sd_file_list.types[asset_index];
@@ -1689,58 +3324,150 @@ static esp_err_t load_animation_into_buffer(size_t asset_index, animation_buffer
         return ESP_ERR_INVALID_ARG;
     }
 
+    return load_animation_path_into_buffer(filepath, type, asset_index, buf, cancel);
+}
+
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+// Fit a decoded RGBA canvas into a square thumbnail in panel pixel format, centred over black.
+// Nearest-neighbour sampling keeps pixel art crisp.
+static void downscale_thumbnail(const uint8_t *rgba, int canvas_w, int canvas_h, uint8_t *out)
+{
+    const int side = THUMB_CACHE_SIDE;
+    int scaled_w = side, scaled_h = side;
+    if (canvas_w > canvas_h) {
+        scaled_h = (int)(((int64_t)side * canvas_h + canvas_w / 2) / canvas_w);
+    } else if (canvas_h > canvas_w) {
+        scaled_w = (int)(((int64_t)side * canvas_w + canvas_h / 2) / canvas_h);
+    }
+    scaled_w = (scaled_w > 0) ? scaled_w : 1;
+    scaled_h = (scaled_h > 0) ? scaled_h : 1;
+    const int x0 = (side - scaled_w) / 2;
+    const int y0 = (side - scaled_h) / 2;
+    
+    for (int y = 0; y < side; ++y) {
+        const int sy = (y - y0) * canvas_h / scaled_h;
+        for (int x = 0; x < side; ++x) {
+            const int sx = (x - x0) * canvas_w / scaled_w;
+            uint8_t r = 0, g = 0, b = 0;
+            if (y >= y0 && y < y0 + scaled_h && x >= x0 && x < x0 + scaled_w) {
+                const uint8_t *px = rgba + ((size_t)sy * canvas_w + sx) * 4;
+                r = (uint8_t)((px[0] * px[3]) / 255);
+                g = (uint8_t)((px[1] * px[3]) / 255);
+                b = (uint8_t)((px[2] * px[3]) / 255);
+            }
+#if CONFIG_LCD_PIXEL_FORMAT_RGB565
+            ((uint16_t *)out)[(size_t)y * side + x] = rgb565(r, g, b);
+#else
+            uint8_t *dst = out + ((size_t)y * side + x) * 3;
+            dst[0] = b;
+            dst[1] = g;
+            dst[2] = r;
+#endif
+        }
+    }
+}
+
+// Decode the first frame of a file into a thumbnail and store it (loader task)
+static esp_err_t make_thumbnail(const char *filepath, const char *name, asset_type_t type)
+{
+    animation_decoder_type_t decoder_type;
+    if (!decoder_type_for_asset(type, &decoder_type)) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
     uint8_t *file_data = NULL;
     size_t file_size = 0;
-    esp_err_t err = load_animation_file_from_sd(filepath, &file_data, &file_size);
+    esp_err_t err = load_animation_file_from_sd(filepath, &s_thumb_cancel, false, &file_data, &file_size);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to load file from SD: %s", esp_err_to_name(err));
-        // Mark file as unhealthy (file has issues)
-        if (s_sd_file_list.health_flags && asset_index < s_sd_file_list.count) {
-            s_sd_file_list.health_flags[asset_index] = false;
-            ESP_LOGW(TAG, "Marked file '%s' (index %zu) as unhealthy due to load failure", filename, asset_index);
-        }
         return err;
     }
-
-    buf->file_data = file_data;
-    buf->file_size = file_size;
-    buf->type = type;
-    buf->asset_index = asset_index;
-
-    err = init_animation_decoder_for_buffer(buf, type, file_data, file_size);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize animation decoder '%s': %s", filename, esp_err_to_name(err));
-        // Mark file as unhealthy (file has issues)
-        if (s_sd_file_list.health_flags && asset_index < s_sd_file_list.count) {
-            s_sd_file_list.health_flags[asset_index] = false;
-            ESP_LOGW(TAG, "Marked file '%s' (index %zu) as unhealthy due to decoder initialization failure", filename, asset_index);
-        }
+    if (atomic_load(&s_thumb_cancel)) {
         free(file_data);
-        buf->file_data = NULL;
-        buf->file_size = 0;
-        return err;
+        return LOAD_CANCELLED;
     }
     
-    // Mark file as healthy (file is ok) since loading succeeded
-    if (s_sd_file_list.health_flags && asset_index < s_sd_file_list.count) {
-        s_sd_file_list.health_flags[asset_index] = true;
+    animation_decoder_t *decoder = NULL;
+    animation_decoder_info_t info = {0};
+    uint8_t *canvas = NULL;
+    uint8_t *thumb = NULL;
+    err = animation_decoder_init(&decoder, decoder_type, file_data, file_size);
+    if (err == ESP_OK) {
+        err = animation_decoder_get_info(decoder, &info);
+    }
+    if (err == ESP_OK && (info.canvas_width == 0 || info.canvas_height == 0)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    if (err == ESP_OK) {
+        canvas = (uint8_t *)heap_caps_malloc((size_t)info.canvas_width * info.canvas_height * 4,
+                                             MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        thumb = (uint8_t *)heap_caps_malloc(thumb_cache_thumb_bytes(), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        err = (canvas && thumb) ? ESP_OK : ESP_ERR_NO_MEM;
+    }
+    if (err == ESP_OK) {
+        err = animation_decoder_decode_next(decoder, canvas);
+    }
+    if (err == ESP_OK) {
+        downscale_thumbnail(canvas, (int)info.canvas_width, (int)info.canvas_height, thumb);
+        err = thumb_cache_store(name, (uint32_t)file_size, thumb);
     }
-
-    // Allocate prefetched frame buffer (LCD-sized)
-    buf->prefetched_first_frame = (uint8_t *)malloc(s_frame_buffer_bytes);
-    if (!buf->prefetched_first_frame) {
-        ESP_LOGE(TAG, "Failed to allocate prefetched frame buffer");
-        unload_animation_buffer(buf);
-        return ESP_ERR_NO_MEM;
+    
+    heap_caps_free(thumb);
+    heap_caps_free(canvas);
+    if (decoder) {
+        animation_decoder_unload(&decoder);
     }
-    buf->first_frame_ready = false;
-    buf->decoder_at_frame_1 = false;
-    buf->prefetch_pending = false;
-
-    ESP_LOGI(TAG, "Loaded animation into buffer: %s (index %zu)", filename, asset_index);
+    free(file_data);
+    return err;
+}
 
-    return ESP_OK;
+// Make the thumbnail of the next artwork in play order that has none (loader task, while idle). The
+// job walks the file list once per boot; artworks that fail are left for the next boot.
+static void thumb_job_step(void)
+{
+    char filepath[512];
+    char name[256];
+    asset_type_t type = ASSET_TYPE_WEBP;
+    size_t index;
+    
+    // The cache is looked up outside the mutex: it may be busy serving a thumbnail over HTTP
+    do {
+        if (!buffer_mutex_take()) {
+            return;
+        }
+        index = SIZE_MAX;
+        while (s_thumb_cursor < s_sd_file_list.count && index == SIZE_MAX) {
+            const size_t i = s_thumb_cursor++;
+            const char *filename = s_sd_file_list.filenames[i];
+            if (!s_sd_file_list.animations_dir || !asset_health_is_healthy(i) || strlen(filename) >= sizeof(name)) {
+                continue;
+            }
+            const int ret = snprintf(filepath, sizeof(filepath), "%s/%s", s_sd_file_list.animations_dir, filename);
+            if (ret > 0 && ret < (int)sizeof(filepath)) {
+                strcpy(name, filename);
+                type = s_sd_file_list.types[i];
+                index = i;
+            }
+        }
+        atomic_store(&s_thumb_cancel, s_load_queue_len > 0);
+        xSemaphoreGive(s_buffer_mutex);
+    } while (index != SIZE_MAX && thumb_cache_has(name));
+    
+    if (index == SIZE_MAX) {
+        s_thumb_cursor = SIZE_MAX;
+        ESP_LOGI(TAG, "Thumbnail job finished");
+        return;
+    }
+    const int64_t start_us = esp_timer_get_time();
+    const esp_err_t err = make_thumbnail(filepath, name, type);
+    if (err == LOAD_CANCELLED) {
+        s_thumb_cursor = index;  // Retried on the next idle period
+        ESP_LOGD(TAG, "Thumbnail of %s gave way to a load", name);
+    } else if (err != ESP_OK) {
+        ESP_LOGW(TAG, "No thumbnail for %s: %s", name, esp_err_to_name(err));
+    } else {
+        ESP_LOGD(TAG, "Thumbnail of %s made in %lld ms", name, (long long)((esp_timer_get_time() - start_us) / 1000));
+    }
 }
+#endif
 
 // Pre-decode and upscale the first frame into the prefetched buffer
 static esp_err_t prefetch_first_frame(animation_buffer_t *buf)
@@ -1768,26 +3495,6 @@ static esp_err_t prefetch_first_frame(animation_buffer_t *buf)
     
     // Upscale directly into prefetched buffer using buffer's lookup tables
     const uint8_t *src_for_upscale = decode_buffer;
-    const int target_h = EXAMPLE_LCD_V_RES;
-    const int dst_h = target_h;
-    const int mid_row = dst_h / 2;
-    
-    // Set up upscale parameters
-    s_upscale_src_buffer = src_for_upscale;
-    s_upscale_dst_buffer = buf->prefetched_first_frame;
-    s_upscale_lookup_x = buf->upscale_lookup_x;
-    s_upscale_lookup_y = buf->upscale_lookup_y;
-    s_upscale_src_w = buf->upscale_src_w;
-    s_upscale_src_h = buf->upscale_src_h;
-    s_upscale_main_task = xTaskGetCurrentTaskHandle();
-    
-    s_upscale_worker_top_done = false;
-    s_upscale_worker_bottom_done = false;
-    
-    s_upscale_row_start_top = 0;
-    s_upscale_row_end_top = mid_row;
-    s_upscale_row_start_bottom = mid_row;
-    s_upscale_row_end_bottom = dst_h;
     
     // Safety check: workers must exist for prefetch
     if (!s_upscale_worker_top || !s_upscale_worker_bottom) {
@@ -1795,39 +3502,20 @@ static esp_err_t prefetch_first_frame(animation_buffer_t *buf)
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Memory barrier to ensure all shared variables are visible to worker cores
-    MEMORY_BARRIER();
-    
-    // Notify workers to start processing
-    if (s_upscale_worker_top) {
-        xTaskNotify(s_upscale_worker_top, 1, eSetBits);
-    }
-    if (s_upscale_worker_bottom) {
-        xTaskNotify(s_upscale_worker_bottom, 1, eSetBits);
-    }
-    
-    // Wait for both workers to complete using proper notification API
-    const uint32_t all_bits = (1UL << 0) | (1UL << 1);
-    uint32_t notification_value = 0;
+    // The prefetched frame is copied whole into an LCD buffer, so it carries its own border
+    fill_letterbox_border(buf->prefetched_first_frame, buf);
     
-    while ((notification_value & all_bits) != all_bits) {
-        uint32_t received_bits = 0;
-        if (xTaskNotifyWait(0, UINT32_MAX, &received_bits, pdMS_TO_TICKS(50)) == pdTRUE) {
-            notification_value |= received_bits;
-        } else {
-            // Timeout - yield to allow idle task to reset watchdog
-            taskYIELD();
-        }
-    }
+    // The prefetched frame never carries a transition blend or the OSD; both are applied when it is shown
+    s_upscale_transition = NULL;
+    s_upscale_osd = NULL;
+    s_upscale_color = color_pipeline_begin_frame();
+    s_frame_background = frame_background_begin_frame();
     
-    if (!s_upscale_worker_top_done || !s_upscale_worker_bottom_done) {
+    if (!upscale_frame(buf, src_for_upscale, buf->prefetched_first_frame, EXAMPLE_LCD_V_RES)) {
         ESP_LOGW(TAG, "Upscale workers may not have completed properly during prefetch");
         return ESP_FAIL;
     }
     
-    // Memory barrier to ensure all worker writes are visible
-    MEMORY_BARRIER();
-    
     // Mark first frame as ready
     buf->first_frame_ready = true;
     
@@ -1835,12 +3523,181 @@ static esp_err_t prefetch_first_frame(animation_buffer_t *buf)
     // We don't reset - when render loop starts, it will use prefetched frame 0,
     // then decode frame 1 (which decoder is already positioned for)
     buf->decoder_at_frame_1 = true;
+    buf->next_frame_index = 1;
     
     ESP_LOGD(TAG, "Prefetched first frame for animation index %zu", buf->asset_index);
     
     return ESP_OK;
 }
 
+// Find the animations directory on the SD card and build its randomized file list
+static esp_err_t discover_animation_files(app_lcd_sd_file_list_t *list)
+{
+    const char *sd_root = BSP_SD_MOUNT_POINT;
+    ESP_LOGI(TAG, "Recursively searching for animation files starting from %s...", sd_root);
+    char *found_animations_dir = NULL;
+    esp_err_t find_err = find_animations_directory(sd_root, &found_animations_dir);
+    if (find_err != ESP_OK || !found_animations_dir) {
+        ESP_LOGE(TAG, "Failed to find directory with animation files: %s", esp_err_to_name(find_err));
+        return (find_err == ESP_ERR_NOT_FOUND) ? ESP_ERR_NOT_FOUND : ESP_FAIL;
+    }
+
+    ESP_LOGI(TAG, "Found animations directory: %s", found_animations_dir);
+
+    esp_err_t enum_err = enumerate_animation_files(list, found_animations_dir);
+    free(found_animations_dir);
+    if (enum_err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to enumerate animation files: %s", esp_err_to_name(enum_err));
+        free_sd_file_list(list);
+        return enum_err;
+    }
+
+    // ============================================================================
+    // TEMPORARY DEBUG: Filter file list for testing
+    // TODO: REMOVE THIS CALL AFTER DEBUGGING IS COMPLETE
+    // ============================================================================
+    // filter_file_list_for_debug();
+    // ============================================================================
+
+    if (list->count == 0) {
+        ESP_LOGE(TAG, "No animation files found");
+        return ESP_ERR_NOT_FOUND;
+    }
+    return ESP_OK;
+}
+
+#if CONFIG_P3A_FAST_BOOT_LAST_ASSET
+// Load the artwork that was on screen before the last reboot into the front buffer, skipping the
+// directory scan. The file list is built by the loader task once the first frame is up.
+static bool start_from_last_asset(void)
+{
+    // The gallery pages through the file list, so it has to wait for enumeration
+    if (s_gallery_requested_grid >= 2) {
+        return false;
+    }
+
+    nvs_handle_t nvs_handle;
+    if (nvs_open(LAST_ASSET_NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return false;
+    }
+    size_t required_size = sizeof(s_last_asset_path);
+    esp_err_t err = nvs_get_str(nvs_handle, LAST_ASSET_NVS_KEY, s_last_asset_path, &required_size);
+    nvs_close(nvs_handle);
+    if (err != ESP_OK) {
+        s_last_asset_path[0] = '\0';
+        return false;
+    }
+
+    struct stat st;
+    if (stat(s_last_asset_path, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ESP_LOGI(TAG, "Last artwork %s is gone, scanning the SD card", s_last_asset_path);
+        s_last_asset_path[0] = '\0';
+        return false;
+    }
+
+    const char *name = strrchr(s_last_asset_path, '/');
+    name = name ? name + 1 : s_last_asset_path;
+    err = load_animation_path_into_buffer(s_last_asset_path, get_asset_type(name), SIZE_MAX, s_front_buffer, NULL);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to start from last artwork: %s", esp_err_to_name(err));
+        s_last_asset_path[0] = '\0';
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Starting from last artwork %s, file list deferred", s_last_asset_path);
+    s_enumeration_pending = true;
+    return true;
+}
+
+// Build the file list in the background and publish it, pointing the front buffer at its entry
+static void finish_deferred_enumeration(void)
+{
+    app_lcd_sd_file_list_t list = {0};
+    esp_err_t err = discover_animation_files(&list);
+    s_enumeration_pending = false;
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "No file list (%s), staying on the start-up artwork", esp_err_to_name(err));
+        return;
+    }
+
+    // The start-up artwork may not be in the list (another directory was picked); it then stays
+    // unlisted at SIZE_MAX and navigation starts from the beginning of the list
+    size_t match = 0;
+    bool found = false;
+    for (size_t i = 0; i < list.count && !found; i++) {
+        char filepath[512];
+        int ret = snprintf(filepath, sizeof(filepath), "%s/%s", list.animations_dir, list.filenames[i]);
+        if (ret > 0 && ret < (int)sizeof(filepath) && strcmp(filepath, s_last_asset_path) == 0) {
+            match = i;
+            found = true;
+        }
+    }
+
+    if (!buffer_mutex_take()) {
+        free_sd_file_list(&list);
+        return;
+    }
+    s_sd_file_list.filenames = list.filenames;
+    s_sd_file_list.types = list.types;
+    asset_health_reset(list.count);
+    s_sd_file_list.animations_dir = list.animations_dir;
+    s_sd_file_list.current_index = match;
+    // Count last: callers that check it before taking the mutex only ever see a complete list
+    s_sd_file_list.count = list.count;
+    if (found && s_front_buffer->asset_index == SIZE_MAX) {
+        s_front_buffer->asset_index = match;
+    }
+    // A gallery requested while the list was missing fell back to single playback
+    if (s_gallery_requested_grid >= 2) {
+        player_state_update(0, 0, PLAYER_GALLERY_RELOAD);
+    }
+    xSemaphoreGive(s_buffer_mutex);
+
+    boot_profile_mark("enumerated");
+    if (found) {
+        ESP_LOGI(TAG, "File list ready, start-up artwork is index %zu of %zu", match, list.count);
+    } else {
+        ESP_LOGW(TAG, "File list ready (%zu files) without the start-up artwork %s", list.count, s_last_asset_path);
+    }
+}
+
+// Store the path of the artwork on screen so the next boot can start from it
+static void save_last_asset_path(void)
+{
+    char filepath[sizeof(s_last_asset_path)];
+    bool have_path = false;
+    if (!buffer_mutex_take()) {
+        return;
+    }
+    if (s_front_buffer->ready && s_gallery_grid == 0 && s_front_buffer->asset_index < s_sd_file_list.count &&
+        s_sd_file_list.animations_dir) {
+        int ret = snprintf(filepath, sizeof(filepath), "%s/%s", s_sd_file_list.animations_dir,
+                           s_sd_file_list.filenames[s_front_buffer->asset_index]);
+        have_path = (ret > 0 && ret < (int)sizeof(filepath));
+    }
+    xSemaphoreGive(s_buffer_mutex);
+    if (!have_path || strcmp(filepath, s_last_asset_path) == 0) {
+        return;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t err = nvs_open(LAST_ASSET_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (err == ESP_OK) {
+        err = nvs_set_str(nvs_handle, LAST_ASSET_NVS_KEY, filepath);
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs_handle);
+        }
+        nvs_close(nvs_handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save last artwork: %s", esp_err_to_name(err));
+        return;
+    }
+    memcpy(s_last_asset_path, filepath, sizeof(s_last_asset_path));
+    ESP_LOGD(TAG, "Saved start-up artwork %s", s_last_asset_path);
+}
+#endif
+
 esp_err_t animation_player_init(esp_lcd_panel_handle_t display_handle,
                                  uint8_t **lcd_buffers,
                                  uint8_t buffer_count,
@@ -1878,6 +3735,20 @@ esp_err_t animation_player_init(esp_lcd_panel_handle_t display_handle,
         ESP_LOGW(TAG, "Single LCD frame buffer in use; tearing may occur");
     }
 
+    if (s_render_wake_sem == NULL) {
+        s_render_wake_sem = xSemaphoreCreateBinary();
+        if (s_render_wake_sem == NULL) {
+            ESP_LOGE(TAG, "Failed to allocate render wake semaphore");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // The OSD is optional: playback continues without overlays if the atlas cannot be built
+    esp_err_t osd_err = osd_init(EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES, EXAMPLE_LCD_BIT_PER_PIXEL / 8);
+    if (osd_err != ESP_OK) {
+        ESP_LOGW(TAG, "OSD unavailable: %s", esp_err_to_name(osd_err));
+    }
+
     ESP_LOGI(TAG, "Mounting SD card...");
     esp_err_t sd_err = bsp_sdcard_mount();
     if (sd_err != ESP_OK) {
@@ -1886,40 +3757,12 @@ esp_err_t animation_player_init(esp_lcd_panel_handle_t display_handle,
     }
     s_sd_mounted = true;
 
-    const char *sd_root = BSP_SD_MOUNT_POINT;
-    ESP_LOGI(TAG, "Recursively searching for animation files starting from %s...", sd_root);
-    char *found_animations_dir = NULL;
-    esp_err_t find_err = find_animations_directory(sd_root, &found_animations_dir);
-    if (find_err != ESP_OK || !found_animations_dir) {
-        ESP_LOGE(TAG, "Failed to find directory with animation files: %s", esp_err_to_name(find_err));
-        bsp_sdcard_unmount();
-        s_sd_mounted = false;
-        return (find_err == ESP_ERR_NOT_FOUND) ? ESP_ERR_NOT_FOUND : ESP_FAIL;
-    }
-
-    ESP_LOGI(TAG, "Found animations directory: %s", found_animations_dir);
-
-    esp_err_t enum_err = enumerate_animation_files(found_animations_dir);
-    free(found_animations_dir);
-    if (enum_err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to enumerate animation files: %s", esp_err_to_name(enum_err));
-        bsp_sdcard_unmount();
-        s_sd_mounted = false;
-        return enum_err;
-    }
-
-    // ============================================================================
-    // TEMPORARY DEBUG: Filter file list for testing
-    // TODO: REMOVE THIS CALL AFTER DEBUGGING IS COMPLETE
-    // ============================================================================
-    // filter_file_list_for_debug();
-    // ============================================================================
+    boot_profile_mark("sd_mounted");
 
-    if (s_sd_file_list.count == 0) {
-        ESP_LOGE(TAG, "No animation files found");
-        bsp_sdcard_unmount();
-        s_sd_mounted = false;
-        return ESP_ERR_NOT_FOUND;
+    // Display settings may reference files on the SD card (background image)
+    esp_err_t cfg_err = animation_player_apply_config();
+    if (cfg_err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to apply display config: %s", esp_err_to_name(cfg_err));
     }
 
     // Initialize double buffer system
@@ -1941,83 +3784,85 @@ esp_err_t animation_player_init(esp_lcd_panel_handle_t display_handle,
         return ESP_ERR_NO_MEM;
     }
 
-    // Initialize buffers to zero
-    memset(&s_front_buffer, 0, sizeof(s_front_buffer));
-    memset(&s_back_buffer, 0, sizeof(s_back_buffer));
+    // Initialize slots to zero; slot 0 receives the first artwork and goes on screen
+    memset(s_slots, 0, sizeof(s_slots));
+    for (int i = 1; i < ANIM_SLOT_COUNT; ++i) {
+        s_slots[i].anim.asset_index = SIZE_MAX;
+        atomic_store(&s_slots[i].state, SLOT_EMPTY);
+    }
+    atomic_store(&s_slots[0].state, SLOT_PLAYING);
+    atomic_store(&s_front_buffer, &s_slots[0].anim);
+    player_state_update(0, PLAYER_SWAP_REQUESTED | PLAYER_SWAP_AT_LOOP_END, 0);
+    s_load_queue_len = 0;
+    s_loading_asset = SIZE_MAX;
 
-    // Load the first healthy animation from the randomized list into front buffer synchronously
-    size_t start_index = 0;
-    // Find first healthy file
-    if (s_sd_file_list.health_flags) {
-        bool found_healthy = false;
-        for (size_t i = 0; i < s_sd_file_list.count; i++) {
-            if (s_sd_file_list.health_flags[i]) {
-                start_index = i;
-                found_healthy = true;
-                break;
-            }
-        }
-        if (!found_healthy) {
-            ESP_LOGE(TAG, "No healthy animation files available at startup");
+    bool started_from_cache = false;
+#if CONFIG_P3A_FAST_BOOT_LAST_ASSET
+    started_from_cache = start_from_last_asset();
+#endif
+
+    if (!started_from_cache) {
+        esp_err_t list_err = discover_animation_files(&s_sd_file_list);
+        if (list_err != ESP_OK) {
             vSemaphoreDelete(s_loader_sem);
             s_loader_sem = NULL;
             vSemaphoreDelete(s_buffer_mutex);
             s_buffer_mutex = NULL;
             bsp_sdcard_unmount();
             s_sd_mounted = false;
-            return ESP_ERR_NOT_FOUND;
+            return list_err;
         }
-    }
-    
-    esp_err_t load_err = load_animation_into_buffer(start_index, &s_front_buffer);
-    if (load_err != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to load animation at index %zu, trying other healthy files...", start_index);
-        // Try other healthy animations sequentially as fallback
-        bool found_any = false;
-        for (size_t i = 0; i < s_sd_file_list.count; i++) {
-            // Skip if not healthy (if health flags available)
-            if (s_sd_file_list.health_flags && !s_sd_file_list.health_flags[i]) {
-                continue;
-            }
-            if (i == start_index) {
-                continue;  // Already tried this one
+        boot_profile_mark("enumerated");
+
+        asset_health_reset(s_sd_file_list.count);
+
+        // Load the first animation from the randomized list into front buffer synchronously
+        size_t start_index = 0;
+        
+        esp_err_t load_err = load_animation_into_buffer(start_index, s_front_buffer, NULL);
+        if (load_err != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to load animation at index %zu, trying other healthy files...", start_index);
+            // Try other healthy animations sequentially as fallback
+            bool found_any = false;
+            for (size_t i = 0; i < s_sd_file_list.count; i++) {
+                // Skip files that have already failed
+                if (!asset_health_is_healthy(i)) {
+                    continue;
+                }
+                if (i == start_index) {
+                    continue;  // Already tried this one
+                }
+                load_err = load_animation_into_buffer(i, s_front_buffer, NULL);
+                if (load_err == ESP_OK) {
+                    ESP_LOGI(TAG, "Successfully loaded animation at index %zu", i);
+                    found_any = true;
+                    break;
+                }
             }
-            load_err = load_animation_into_buffer(i, &s_front_buffer);
-            if (load_err == ESP_OK) {
-                ESP_LOGI(TAG, "Successfully loaded animation at index %zu", i);
-                found_any = true;
-                break;
+            if (!found_any || load_err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to load any healthy animation file");
+                vSemaphoreDelete(s_loader_sem);
+                s_loader_sem = NULL;
+                vSemaphoreDelete(s_buffer_mutex);
+                s_buffer_mutex = NULL;
+                bsp_sdcard_unmount();
+                s_sd_mounted = false;
+                return load_err;
             }
+        } else {
+            ESP_LOGI(TAG, "Loaded animation at index %zu to start playback", start_index);
         }
-        if (!found_any || load_err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to load any healthy animation file");
-            vSemaphoreDelete(s_loader_sem);
-            s_loader_sem = NULL;
-            vSemaphoreDelete(s_buffer_mutex);
-            s_buffer_mutex = NULL;
-            bsp_sdcard_unmount();
-            s_sd_mounted = false;
-            return load_err;
-        }
-    } else {
-        ESP_LOGI(TAG, "Loaded animation at index %zu to start playback", start_index);
     }
+    boot_profile_mark("first_asset_loaded");
     
     // Create upscale workers BEFORE prefetch (prefetch needs them)
     if (s_upscale_worker_top == NULL) {
-        const BaseType_t worker_top_created = xTaskCreatePinnedToCore(
-            upscale_worker_top_task,
-            "upscale_top",
-            2048,
-            NULL,
-            CONFIG_P3A_RENDER_TASK_PRIORITY,
-            &s_upscale_worker_top,
-            0
-        );
+        const BaseType_t worker_top_created = task_topology_create(
+            TASK_TOPOLOGY_UPSCALE_TOP, upscale_worker_top_task, NULL, &s_upscale_worker_top);
         
         if (worker_top_created != pdPASS) {
             ESP_LOGE(TAG, "Failed to create top upscale worker task");
-            unload_animation_buffer(&s_front_buffer);
+            unload_animation_buffer(s_front_buffer);
             vSemaphoreDelete(s_loader_sem);
             s_loader_sem = NULL;
             vSemaphoreDelete(s_buffer_mutex);
@@ -2029,19 +3874,12 @@ esp_err_t animation_player_init(esp_lcd_panel_handle_t display_handle,
     }
     
     if (s_upscale_worker_bottom == NULL) {
-        const BaseType_t worker_bottom_created = xTaskCreatePinnedToCore(
-            upscale_worker_bottom_task,
-            "upscale_bottom",
-            2048,
-            NULL,
-            CONFIG_P3A_RENDER_TASK_PRIORITY,
-            &s_upscale_worker_bottom,
-            1
-        );
+        const BaseType_t worker_bottom_created = task_topology_create(
+            TASK_TOPOLOGY_UPSCALE_BOTTOM, upscale_worker_bottom_task, NULL, &s_upscale_worker_bottom);
         
         if (worker_bottom_created != pdPASS) {
             ESP_LOGE(TAG, "Failed to create bottom upscale worker task");
-            unload_animation_buffer(&s_front_buffer);
+            unload_animation_buffer(s_front_buffer);
             vSemaphoreDelete(s_loader_sem);
             s_loader_sem = NULL;
             vSemaphoreDelete(s_buffer_mutex);
@@ -2052,32 +3890,37 @@ esp_err_t animation_player_init(esp_lcd_panel_handle_t display_handle,
         }
     }
     
-    ESP_LOGI(TAG, "Created parallel upscaling worker tasks (CPU0: top, CPU1: bottom)");
+    ESP_LOGI(TAG, "Created parallel upscaling worker tasks (top: core %d, bottom: core %d)",
+             task_topology_get(TASK_TOPOLOGY_UPSCALE_TOP)->core, task_topology_get(TASK_TOPOLOGY_UPSCALE_BOTTOM)->core);
+    
+    // Outgoing frame snapshot for animation change transitions (optional, playback works without it)
+    if (P3A_TRANSITION_TYPE != FRAME_TRANSITION_NONE && s_transition_from_frame == NULL) {
+        s_transition_from_frame = (uint8_t *)heap_caps_malloc(s_frame_buffer_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_transition_from_frame) {
+            ESP_LOGW(TAG, "Failed to allocate transition frame buffer, animation changes will cut");
+        }
+    }
     
     // Prefetch first frame of front buffer (now that workers exist)
     // This is done synchronously during init, so it's safe
-    esp_err_t prefetch_err = prefetch_first_frame(&s_front_buffer);
+    PERF_TRACE_BEGIN(PERF_TRACE_PREFETCH);
+    esp_err_t prefetch_err = prefetch_first_frame(s_front_buffer);
+    PERF_TRACE_END(PERF_TRACE_PREFETCH);
     if (prefetch_err != ESP_OK) {
         ESP_LOGW(TAG, "Failed to prefetch first frame during init: %s", esp_err_to_name(prefetch_err));
     }
     
     // Mark front buffer as ready
-    s_front_buffer.ready = true;
-    s_front_buffer.prefetch_pending = false;
-    
-    // Create loader task (back buffer will remain empty until swap gesture)
-    const BaseType_t loader_created = xTaskCreate(
-        animation_loader_task,
-        "anim_loader",
-        4096,
-        NULL,
-        CONFIG_P3A_RENDER_TASK_PRIORITY - 1,  // Lower priority than render task
-        &s_loader_task
-    );
+    s_front_buffer->ready = true;
+    atomic_store(&s_front_shown_since_us, esp_timer_get_time());
+    
+    // Create loader task (it preloads the next artwork when there is a spare slot)
+    const BaseType_t loader_created = task_topology_create(
+        TASK_TOPOLOGY_LOADER, animation_loader_task, NULL, &s_loader_task);
     
     if (loader_created != pdPASS) {
         ESP_LOGE(TAG, "Failed to create loader task");
-        unload_animation_buffer(&s_front_buffer);
+        unload_animation_buffer(s_front_buffer);
         vSemaphoreDelete(s_loader_sem);
         s_loader_sem = NULL;
         vSemaphoreDelete(s_buffer_mutex);
@@ -2101,98 +3944,449 @@ esp_err_t animation_player_load_asset(const char *filepath)
 
 void animation_player_set_paused(bool paused)
 {
-    if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-        bool changed = (s_anim_paused != paused);
-        s_anim_paused = paused;
-        xSemaphoreGive(s_buffer_mutex);
-        
-        if (changed) {
-            ESP_LOGI(TAG, "Animation %s", paused ? "paused" : "resumed");
-        }
+    const unsigned prev_state = paused ? atomic_fetch_or(&s_player_state, PLAYER_PAUSED)
+                                       : atomic_fetch_and(&s_player_state, ~PLAYER_PAUSED);
+    const bool changed = ((prev_state & PLAYER_PAUSED) != 0) != paused;
+    
+    if (changed) {
+        ESP_LOGI(TAG, "Animation %s", paused ? "paused" : "resumed");
+        osd_set_icon(OSD_ICON_PAUSED, paused);
     }
 }
 
 void animation_player_toggle_pause(void)
 {
-    bool paused;
-    if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-        s_anim_paused = !s_anim_paused;
-        paused = s_anim_paused;
-        xSemaphoreGive(s_buffer_mutex);
-        
-        ESP_LOGI(TAG, "Animation %s", paused ? "paused" : "resumed");
-    }
+    const bool paused = (atomic_fetch_xor(&s_player_state, PLAYER_PAUSED) & PLAYER_PAUSED) == 0;
+    
+    ESP_LOGI(TAG, "Animation %s", paused ? "paused" : "resumed");
+    osd_set_icon(OSD_ICON_PAUSED, paused);
 }
 
 bool animation_player_is_paused(void)
 {
-    bool paused = false;
-    if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-        paused = s_anim_paused;
-        xSemaphoreGive(s_buffer_mutex);
+    return (player_state_get() & PLAYER_PAUSED) != 0;
+}
+
+// Artwork navigation steps from (caller holds s_buffer_mutex): the one the user is already waiting
+// for, else the one on screen
+static size_t navigation_origin(void)
+{
+    size_t index = s_front_buffer->ready ? s_front_buffer->asset_index : 0;
+    if ((player_state_get() & (PLAYER_SWAP_REQUESTED | PLAYER_SWAP_AT_LOOP_END)) == PLAYER_SWAP_REQUESTED) {
+        index = swap_params_load().target_index;
     }
-    return paused;
+    return (index < s_sd_file_list.count) ? index : 0;
 }
 
-void animation_player_cycle_animation(bool forward)
+// Move steps artworks through the play order, positive forward, skipping quarantined files
+static size_t step_asset_index(size_t index, int steps)
+{
+    for (; steps > 0; --steps) {
+        index = get_next_asset_index(index);
+    }
+    for (; steps < 0; ++steps) {
+        index = get_previous_asset_index(index);
+    }
+    return index;
+}
+
+// Queue loading the artwork steps away (positive forward) into a free slot. With at_loop_end the render
+// task keeps it preloaded until the swap is due (see scheduled_swap_due()). Repeated user changes step
+// on from the pending target and cancel the loads they overtake.
+// Set swap requested and queue the load unless the target is already loaded or on its way
+// (s_buffer_mutex held; wake the loader after releasing it)
+static void request_swap_locked(size_t target_index, int steps, bool at_loop_end, int64_t not_before_us,
+                                int64_t deadline_us)
+{
+    const swap_params_t params = {
+        .target_index = target_index,
+        .not_before_us = not_before_us,
+        .deadline_us = deadline_us,
+        .requested_us = at_loop_end ? 0 : esp_timer_get_time(),
+        .steps = steps,
+    };
+    swap_params_store(&params);
+    player_state_update(0, PLAYER_SWAP_AT_LOOP_END,
+                        PLAYER_SWAP_REQUESTED | (at_loop_end ? PLAYER_SWAP_AT_LOOP_END : 0));
+    
+    const load_priority_t priority = at_loop_end ? LOAD_PRIORITY_SCHEDULED : LOAD_PRIORITY_SHOW;
+    load_queue_retarget(target_index);
+    anim_slot_t *loaded = find_loaded_slot(target_index);
+    if (loaded) {
+        loaded->priority = priority;
+    } else if (!asset_pending_or_loaded(target_index)) {
+        load_queue_push(target_index, priority);
+    }
+#if CONFIG_P3A_SYNC_WALL_ENABLE && CONFIG_P3A_SYNC_WALL_LEADER
+    if (at_loop_end) {
+        sync_wall_announce_index(target_index, not_before_us, deadline_us);
+    } else {
+        sync_wall_announce_index(target_index, params.requested_us, params.requested_us);
+    }
+#endif
+}
+
+static esp_err_t queue_animation_change(int steps, bool at_loop_end, int64_t not_before_us, int64_t deadline_us)
 {
     if (s_sd_file_list.count == 0) {
         ESP_LOGW(TAG, "No animations available to cycle");
-        return;
+        return ESP_ERR_NOT_FOUND;
     }
 
-    if (s_buffer_mutex && xSemaphoreTake(s_buffer_mutex, portMAX_DELAY) == pdTRUE) {
-        // If swap is already in progress (swap requested, loader busy, or prefetch pending), ignore
-        if (s_swap_requested || s_loader_busy || s_back_buffer.prefetch_pending) {
-            ESP_LOGW(TAG, "Animation change request ignored: swap already in progress");
+    if (buffer_mutex_take()) {
+        // In gallery mode a cycle (or a fling of any length) turns the page: the render task reloads every tile
+        if (s_gallery_requested_grid >= 2) {
+            if (!(player_state_get() & PLAYER_GALLERY_RELOAD)) {
+                size_t first = s_gallery_next_index;
+                if (steps < 0) {
+                    first = s_gallery_first_index;
+                    for (int i = 0; i < s_gallery_requested_grid * s_gallery_requested_grid; ++i) {
+                        first = get_previous_asset_index(first);
+                    }
+                }
+                s_gallery_first_index = first;
+                player_state_update(0, 0, PLAYER_GALLERY_RELOAD);
+            }
             xSemaphoreGive(s_buffer_mutex);
-            return;
+            return ESP_OK;
         }
         
-        // Compute next or previous animation index on demand
-        size_t current_index = s_front_buffer.ready ? s_front_buffer.asset_index : 0;
-        size_t target_index = forward ? get_next_asset_index(current_index) : get_previous_asset_index(current_index);
-        
-        // Check if no healthy files are available (target_index == current_index means no healthy file found)
-        if (target_index == current_index && s_sd_file_list.health_flags) {
-            // Check if there are any healthy files at all
-            bool any_healthy = false;
-            for (size_t i = 0; i < s_sd_file_list.count; i++) {
-                if (s_sd_file_list.health_flags[i]) {
-                    any_healthy = true;
-                    break;
-                }
+        // A user change while the next artwork is preloaded for a scheduled swap shows it right away
+        const unsigned scheduled = PLAYER_SWAP_REQUESTED | PLAYER_SWAP_AT_LOOP_END;
+        if (steps == 1 && !at_loop_end && (player_state_get() & scheduled) == scheduled) {
+            swap_params_t params = swap_params_load();
+            params.requested_us = esp_timer_get_time();
+            params.steps = 1;
+            swap_params_store(&params);
+            // Unless the render task swapped in the meantime, which is handled below like any new request
+            if ((player_state_update(scheduled, PLAYER_SWAP_AT_LOOP_END, 0) & scheduled) == scheduled) {
+#if CONFIG_P3A_SYNC_WALL_ENABLE && CONFIG_P3A_SYNC_WALL_LEADER
+                sync_wall_announce_index(params.target_index, params.requested_us, params.requested_us);
+#endif
+                xSemaphoreGive(s_buffer_mutex);
+                xSemaphoreGive(s_render_wake_sem);
+                ESP_LOGI(TAG, "Scheduled animation change brought forward");
+                return ESP_OK;
             }
-            if (!any_healthy) {
+        }
+        
+        // A scheduled change never overrides a pending one
+        const unsigned state = player_state_get();
+        if (at_loop_end && (state & PLAYER_SWAP_REQUESTED)) {
+            ESP_LOGW(TAG, "Scheduled animation change ignored: swap already in progress");
+            xSemaphoreGive(s_buffer_mutex);
+            return ESP_ERR_INVALID_STATE;
+        }
+        
+        const size_t current_index = navigation_origin();
+        const size_t target_index = step_asset_index(current_index, steps);
+        
+        // Landing where we started: no healthy file at all, or a whole number of laps (a fling of a multiple
+        // of the healthy count, or a single healthy file). The artwork is already shown or on its way.
+        if (target_index == current_index) {
+            if (asset_health_healthy_count() == 0) {
                 ESP_LOGW(TAG, "No healthy animation files available. Cannot cycle animation.");
                 xSemaphoreGive(s_buffer_mutex);
-                return;
+                return ESP_ERR_NOT_FOUND;
+            }
+            if (s_front_buffer->ready || (state & PLAYER_SWAP_REQUESTED)) {
+                xSemaphoreGive(s_buffer_mutex);
+                ESP_LOGD(TAG, "Animation change by %+d lands on index %zu again, nothing to do", steps, target_index);
+                return ESP_OK;
             }
-            // If we have healthy files but target_index == current_index, it means current is the only healthy one
-            // This is fine, we can still try to swap (though it will likely fail if current is already loaded)
         }
         
-        // Set swap requested and queue loader with target index
-        s_next_asset_index = target_index;
-        s_swap_requested = true;
-        
+        request_swap_locked(target_index, steps, at_loop_end, not_before_us, deadline_us);
         xSemaphoreGive(s_buffer_mutex);
         
         // Trigger loader task to load target animation
         if (s_loader_sem) {
             xSemaphoreGive(s_loader_sem);
         }
+        // A user change wakes the render task, so its feedback does not wait out the frame delay
+        if (!at_loop_end && s_render_wake_sem) {
+            xSemaphoreGive(s_render_wake_sem);
+        }
         
-        ESP_LOGI(TAG, "Queued animation load to '%s' (index %zu)", 
-                 s_sd_file_list.filenames[target_index], target_index);
+        ESP_LOGI(TAG, "Queued animation load to '%s' (index %zu)%s", 
+                 s_sd_file_list.filenames[target_index], target_index, at_loop_end ? ", swap at loop end" : "");
+        return ESP_OK;
+    }
+    return ESP_ERR_INVALID_STATE;
+}
+
+void animation_player_cycle_animation(bool forward)
+{
+    queue_animation_change(forward ? 1 : -1, false, 0, 0);
+}
+
+esp_err_t animation_player_skip(int steps)
+{
+    if (steps == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return queue_animation_change(steps, false, 0, 0);
+}
+
+esp_err_t animation_player_preload_skip(int steps)
+{
+    if (steps == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!buffer_mutex_take()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_sd_file_list.count == 0 || s_gallery_requested_grid >= 2) {
+        xSemaphoreGive(s_buffer_mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    const size_t origin_index = navigation_origin();
+    const size_t target_index = step_asset_index(origin_index, steps);
+    if (target_index == origin_index) {
+        // A whole number of laps: the fling would change nothing
+        xSemaphoreGive(s_buffer_mutex);
+        return ESP_OK;
+    }
+    
+    // Only the latest prediction is worth loading: drop the earlier ones, queued or in flight
+    size_t kept = 0;
+    for (size_t i = 0; i < s_load_queue_len; ++i) {
+        if (s_load_queue[i].priority != LOAD_PRIORITY_SPECULATIVE || s_load_queue[i].asset_index == target_index) {
+            s_load_queue[kept++] = s_load_queue[i];
+        }
+    }
+    s_load_queue_len = kept;
+    if (s_loading_asset != SIZE_MAX && s_loading_asset != target_index &&
+        s_loading_priority == LOAD_PRIORITY_SPECULATIVE) {
+        atomic_store(&s_load_cancel, true);
+    }
+    
+    anim_slot_t *loaded = find_loaded_slot(target_index);
+    if (loaded) {
+        if (loaded->priority < LOAD_PRIORITY_SPECULATIVE) {
+            loaded->priority = LOAD_PRIORITY_SPECULATIVE;
+        }
+    } else {
+        load_queue_push(target_index, LOAD_PRIORITY_SPECULATIVE);
+    }
+    xSemaphoreGive(s_buffer_mutex);
+    
+    if (s_loader_sem) {
+        xSemaphoreGive(s_loader_sem);
+    }
+    ESP_LOGD(TAG, "Speculative load of index %zu (%+d)", target_index, steps);
+    return ESP_OK;
+}
+
+esp_err_t animation_player_schedule_cycle(int64_t not_before_us, int64_t deadline_us)
+{
+    if (deadline_us < not_before_us) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return queue_animation_change(1, true, not_before_us, deadline_us);
+}
+
+esp_err_t animation_player_schedule_asset(size_t index, int64_t not_before_us, int64_t deadline_us)
+{
+    if (deadline_us < not_before_us) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!buffer_mutex_take()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t err = ESP_OK;
+    const unsigned state = player_state_get();
+    if (index >= s_sd_file_list.count) {
+        err = ESP_ERR_NOT_FOUND;
+    } else if (s_gallery_requested_grid >= 2) {
+        err = ESP_ERR_INVALID_STATE;
+    } else if (s_front_buffer->ready && s_front_buffer->asset_index == index) {
+        // Already on screen: drop a change to anything else
+        player_state_update(0, PLAYER_SWAP_REQUESTED | PLAYER_SWAP_AT_LOOP_END, 0);
+    } else if ((state & PLAYER_SWAP_REQUESTED) && swap_params_load().target_index == index) {
+        // Already on its way: only move the swap window
+        swap_params_t params = swap_params_load();
+        params.not_before_us = not_before_us;
+        params.deadline_us = deadline_us;
+        swap_params_store(&params);
+    } else {
+        request_swap_locked(index, 1, true, not_before_us, deadline_us);
+    }
+    xSemaphoreGive(s_buffer_mutex);
+    if (s_loader_sem) {
+        xSemaphoreGive(s_loader_sem);
+    }
+    return err;
+}
+
+esp_err_t animation_player_scrub_begin(void)
+{
+    if (!buffer_mutex_take()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const bool gallery = s_gallery_requested_grid >= 2;
+    if (!gallery) {
+        atomic_store(&s_scrub_permille, 0);
+        player_state_update(0, 0, PLAYER_SCRUBBING);
+    }
+    xSemaphoreGive(s_buffer_mutex);
+    if (gallery) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ESP_LOGI(TAG, "Scrubbing started");
+    return ESP_OK;
+}
+
+void animation_player_scrub_to(int permille)
+{
+    atomic_store(&s_scrub_permille, permille);
+}
+
+void animation_player_scrub_end(void)
+{
+    if (player_state_update(PLAYER_SCRUBBING, PLAYER_SCRUBBING, 0) & PLAYER_SCRUBBING) {
+        ESP_LOGI(TAG, "Scrubbing ended");
+    }
+}
+
+int64_t animation_player_get_shown_since_us(void)
+{
+    return atomic_load(&s_front_shown_since_us);
+}
+
+uint32_t animation_player_get_loop_duration_ms(void)
+{
+    // Slots are static and the loop duration is a plain field, so a pointer that has just been retired
+    // reads at worst the previous artwork's value
+    const animation_buffer_t *front = atomic_load(&s_front_buffer);
+    return front->ready ? front->decoder_info.loop_duration_ms : 0;
+}
+
+esp_err_t animation_player_get_asset_name(size_t index, char *out, size_t len)
+{
+    if (!out || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!buffer_mutex_take()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    if (index < s_sd_file_list.count) {
+        snprintf(out, len, "%s", s_sd_file_list.filenames[index]);
+        err = ESP_OK;
+    }
+    xSemaphoreGive(s_buffer_mutex);
+    return err;
+}
+
+// Decode the first frame of an image file into a newly allocated RGBA buffer
+static esp_err_t decode_background_image(const char *path, uint8_t **rgba_out, int *w_out, int *h_out)
+{
+    animation_decoder_type_t decoder_type;
+    if (!decoder_type_for_asset(get_asset_type(path), &decoder_type)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    uint8_t *data = NULL;
+    size_t size = 0;
+    esp_err_t err = load_animation_file_from_sd(path, NULL, false, &data, &size);
+    if (err != ESP_OK) {
+        return err;
+    }
+    
+    animation_decoder_t *decoder = NULL;
+    animation_decoder_info_t info = {0};
+    uint8_t *rgba = NULL;
+    err = animation_decoder_init(&decoder, decoder_type, data, size);
+    if (err == ESP_OK) {
+        err = animation_decoder_get_info(decoder, &info);
+    }
+    if (err == ESP_OK) {
+        rgba = (uint8_t *)heap_caps_malloc((size_t)info.canvas_width * info.canvas_height * 4,
+                                           MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        err = rgba ? animation_decoder_decode_next(decoder, rgba) : ESP_ERR_NO_MEM;
+    }
+    animation_decoder_unload(&decoder);
+    free(data);
+    
+    if (err != ESP_OK) {
+        heap_caps_free(rgba);
+        return err;
+    }
+    *rgba_out = rgba;
+    *w_out = (int)info.canvas_width;
+    *h_out = (int)info.canvas_height;
+    return ESP_OK;
+}
+
+esp_err_t animation_player_set_gallery_grid(int grid)
+{
+    if (grid < 0 || grid > GALLERY_MAX_GRID) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (grid == 1) {
+        grid = 0;
+    }
+    // Before the player is running there is nothing to race with
+    const bool locked = buffer_mutex_take();
+    if (grid != s_gallery_requested_grid) {
+        s_gallery_requested_grid = grid;
+        player_state_update(0, 0, PLAYER_GALLERY_RELOAD);
+    }
+    if (locked) {
+        xSemaphoreGive(s_buffer_mutex);
+    }
+    return ESP_OK;
+}
+
+int animation_player_get_gallery_grid(void)
+{
+    return (s_gallery_grid > 0) ? s_gallery_grid : 1;
+}
+
+esp_err_t animation_player_apply_config(void)
+{
+    color_pipeline_config_t color_cfg;
+    frame_background_config_t bg_cfg;
+    int gallery_grid = CONFIG_P3A_GALLERY_GRID;
+    color_pipeline_default_config(&color_cfg);
+    frame_background_default_config(&bg_cfg);
+    
+    cJSON *cfg = NULL;
+    esp_err_t err = config_store_load(&cfg);
+    if (err == ESP_OK) {
+        color_pipeline_config_from_json(cfg, &color_cfg);
+        frame_background_config_from_json(cfg, &bg_cfg);
+        const cJSON *grid = cJSON_GetObjectItemCaseSensitive(cfg, "gallery_grid");
+        if (cJSON_IsNumber(grid) && grid->valueint >= 1 && grid->valueint <= GALLERY_MAX_GRID) {
+            gallery_grid = grid->valueint;
+        }
+        cJSON_Delete(cfg);
+    } else {
+        ESP_LOGW(TAG, "Config unavailable (%s), using display defaults", esp_err_to_name(err));
+    }
+    
+    uint8_t *bg_image = NULL;
+    int bg_w = 0, bg_h = 0;
+    if (bg_cfg.mode == FRAME_BACKGROUND_IMAGE && bg_cfg.image_path[0]) {
+        esp_err_t img_err = decode_background_image(bg_cfg.image_path, &bg_image, &bg_w, &bg_h);
+        if (img_err != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to load background image %s: %s", bg_cfg.image_path, esp_err_to_name(img_err));
+        }
     }
+    esp_err_t bg_err = frame_background_configure(&bg_cfg, bg_image, bg_w, bg_h, EXAMPLE_LCD_H_RES, EXAMPLE_LCD_V_RES);
+    heap_caps_free(bg_image);
+    
+    (void)animation_player_set_gallery_grid(gallery_grid);
+    
+    err = color_pipeline_configure(&color_cfg);
+    return (err != ESP_OK) ? err : bg_err;
 }
 
 esp_err_t animation_player_start(void)
 {
     if (s_anim_task == NULL) {
-        const BaseType_t created = xTaskCreate(lcd_animation_task, "lcd_anim", 4096, NULL,
-                                               CONFIG_P3A_RENDER_TASK_PRIORITY, &s_anim_task);
+        const BaseType_t created = task_topology_create(TASK_TOPOLOGY_RENDER, lcd_animation_task, NULL, &s_anim_task);
         if (created != pdPASS) {
             ESP_LOGE(TAG, "Failed to start LCD animation task");
             return ESP_FAIL;
@@ -2210,9 +4404,19 @@ void animation_player_deinit(void)
         s_loader_task = NULL;
     }
     
-    // Unload both buffers
-    unload_animation_buffer(&s_front_buffer);
-    unload_animation_buffer(&s_back_buffer);
+    // Unload every slot
+    for (int i = 0; i < ANIM_SLOT_COUNT; ++i) {
+        unload_animation_buffer(&s_slots[i].anim);
+        atomic_store(&s_slots[i].state, SLOT_EMPTY);
+    }
+    partial_read_discard();
+#if CONFIG_P3A_THUMB_CACHE_ENABLE
+    thumb_cache_close();
+#endif
+    
+    frame_transition_cancel(&s_transition);
+    heap_caps_free(s_transition_from_frame);
+    s_transition_from_frame = NULL;
     
     // Clean up synchronization primitives
     if (s_loader_sem) {
@@ -2225,7 +4429,7 @@ void animation_player_deinit(void)
         s_buffer_mutex = NULL;
     }
     
-    free_sd_file_list();
+    free_sd_file_list(&s_sd_file_list);
     if (s_sd_mounted) {
         bsp_sdcard_unmount();
         s_sd_mounted = false;
@@ -23,6 +23,7 @@
 #include "bsp/display.h"
 #include "bsp/esp32_p4_wifi6_touch_lcd_4b.h"
 #include "animation_player.h"
+#include "boot_profile.h"
 
 // Forward declaration for auto-swap timer reset
 extern void auto_swap_reset_timer(void);
@@ -97,6 +98,8 @@ esp_err_t app_lcd_init(void)
 
     ESP_LOGI(TAG, "Frame buffer stride: %zu bytes, size: %zu bytes", s_frame_row_stride_bytes, s_frame_buffer_bytes);
     
+    boot_profile_mark("lcd_ready");
+
     // Initialize animation player
     err = animation_player_init(display_handle, lcd_buffer, s_buffer_count,
                                 s_frame_buffer_bytes, s_frame_row_stride_bytes);
@@ -142,6 +145,13 @@ void app_lcd_cycle_animation_backward(void)
     auto_swap_reset_timer();  // Reset auto-swap timer on any swap
 }
 
+void app_lcd_skip_animations(int steps)
+{
+    if (animation_player_skip(steps) == ESP_OK) {
+        auto_swap_reset_timer();  // Reset auto-swap timer on any swap
+    }
+}
+
 int app_lcd_get_brightness(void)
 {
     return s_current_brightness;
@@ -8,145 +8,198 @@
 #include "freertos/task.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "bsp/touch.h"
 #include "esp_lcd_touch.h"
 #include "app_lcd.h"
 #include "app_touch.h"
+#include "animation_player.h"
 #include "bsp/display.h"
+#include "display_orientation.h"
+#include "task_topology.h"
+#include "touch_gesture.h"
+#include "metrics.h"
 #include "sdkconfig.h"
 
 static const char *TAG = "app_touch";
 
-
 static esp_lcd_touch_handle_t tp = NULL;
+static TaskHandle_t s_touch_task = NULL;
+static bool s_irq_mode = false;                 // INT line wakes the task; otherwise it polls
+static portMUX_TYPE s_irq_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t s_irq_us = 0;                    // Time of the last INT edge not yet read, 0 if none
 
-/**
- * @brief Gesture state machine states
- * 
- * The touch handler distinguishes between tap gestures (for animation swapping)
- * and swipe gestures (for brightness control) based on vertical movement distance.
- */
-typedef enum {
-    GESTURE_STATE_IDLE,        // No active touch
-    GESTURE_STATE_TAP,        // Potential tap/swap gesture (minimal movement)
-    GESTURE_STATE_BRIGHTNESS  // Brightness control gesture (vertical swipe detected)
-} gesture_state_t;
+#if CONFIG_P3A_TOUCH_USE_INTERRUPT
+// Runs in the GPIO ISR: note when the controller signalled and wake the task
+static void app_touch_isr(esp_lcd_touch_handle_t handle)
+{
+    (void)handle;
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&s_irq_lock);
+    if (s_irq_us == 0) {
+        s_irq_us = now_us;
+    }
+    portEXIT_CRITICAL_ISR(&s_irq_lock);
+
+    BaseType_t higher_prio_task_woken = pdFALSE;
+    if (s_touch_task) {
+        vTaskNotifyGiveFromISR(s_touch_task, &higher_prio_task_woken);
+    }
+    portYIELD_FROM_ISR(higher_prio_task_woken);
+}
+#endif
+
+// When the contact state about to be read was observed: the pending INT edge, else now
+static int64_t take_sample_time(void)
+{
+    portENTER_CRITICAL(&s_irq_lock);
+    const int64_t irq_us = s_irq_us;
+    s_irq_us = 0;
+    portEXIT_CRITICAL(&s_irq_lock);
+    return (irq_us != 0) ? irq_us : esp_timer_get_time();
+}
+
+static void handle_gesture(const touch_gesture_event_t *event, int *brightness_start)
+{
+    switch (event->type) {
+    case TOUCH_GESTURE_NONE:
+        return;
+    case TOUCH_GESTURE_TAP_LEFT:
+        // Left half: cycle backward
+        app_lcd_cycle_animation_backward();
+        ESP_LOGD(TAG, "tap gesture: swap animation backward");
+        break;
+    case TOUCH_GESTURE_TAP_RIGHT:
+        // Right half: cycle forward
+        app_lcd_cycle_animation();
+        ESP_LOGD(TAG, "tap gesture: swap animation");
+        break;
+    case TOUCH_GESTURE_BRIGHTNESS_START:
+        *brightness_start = app_lcd_get_brightness();
+        ESP_LOGD(TAG, "brightness gesture started @(%u,%u)", event->x, event->y);
+        break;
+    case TOUCH_GESTURE_BRIGHTNESS: {
+        int target_brightness = *brightness_start + event->brightness_delta;
+        if (target_brightness < 0) {
+            target_brightness = 0;
+        } else if (target_brightness > 100) {
+            target_brightness = 100;
+        }
+        if (target_brightness != app_lcd_get_brightness()) {
+            app_lcd_set_brightness(target_brightness);
+            ESP_LOGD(TAG, "brightness: %d%%", target_brightness);
+        }
+        return;
+    }
+    case TOUCH_GESTURE_BRIGHTNESS_END:
+        ESP_LOGD(TAG, "brightness gesture ended");
+        return;
+    case TOUCH_GESTURE_FLING_PREDICT:
+        // Start loading where the fling would land while the finger is still moving
+        animation_player_preload_skip(event->steps);
+        ESP_LOGD(TAG, "fling predicted: %+d", event->steps);
+        return;
+    case TOUCH_GESTURE_FLING:
+        app_lcd_skip_animations(event->steps);
+        ESP_LOGD(TAG, "fling gesture: skip %+d", event->steps);
+        break;
+    case TOUCH_GESTURE_SCRUB_START:
+        if (animation_player_scrub_begin() != ESP_OK) {
+            return;
+        }
+        ESP_LOGD(TAG, "scrub gesture started @(%u,%u)", event->x, event->y);
+        break;
+    case TOUCH_GESTURE_SCRUB:
+        animation_player_scrub_to(event->scrub_permille);
+        return;
+    case TOUCH_GESTURE_SCRUB_END:
+        animation_player_scrub_end();
+        ESP_LOGD(TAG, "scrub gesture ended");
+        return;
+    }
+    // Controller signal (or poll read) to the action taking effect
+    metrics_observe_us(METRICS_TOUCH_LATENCY, esp_timer_get_time() - event->t_us);
+}
 
 /**
- * @brief Touch task implementing gesture recognition
- * 
- * This task polls the touch controller and implements a state machine to distinguish
- * between:
- * - Tap gestures: Used for animation swapping (left/right half of screen)
- * - Vertical swipe gestures: Used for brightness control
- * 
- * Gesture classification:
- * - If vertical movement >= CONFIG_P3A_TOUCH_SWIPE_MIN_HEIGHT_PERCENT, it's a brightness gesture
- * - Otherwise, on release it's treated as a tap gesture for animation swapping
- * 
- * Brightness control:
- * - Swipe up (lower to higher Y) increases brightness
- * - Swipe down (higher to lower Y) decreases brightness
- * - Brightness change is proportional to vertical distance
- * - Maximum change per full-screen swipe is CONFIG_P3A_TOUCH_BRIGHTNESS_MAX_DELTA_PERCENT
- * - Brightness updates continuously as finger moves during swipe
- * - Auto-swap timer is reset when brightness gesture starts
+ * @brief Touch task feeding the gesture recognizer (touch_gesture.c)
+ *
+ * The task sleeps until the touch controller raises its INT line, then reads the controller
+ * every CONFIG_P3A_TOUCH_POLL_INTERVAL_MS while a contact lasts. Without an INT line it polls
+ * every CONFIG_P3A_TOUCH_IDLE_POLL_INTERVAL_MS while untouched instead.
+ *
+ * Gestures:
+ * - Tap: left half of the screen cycles backward, right half forward
+ * - Vertical swipe of at least CONFIG_P3A_TOUCH_SWIPE_MIN_HEIGHT_PERCENT: brightness control,
+ *   up brightens, proportional to the distance, CONFIG_P3A_TOUCH_BRIGHTNESS_MAX_DELTA_PERCENT
+ *   for a full-height swipe, updated continuously while the finger moves
+ * - Horizontal fling: skips artworks in proportion to the release speed (finger moving left goes
+ *   forward), from CONFIG_P3A_TOUCH_FLING_MIN_VELOCITY px/s for one artwork, one more per
+ *   CONFIG_P3A_TOUCH_FLING_VELOCITY_PER_ITEM px/s, at most CONFIG_P3A_TOUCH_FLING_MAX_ITEMS.
+ *   The predicted destination is loaded while the finger is still moving.
+ * - Press and hold for CONFIG_P3A_TOUCH_LONG_PRESS_MS, then drag: scrubs through the frames of
+ *   the artwork on screen, one screen width per loop
+ *
+ * Coordinates are mapped into the viewer's frame first, so left/right and up/down
+ * follow the configured display rotation and mirroring.
  */
 static void app_touch_task(void *arg)
 {
-    const TickType_t poll_delay = pdMS_TO_TICKS(CONFIG_P3A_TOUCH_POLL_INTERVAL_MS);
+    const TickType_t active_delay = pdMS_TO_TICKS(CONFIG_P3A_TOUCH_POLL_INTERVAL_MS);
+    const TickType_t idle_delay = s_irq_mode ? portMAX_DELAY : pdMS_TO_TICKS(CONFIG_P3A_TOUCH_IDLE_POLL_INTERVAL_MS);
     uint16_t x[CONFIG_ESP_LCD_TOUCH_MAX_POINTS];
     uint16_t y[CONFIG_ESP_LCD_TOUCH_MAX_POINTS];
     uint16_t strength[CONFIG_ESP_LCD_TOUCH_MAX_POINTS];
     uint8_t touch_count = 0;
     
-    gesture_state_t gesture_state = GESTURE_STATE_IDLE;
-    uint16_t touch_start_x = 0;
-    uint16_t touch_start_y = 0;
+    const uint16_t screen_width = DISPLAY_ORIENTATION_TRANSPOSED ? BSP_LCD_V_RES : BSP_LCD_H_RES;
+    const uint16_t screen_height = DISPLAY_ORIENTATION_TRANSPOSED ? BSP_LCD_H_RES : BSP_LCD_V_RES;
+    const touch_gesture_config_t gesture_config = {
+        .screen_w = screen_width,
+        .screen_h = screen_height,
+        .min_swipe_height = (screen_height * CONFIG_P3A_TOUCH_SWIPE_MIN_HEIGHT_PERCENT) / 100,
+        .max_brightness_delta = CONFIG_P3A_TOUCH_BRIGHTNESS_MAX_DELTA_PERCENT,
+        .touch_slop = screen_width / 24,
+        .long_press_us = (int64_t)CONFIG_P3A_TOUCH_LONG_PRESS_MS * 1000,
+        .fling_min_velocity = CONFIG_P3A_TOUCH_FLING_MIN_VELOCITY,
+        .fling_velocity_per_item = CONFIG_P3A_TOUCH_FLING_VELOCITY_PER_ITEM,
+        .fling_max_items = CONFIG_P3A_TOUCH_FLING_MAX_ITEMS,
+    };
+    touch_gesture_t gesture;
+    touch_gesture_init(&gesture, &gesture_config);
     int brightness_start = 100;  // Brightness at gesture start
-    const uint16_t screen_height = BSP_LCD_V_RES;
-    const uint16_t min_swipe_height = (screen_height * CONFIG_P3A_TOUCH_SWIPE_MIN_HEIGHT_PERCENT) / 100;
-    const int max_brightness_delta = CONFIG_P3A_TOUCH_BRIGHTNESS_MAX_DELTA_PERCENT;
 
     while (true) {
+        const int64_t t_us = take_sample_time();
         esp_lcd_touch_read_data(tp);
         bool pressed = esp_lcd_touch_get_coordinates(tp, x, y, strength, &touch_count,
                                                      CONFIG_ESP_LCD_TOUCH_MAX_POINTS);
 
-        if (pressed && touch_count > 0) {
-            if (gesture_state == GESTURE_STATE_IDLE) {
-                // Touch just started
-                touch_start_x = x[0];
-                touch_start_y = y[0];
-                brightness_start = app_lcd_get_brightness();
-                gesture_state = GESTURE_STATE_TAP;
-                ESP_LOGD(TAG, "touch start @(%u,%u)", touch_start_x, touch_start_y);
-            } else {
-                // Touch is active, check for gesture classification
-                int16_t delta_y = (int16_t)y[0] - (int16_t)touch_start_y;
-                uint16_t abs_delta_y = (delta_y < 0) ? -delta_y : delta_y;
-                
-                // Transition to brightness control if vertical distance exceeds threshold
-                if (gesture_state == GESTURE_STATE_TAP && abs_delta_y >= min_swipe_height) {
-                    gesture_state = GESTURE_STATE_BRIGHTNESS;
-                    brightness_start = app_lcd_get_brightness();
-                    touch_start_y = y[0]; // reset baseline to current finger position
-                    delta_y = 0;
-                    ESP_LOGD(TAG, "brightness gesture started @(%u,%u)", touch_start_x, touch_start_y);
-                }
-
-                if (gesture_state == GESTURE_STATE_BRIGHTNESS) {
-                    // Recompute delta against brightness baseline
-                    delta_y = (int16_t)y[0] - (int16_t)touch_start_y;
-
-                    // Calculate brightness change based on vertical distance
-                    // Formula: brightness_delta = (-delta_y * max_brightness_delta) / screen_height
-                    // - Full screen height (screen_height pixels) = max_brightness_delta percent change
-                    // - delta_y is positive when swiping down (y increases), negative when swiping up (y decreases)
-                    // - We negate delta_y so swipe up (negative delta_y) increases brightness
-                    // - Result is proportional: half screen swipe = half max delta
-                    int brightness_delta = (-delta_y * max_brightness_delta) / screen_height;
-                    int target_brightness = brightness_start + brightness_delta;
-                    
-                    // Clamp to valid range
-                    if (target_brightness < 0) {
-                        target_brightness = 0;
-                    } else if (target_brightness > 100) {
-                        target_brightness = 100;
-                    }
-                    
-                    // Update brightness if it changed
-                    int current_brightness = app_lcd_get_brightness();
-                    if (target_brightness != current_brightness) {
-                        app_lcd_set_brightness(target_brightness);
-                        ESP_LOGD(TAG, "brightness: %d%% (delta_y=%d)", target_brightness, delta_y);
-                    }
-                }
-                // If still in TAP state, don't do anything yet - wait for release
-            }
-        } else {
-            // Touch released
-            if (gesture_state != GESTURE_STATE_IDLE) {
-                if (gesture_state == GESTURE_STATE_TAP) {
-                    // It was a tap, perform swap gesture
-                    const uint16_t screen_midpoint = BSP_LCD_H_RES / 2;
-                    if (touch_start_x < screen_midpoint) {
-                        // Left half: cycle backward
-                        app_lcd_cycle_animation_backward();
-                    } else {
-                        // Right half: cycle forward
-                        app_lcd_cycle_animation();
-                    }
-                    ESP_LOGD(TAG, "tap gesture: swap animation");
-                } else {
-                    // It was a brightness gesture, already handled
-                    ESP_LOGD(TAG, "brightness gesture ended");
-                }
-                gesture_state = GESTURE_STATE_IDLE;
-            }
+        touch_sample_t sample = {
+            .t_us = t_us,
+            .pressed = pressed && touch_count > 0,
+        };
+        if (sample.pressed) {
+            int view_x = x[0];
+            int view_y = y[0];
+            display_orientation_panel_to_view(&view_x, &view_y, BSP_LCD_H_RES, BSP_LCD_V_RES);
+            sample.x = (uint16_t)view_x;
+            sample.y = (uint16_t)view_y;
+        }
+        if (sample.pressed || touch_gesture_active(&gesture)) {
+            ESP_LOGV(TAG, "sample %lld %d %u %u", (long long)sample.t_us, sample.pressed, sample.x, sample.y);
         }
 
-        vTaskDelay(poll_delay);
+        const touch_gesture_event_t event = touch_gesture_feed(&gesture, &sample);
+        handle_gesture(&event, &brightness_start);
+
+        // Poll at the active rate while touched; otherwise sleep until INT or the idle poll
+        const TickType_t delay = touch_gesture_active(&gesture) ? active_delay : idle_delay;
+        if (s_irq_mode) {
+            ulTaskNotifyTake(pdTRUE, delay);
+        } else {
+            vTaskDelay(delay);
+        }
     }
 }
 
@@ -158,12 +211,31 @@ esp_err_t app_touch_init(void)
         return err;
     }
 
-    const BaseType_t created = xTaskCreate(app_touch_task, "app_touch_task", 4096, NULL,
-                                           CONFIG_P3A_TOUCH_TASK_PRIORITY, NULL);
+#if CONFIG_P3A_TOUCH_USE_INTERRUPT
+    // Registering fails when the BSP has no INT pin for the controller; polling covers that case
+    err = esp_lcd_touch_register_interrupt_callback(tp, app_touch_isr);
+    s_irq_mode = (err == ESP_OK);
+    if (!s_irq_mode) {
+        ESP_LOGW(TAG, "touch interrupt unavailable (%s), polling instead", esp_err_to_name(err));
+    }
+#endif
+
+    const BaseType_t created = task_topology_create(TASK_TOPOLOGY_TOUCH, app_touch_task, NULL, &s_touch_task);
     if (created != pdPASS) {
         ESP_LOGE(TAG, "touch task creation failed");
+        if (s_irq_mode) {
+            esp_lcd_touch_register_interrupt_callback(tp, NULL);
+            s_irq_mode = false;
+        }
         return ESP_FAIL;
     }
 
+    if (s_irq_mode) {
+        ESP_LOGI(TAG, "touch input interrupt driven, polled every %d ms while touched",
+                 CONFIG_P3A_TOUCH_POLL_INTERVAL_MS);
+    } else {
+        ESP_LOGI(TAG, "touch input polled every %d ms while untouched (no INT line), %d ms while touched",
+                 CONFIG_P3A_TOUCH_IDLE_POLL_INTERVAL_MS, CONFIG_P3A_TOUCH_POLL_INTERVAL_MS);
+    }
     return ESP_OK;
 }
@@ -29,6 +29,16 @@
 #include "app_state.h"
 #include "http_api.h"
 #include "app_wifi.h"
+#include "osd.h"
+#include "boot_profile.h"
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+#include "sync_wall.h"
+#if CONFIG_P3A_SYNC_WALL_LEADER
+#define SYNC_WALL_IS_LEADER true
+#else
+#define SYNC_WALL_IS_LEADER false
+#endif
+#endif
 
 #define EXAMPLE_ESP_WIFI_SSID      CONFIG_ESP_WIFI_SSID
 #define EXAMPLE_ESP_WIFI_PASS      CONFIG_ESP_WIFI_PASSWORD
@@ -245,6 +255,7 @@ static void event_handler(void* arg, esp_event_base_t event_base,
             ESP_LOGW(TAG, "esp_wifi_remote_connect failed: %s", esp_err_to_name(err));
         }
     } else if (event_base == WIFI_REMOTE_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
+        osd_set_icon(OSD_ICON_WIFI_OFF, true);
         if (s_retry_num < EXAMPLE_ESP_MAXIMUM_RETRY) {
             esp_err_t err = esp_wifi_remote_connect();
             if (err != ESP_OK) {
@@ -259,8 +270,10 @@ static void event_handler(void* arg, esp_event_base_t event_base,
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         ESP_LOGI(TAG, "got ip:" IPSTR, IP2STR(&event->ip_info.ip));
+        boot_profile_mark("got_ip");
         s_retry_num = 0;
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        osd_set_icon(OSD_ICON_WIFI_OFF, false);
         
         // Stop captive portal server if running (to avoid port 80 conflict)
         if (s_captive_portal_server != NULL) {
@@ -284,6 +297,20 @@ static void event_handler(void* arg, esp_event_base_t event_base,
             app_state_enter_playing();
             ESP_LOGI(TAG, "REST API started at http://p3a.local/");
         }
+
+#if CONFIG_P3A_SYNC_WALL_ENABLE
+        const sync_wall_config_t sync_cfg = {
+            .leader = SYNC_WALL_IS_LEADER,
+            .group = CONFIG_P3A_SYNC_WALL_GROUP,
+            .port = CONFIG_P3A_SYNC_WALL_PORT,
+            .beacon_interval_ms = CONFIG_P3A_SYNC_WALL_BEACON_MS,
+            .node_id = 0,
+        };
+        esp_err_t sync_err = sync_wall_start(&sync_cfg);
+        if (sync_err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start sync wall: %s", esp_err_to_name(sync_err));
+        }
+#endif
     }
 }
 
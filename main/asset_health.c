@@ -0,0 +1,313 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "asset_health.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "asset_health";
+
+#define RETRY_BASE_US  ((int64_t)CONFIG_P3A_ASSET_RETRY_BASE_S * 1000000)
+#define RETRY_MAX_US   ((int64_t)CONFIG_P3A_ASSET_RETRY_MAX_S * 1000000)
+
+typedef struct {
+    int64_t retry_at_us;
+    esp_err_t error;
+    uint32_t failures;
+    asset_failure_reason_t reason;
+    bool quarantined;
+} health_entry_t;
+
+// Healthy artworks form a circular doubly linked list in play order, so stepping from one to the
+// next healthy one is a single lookup however many are quarantined in between. Quarantined
+// artworks are unlinked and go back in when their retry time has come.
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static health_entry_t *s_entries = NULL;
+static size_t *s_next = NULL;
+static size_t *s_prev = NULL;
+static size_t s_count = 0;
+static size_t s_healthy = 0;
+static int64_t s_next_release_us = INT64_MAX;  // Earliest retry time among quarantined artworks
+
+static void ring_remove(size_t index)
+{
+    if (s_healthy == 1) {
+        s_healthy = 0;
+        return;
+    }
+    s_next[s_prev[index]] = s_next[index];
+    s_prev[s_next[index]] = s_prev[index];
+    s_healthy--;
+}
+
+// Link a quarantined artwork back in after the nearest healthy one before it
+static void ring_insert(size_t index)
+{
+    if (s_healthy == 0) {
+        s_next[index] = index;
+        s_prev[index] = index;
+        s_healthy = 1;
+        return;
+    }
+    size_t prev = index;
+    do {
+        prev = (prev == 0) ? s_count - 1 : prev - 1;
+    } while (s_entries[prev].quarantined);
+    s_next[index] = s_next[prev];
+    s_prev[index] = prev;
+    s_prev[s_next[prev]] = index;
+    s_next[prev] = index;
+    s_healthy++;
+}
+
+// Lift the quarantines whose retry time has come (caller holds s_lock)
+static void release_due(int64_t now_us)
+{
+    if (now_us < s_next_release_us) {
+        return;
+    }
+    int64_t earliest = INT64_MAX;
+    for (size_t i = 0; i < s_count; ++i) {
+        health_entry_t *e = &s_entries[i];
+        if (!e->quarantined) {
+            continue;
+        }
+        if (e->retry_at_us <= now_us) {
+            ring_insert(i);
+            e->quarantined = false;
+        } else if (e->retry_at_us < earliest) {
+            earliest = e->retry_at_us;
+        }
+    }
+    s_next_release_us = earliest;
+}
+
+esp_err_t asset_health_reset(size_t count)
+{
+    health_entry_t *entries = NULL;
+    size_t *next = NULL;
+    size_t *prev = NULL;
+    esp_err_t err = ESP_OK;
+    if (count > 0) {
+        entries = calloc(count, sizeof(entries[0]));
+        next = malloc(count * sizeof(next[0]));
+        prev = malloc(count * sizeof(prev[0]));
+        if (!entries || !next || !prev) {
+            free(entries);
+            free(next);
+            free(prev);
+            entries = NULL;
+            next = NULL;
+            prev = NULL;
+            err = ESP_ERR_NO_MEM;
+            ESP_LOGE(TAG, "No memory to track %zu artworks, failed loads will not be skipped", count);
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                next[i] = (i + 1) % count;
+                prev[i] = (i == 0) ? count - 1 : i - 1;
+            }
+        }
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    health_entry_t *old_entries = s_entries;
+    size_t *old_next = s_next;
+    size_t *old_prev = s_prev;
+    s_entries = entries;
+    s_next = next;
+    s_prev = prev;
+    s_count = count;
+    s_healthy = count;
+    s_next_release_us = INT64_MAX;
+    portEXIT_CRITICAL(&s_lock);
+
+    free(old_entries);
+    free(old_next);
+    free(old_prev);
+    return err;
+}
+
+void asset_health_record_failure(size_t index, asset_failure_reason_t reason, esp_err_t error)
+{
+    const int64_t now_us = esp_timer_get_time();
+    uint32_t failures = 0;
+    int64_t delay_us = 0;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_entries && index < s_count) {
+        health_entry_t *e = &s_entries[index];
+        if (e->failures < UINT32_MAX) {
+            e->failures++;
+        }
+        e->reason = reason;
+        e->error = error;
+        const uint32_t doublings = (e->failures - 1 < 20) ? e->failures - 1 : 20;
+        delay_us = RETRY_BASE_US << doublings;
+        if (delay_us > RETRY_MAX_US) {
+            delay_us = RETRY_MAX_US;
+        }
+        e->retry_at_us = now_us + delay_us;
+        if (!e->quarantined) {
+            ring_remove(index);
+            e->quarantined = true;
+        }
+        if (e->retry_at_us < s_next_release_us) {
+            s_next_release_us = e->retry_at_us;
+        }
+        failures = e->failures;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (failures > 0) {
+        ESP_LOGW(TAG, "Index %zu quarantined for %lld s after %lu failure(s): %s (%s)", index,
+                 (long long)(delay_us / 1000000), (unsigned long)failures, asset_health_reason_name(reason),
+                 esp_err_to_name(error));
+    }
+}
+
+void asset_health_record_success(size_t index)
+{
+    bool recovered = false;
+    portENTER_CRITICAL(&s_lock);
+    if (s_entries && index < s_count && s_entries[index].failures > 0) {
+        health_entry_t *e = &s_entries[index];
+        if (e->quarantined) {
+            ring_insert(index);
+        }
+        memset(e, 0, sizeof(*e));
+        recovered = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (recovered) {
+        ESP_LOGI(TAG, "Index %zu loaded again, failure record cleared", index);
+    }
+}
+
+bool asset_health_is_healthy(size_t index)
+{
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    bool healthy = true;
+    if (s_entries) {
+        release_due(now_us);
+        healthy = index < s_count && !s_entries[index].quarantined;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return healthy;
+}
+
+size_t asset_health_healthy_count(void)
+{
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    if (s_entries) {
+        release_due(now_us);
+    }
+    const size_t healthy = s_healthy;
+    portEXIT_CRITICAL(&s_lock);
+    return healthy;
+}
+
+size_t asset_health_next(size_t index, size_t count)
+{
+    if (count == 0) {
+        return 0;
+    }
+    const int64_t now_us = esp_timer_get_time();
+    size_t next;
+    portENTER_CRITICAL(&s_lock);
+    if (!s_entries || s_count != count) {
+        next = (index + 1) % count;
+    } else {
+        release_due(now_us);
+        if (s_healthy == 0) {
+            next = index;
+        } else if (index < count && !s_entries[index].quarantined) {
+            next = s_next[index];
+        } else {
+            // Stepping off a quarantined artwork walks to the first healthy one after it
+            next = (index < count) ? (index + 1) % count : 0;
+            while (s_entries[next].quarantined) {
+                next = (next + 1) % count;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return next;
+}
+
+size_t asset_health_prev(size_t index, size_t count)
+{
+    if (count == 0) {
+        return 0;
+    }
+    const int64_t now_us = esp_timer_get_time();
+    size_t prev;
+    portENTER_CRITICAL(&s_lock);
+    if (!s_entries || s_count != count) {
+        prev = (index == 0 || index >= count) ? count - 1 : index - 1;
+    } else {
+        release_due(now_us);
+        if (s_healthy == 0) {
+            prev = index;
+        } else if (index < count && !s_entries[index].quarantined) {
+            prev = s_prev[index];
+        } else {
+            prev = (index == 0 || index >= count) ? count - 1 : index - 1;
+            while (s_entries[prev].quarantined) {
+                prev = (prev == 0) ? count - 1 : prev - 1;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return prev;
+}
+
+size_t asset_health_get_failures(asset_health_record_t *out, size_t max)
+{
+    if (!out) {
+        return 0;
+    }
+    size_t n = 0;
+    portENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; s_entries && i < s_count && n < max; ++i) {
+        const health_entry_t *e = &s_entries[i];
+        if (e->failures == 0) {
+            continue;
+        }
+        out[n++] = (asset_health_record_t){
+            .index = i,
+            .reason = e->reason,
+            .error = e->error,
+            .failures = e->failures,
+            .quarantined = e->quarantined,
+            .retry_at_us = e->retry_at_us,
+        };
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+const char *asset_health_reason_name(asset_failure_reason_t reason)
+{
+    switch (reason) {
+    case ASSET_FAILURE_NONE:
+        return "none";
+    case ASSET_FAILURE_OPEN:
+        return "open";
+    case ASSET_FAILURE_READ:
+        return "read";
+    case ASSET_FAILURE_NO_MEM:
+        return "no_mem";
+    case ASSET_FAILURE_DECODE:
+        return "decode";
+    }
+    return "unknown";
+}
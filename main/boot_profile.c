@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "boot_profile.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "boot";
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static boot_profile_mark_t s_marks[BOOT_PROFILE_MAX_MARKS];
+static size_t s_mark_count = 0;
+static int64_t s_first_frame_us = 0;
+
+void boot_profile_mark(const char *phase)
+{
+    const int64_t now_us = esp_timer_get_time();
+    bool recorded = false;
+    portENTER_CRITICAL(&s_lock);
+    bool seen = false;
+    for (size_t i = 0; i < s_mark_count && !seen; ++i) {
+        seen = (s_marks[i].phase == phase);
+    }
+    if (!seen && s_mark_count < BOOT_PROFILE_MAX_MARKS) {
+        s_marks[s_mark_count].phase = phase;
+        s_marks[s_mark_count].time_us = now_us;
+        s_mark_count++;
+        recorded = true;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if (!recorded) {
+        return;
+    }
+    ESP_LOGD(TAG, "%s at %lld ms", phase, (long long)(now_us / 1000));
+}
+
+void boot_profile_first_frame(void)
+{
+    if (s_first_frame_us != 0) {
+        return;
+    }
+    s_first_frame_us = esp_timer_get_time();
+    boot_profile_mark("first_frame");
+
+    boot_profile_mark_t marks[BOOT_PROFILE_MAX_MARKS];
+    const size_t n = boot_profile_get(marks, BOOT_PROFILE_MAX_MARKS);
+    int64_t prev_us = 0;
+    for (size_t i = 0; i < n; ++i) {
+        ESP_LOGI(TAG, "%8lld ms (+%5lld ms)  %s", (long long)(marks[i].time_us / 1000),
+                 (long long)((marks[i].time_us - prev_us) / 1000), marks[i].phase);
+        prev_us = marks[i].time_us;
+    }
+    ESP_LOGI(TAG, "First frame %lld ms after start", (long long)(s_first_frame_us / 1000));
+}
+
+size_t boot_profile_get(boot_profile_mark_t *out, size_t max)
+{
+    if (!out) {
+        return 0;
+    }
+    portENTER_CRITICAL(&s_lock);
+    const size_t n = (s_mark_count < max) ? s_mark_count : max;
+    memcpy(out, s_marks, n * sizeof(out[0]));
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+int64_t boot_profile_first_frame_us(void)
+{
+    return s_first_frame_us;
+}
@@ -0,0 +1,188 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "color_pipeline.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "color_pipeline";
+
+#ifndef CONFIG_P3A_COLOR_GAMMA_X100
+#define CONFIG_P3A_COLOR_GAMMA_X100 100
+#endif
+#ifndef CONFIG_P3A_COLOR_TEMPERATURE_K
+#define CONFIG_P3A_COLOR_TEMPERATURE_K 6500
+#endif
+
+#define NEUTRAL_TEMPERATURE_K 6500
+#define MIN_TEMPERATURE_K 1000
+#define MAX_TEMPERATURE_K 40000
+#define MIN_GAMMA 0.2f
+#define MAX_GAMMA 5.0f
+
+const uint8_t color_pipeline_bayer4[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+};
+
+// Two table sets: one the render path may be reading, one being rebuilt
+static color_pipeline_t s_tables[2];
+static const color_pipeline_t *s_published = NULL;  // Latest tables, NULL for identity
+static const color_pipeline_t *s_active = NULL;     // Tables latched for the current frame
+static SemaphoreHandle_t s_build_mutex = NULL;      // Guards s_tables and s_published
+
+void color_pipeline_default_config(color_pipeline_config_t *cfg)
+{
+    if (!cfg) {
+        return;
+    }
+    cfg->gamma = (float)CONFIG_P3A_COLOR_GAMMA_X100 / 100.0f;
+    cfg->temperature_k = CONFIG_P3A_COLOR_TEMPERATURE_K;
+#if CONFIG_P3A_RGB565_DITHER
+    cfg->dither = true;
+#else
+    cfg->dither = false;
+#endif
+}
+
+void color_pipeline_config_from_json(const cJSON *json, color_pipeline_config_t *cfg)
+{
+    if (!json || !cfg) {
+        return;
+    }
+    const cJSON *gamma = cJSON_GetObjectItemCaseSensitive(json, "gamma");
+    if (cJSON_IsNumber(gamma) && gamma->valuedouble >= MIN_GAMMA && gamma->valuedouble <= MAX_GAMMA) {
+        cfg->gamma = (float)gamma->valuedouble;
+    }
+    const cJSON *temp = cJSON_GetObjectItemCaseSensitive(json, "color_temp_k");
+    if (cJSON_IsNumber(temp) && temp->valueint >= MIN_TEMPERATURE_K && temp->valueint <= MAX_TEMPERATURE_K) {
+        cfg->temperature_k = (uint16_t)temp->valueint;
+    }
+    const cJSON *dither = cJSON_GetObjectItemCaseSensitive(json, "dither");
+    if (cJSON_IsBool(dither)) {
+        cfg->dither = cJSON_IsTrue(dither);
+    }
+}
+
+// Approximate blackbody RGB (0..1) for a colour temperature, after Tanner Helland's fit
+static void blackbody_rgb(float kelvin, float rgb[3])
+{
+    const float t = kelvin / 100.0f;
+    float r, g, b;
+    if (t <= 66.0f) {
+        r = 255.0f;
+        g = 99.4708025861f * logf(t) - 161.1195681661f;
+    } else {
+        r = 329.698727446f * powf(t - 60.0f, -0.1332047592f);
+        g = 288.1221695283f * powf(t - 60.0f, -0.0755148492f);
+    }
+    if (t >= 66.0f) {
+        b = 255.0f;
+    } else if (t <= 19.0f) {
+        b = 0.0f;
+    } else {
+        b = 138.5177312231f * logf(t - 10.0f) - 305.0447927307f;
+    }
+    rgb[0] = fminf(fmaxf(r, 0.0f), 255.0f) / 255.0f;
+    rgb[1] = fminf(fmaxf(g, 0.0f), 255.0f) / 255.0f;
+    rgb[2] = fminf(fmaxf(b, 0.0f), 255.0f) / 255.0f;
+}
+
+// Per-channel white-point gains relative to the neutral temperature, largest gain normalized to 1
+static void white_point_gains(uint16_t kelvin, float gains[3])
+{
+    float target[3], neutral[3];
+    blackbody_rgb((float)kelvin, target);
+    blackbody_rgb((float)NEUTRAL_TEMPERATURE_K, neutral);
+    float max_gain = 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        gains[c] = (neutral[c] > 0.0f) ? target[c] / neutral[c] : 1.0f;
+        max_gain = fmaxf(max_gain, gains[c]);
+    }
+    for (int c = 0; c < 3; ++c) {
+        gains[c] = (max_gain > 0.0f) ? gains[c] / max_gain : 1.0f;
+    }
+}
+
+static bool config_is_identity(const color_pipeline_config_t *cfg)
+{
+    const bool neutral = fabsf(cfg->gamma - 1.0f) < 0.005f && cfg->temperature_k == NEUTRAL_TEMPERATURE_K;
+#if CONFIG_LCD_PIXEL_FORMAT_RGB565
+    return neutral && !cfg->dither;
+#else
+    return neutral;
+#endif
+}
+
+static void build_tables(color_pipeline_t *t, const color_pipeline_config_t *cfg)
+{
+    float gains[3];
+    white_point_gains(cfg->temperature_k, gains);
+
+    uint8_t *lut8[3] = { t->lut8_r, t->lut8_g, t->lut8_b };
+    uint16_t *lut565[3] = { t->lut565_r, t->lut565_g, t->lut565_b };
+    const float levels[3] = { 31.0f, 63.0f, 31.0f };
+
+    for (int i = 0; i < 256; ++i) {
+        const float linear = powf((float)i / 255.0f, cfg->gamma);
+        for (int c = 0; c < 3; ++c) {
+            const float v = fminf(linear * gains[c], 1.0f);
+            lut8[c][i] = (uint8_t)lrintf(v * 255.0f);
+            // Output level with 4 fractional bits; the maximum stays level * 16 so adding
+            // a dither threshold (< 16) can never overflow the field
+            lut565[c][i] = (uint16_t)lrintf(v * levels[c] * 16.0f);
+        }
+    }
+    t->dither = cfg->dither;
+}
+
+esp_err_t color_pipeline_configure(const color_pipeline_config_t *cfg)
+{
+    if (!cfg) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!s_build_mutex) {
+        s_build_mutex = xSemaphoreCreateMutex();
+        if (!s_build_mutex) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    xSemaphoreTake(s_build_mutex, portMAX_DELAY);
+
+    const color_pipeline_t *next = NULL;
+    if (!config_is_identity(cfg)) {
+        // Never rebuild the copy the current frame may still be reading
+        color_pipeline_t *target = (s_active == &s_tables[0]) ? &s_tables[1] : &s_tables[0];
+        build_tables(target, cfg);
+        next = target;
+    }
+
+    s_published = next;
+
+    xSemaphoreGive(s_build_mutex);
+
+    ESP_LOGI(TAG, "Colour pipeline: gamma %.2f, %u K, dither %s%s", cfg->gamma, cfg->temperature_k,
+             cfg->dither ? "on" : "off", next ? "" : " (identity)");
+    return ESP_OK;
+}
+
+const color_pipeline_t *color_pipeline_begin_frame(void)
+{
+    // A rebuild in progress keeps the previous tables for this frame
+    if (s_build_mutex && xSemaphoreTake(s_build_mutex, 0) == pdTRUE) {
+        s_active = s_published;
+        xSemaphoreGive(s_build_mutex);
+    }
+    return s_active;
+}
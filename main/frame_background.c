@@ -0,0 +1,202 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "frame_background.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char *TAG = "frame_background";
+
+#ifndef CONFIG_P3A_BACKGROUND_COLOR
+#define CONFIG_P3A_BACKGROUND_COLOR 0x000000
+#endif
+#ifndef CONFIG_P3A_BACKGROUND_IMAGE_PATH
+#define CONFIG_P3A_BACKGROUND_IMAGE_PATH ""
+#endif
+
+#define CHECKER_COLOR_DEFAULT 0x404040
+#define CHECKER_SHIFT_DEFAULT 4
+
+// Two published copies: one the render path may be reading, one being rebuilt
+static frame_background_t s_slots[2];
+static uint8_t *s_slot_images[2];
+static const frame_background_t *s_published = &s_slots[0];
+static const frame_background_t *s_active = &s_slots[0];
+static SemaphoreHandle_t s_build_mutex = NULL;  // Guards s_slots and s_published
+
+void frame_background_default_config(frame_background_config_t *cfg)
+{
+    if (!cfg) {
+        return;
+    }
+    memset(cfg, 0, sizeof(*cfg));
+#if CONFIG_P3A_BACKGROUND_CHECKER
+    cfg->mode = FRAME_BACKGROUND_CHECKER;
+#elif CONFIG_P3A_BACKGROUND_IMAGE
+    cfg->mode = FRAME_BACKGROUND_IMAGE;
+#else
+    cfg->mode = FRAME_BACKGROUND_SOLID;
+#endif
+    cfg->color = CONFIG_P3A_BACKGROUND_COLOR;
+    cfg->checker_color = CHECKER_COLOR_DEFAULT;
+    cfg->checker_shift = CHECKER_SHIFT_DEFAULT;
+    snprintf(cfg->image_path, sizeof(cfg->image_path), "%s", CONFIG_P3A_BACKGROUND_IMAGE_PATH);
+}
+
+static bool parse_color(const cJSON *item, uint32_t *out)
+{
+    if (cJSON_IsNumber(item) && item->valuedouble >= 0 && item->valuedouble <= 0xFFFFFF) {
+        *out = (uint32_t)item->valuedouble;
+        return true;
+    }
+    if (cJSON_IsString(item) && item->valuestring) {
+        const char *s = item->valuestring;
+        if (*s == '#') {
+            s++;
+        }
+        char *end = NULL;
+        const unsigned long v = strtoul(s, &end, 16);
+        if (end != s && *end == '\0' && (end - s) == 6) {
+            *out = (uint32_t)v;
+            return true;
+        }
+    }
+    return false;
+}
+
+void frame_background_config_from_json(const cJSON *json, frame_background_config_t *cfg)
+{
+    if (!json || !cfg) {
+        return;
+    }
+    const cJSON *mode = cJSON_GetObjectItemCaseSensitive(json, "background");
+    if (cJSON_IsString(mode) && mode->valuestring) {
+        if (strcasecmp(mode->valuestring, "solid") == 0) {
+            cfg->mode = FRAME_BACKGROUND_SOLID;
+        } else if (strcasecmp(mode->valuestring, "checker") == 0) {
+            cfg->mode = FRAME_BACKGROUND_CHECKER;
+        } else if (strcasecmp(mode->valuestring, "image") == 0) {
+            cfg->mode = FRAME_BACKGROUND_IMAGE;
+        } else {
+            ESP_LOGW(TAG, "Unknown background mode '%s'", mode->valuestring);
+        }
+    }
+    parse_color(cJSON_GetObjectItemCaseSensitive(json, "background_color"), &cfg->color);
+    parse_color(cJSON_GetObjectItemCaseSensitive(json, "background_checker_color"), &cfg->checker_color);
+    const cJSON *image = cJSON_GetObjectItemCaseSensitive(json, "background_image");
+    if (cJSON_IsString(image) && image->valuestring) {
+        snprintf(cfg->image_path, sizeof(cfg->image_path), "%s", image->valuestring);
+    }
+}
+
+static void unpack_rgb(uint32_t rgb, uint8_t out[3])
+{
+    out[0] = (uint8_t)(rgb >> 16);
+    out[1] = (uint8_t)(rgb >> 8);
+    out[2] = (uint8_t)rgb;
+}
+
+// Nearest-neighbour resample to the panel, pre-composited over the solid colour
+static void build_image(uint8_t *dst, int panel_w, int panel_h, const uint8_t *rgba, int w, int h,
+                        const frame_background_t *solid)
+{
+    for (int y = 0; y < panel_h; ++y) {
+        const uint8_t *src_row = rgba + (size_t)((y * h) / panel_h) * w * 4;
+        uint8_t *dst_row = dst + (size_t)y * panel_w * 3;
+        for (int x = 0; x < panel_w; ++x) {
+            frame_background_composite(solid, src_row + (size_t)((x * w) / panel_w) * 4, x, y, dst_row + x * 3);
+        }
+    }
+}
+
+esp_err_t frame_background_configure(const frame_background_config_t *cfg,
+                                     const uint8_t *image_rgba, int image_w, int image_h,
+                                     int panel_w, int panel_h)
+{
+    if (!cfg) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!s_build_mutex) {
+        s_build_mutex = xSemaphoreCreateMutex();
+        if (!s_build_mutex) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    xSemaphoreTake(s_build_mutex, portMAX_DELAY);
+
+    // Never rebuild the copy the current frame may still be reading
+    const int slot = (s_active == &s_slots[0]) ? 1 : 0;
+    frame_background_t *bg = &s_slots[slot];
+    heap_caps_free(s_slot_images[slot]);
+    s_slot_images[slot] = NULL;
+
+    memset(bg, 0, sizeof(*bg));
+    bg->mode = cfg->mode;
+    unpack_rgb(cfg->color, bg->rgb[0]);
+    unpack_rgb(cfg->checker_color, bg->rgb[1]);
+    bg->checker_shift = cfg->checker_shift;
+
+    esp_err_t err = ESP_OK;
+    if (bg->mode == FRAME_BACKGROUND_IMAGE) {
+        bg->mode = FRAME_BACKGROUND_SOLID;
+        if (image_rgba && image_w > 0 && image_h > 0) {
+            uint8_t *image = (uint8_t *)heap_caps_malloc((size_t)panel_w * panel_h * 3, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            if (image) {
+                build_image(image, panel_w, panel_h, image_rgba, image_w, image_h, bg);
+                s_slot_images[slot] = image;
+                bg->image = image;
+                bg->image_w = panel_w;
+                bg->image_h = panel_h;
+                bg->mode = FRAME_BACKGROUND_IMAGE;
+            } else {
+                ESP_LOGW(TAG, "No memory for background image, using solid colour");
+                err = ESP_ERR_NO_MEM;
+            }
+        } else {
+            ESP_LOGW(TAG, "Background image unavailable, using solid colour");
+        }
+    }
+
+    s_published = bg;
+
+    xSemaphoreGive(s_build_mutex);
+    return err;
+}
+
+const frame_background_t *frame_background_begin_frame(void)
+{
+    // A rebuild in progress keeps the previous background for this frame
+    if (s_build_mutex && xSemaphoreTake(s_build_mutex, 0) == pdTRUE) {
+        s_active = s_published;
+        xSemaphoreGive(s_build_mutex);
+    }
+    return s_active;
+}
+
+bool frame_background_uniform_color(uint8_t rgb[3])
+{
+    bool uniform = false;
+    if (s_build_mutex) {
+        xSemaphoreTake(s_build_mutex, portMAX_DELAY);
+    }
+    if (s_published->mode == FRAME_BACKGROUND_SOLID) {
+        memcpy(rgb, s_published->rgb[0], 3);
+        uniform = true;
+    }
+    if (s_build_mutex) {
+        xSemaphoreGive(s_build_mutex);
+    }
+    return uniform;
+}
@@ -0,0 +1,219 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "frame_transition.h"
+#include <string.h>
+
+// Blend weights are fixed point: RGB565 uses 0..32 (5-bit fields leave 5 bits of
+// headroom), byte-oriented RGB888 uses 0..256.
+#define BLEND565_ONE 32U
+#define BLEND888_ONE 256U
+
+// RGB565 SWAR masks. Two pixels share a 32-bit word; each mask selects fields that
+// have at least 5 free bits above them, so one multiply blends all of them at once.
+#define RGB565_MASK_LO 0x07E0F81FU  // p0.R, p0.B, p1.G
+#define RGB565_MASK_HI 0xF81F07E0U  // p0.G, p1.R, p1.B
+#define RGB565_MASK_HI_SHIFTED (RGB565_MASK_HI >> 5)
+
+static inline uint32_t blend565x2(uint32_t to, uint32_t from, uint32_t a, uint32_t ia)
+{
+    const uint32_t lo = ((((to & RGB565_MASK_LO) * a) + ((from & RGB565_MASK_LO) * ia)) >> 5) & RGB565_MASK_LO;
+    const uint32_t hi = ((((to >> 5) & RGB565_MASK_HI_SHIFTED) * a) +
+                         (((from >> 5) & RGB565_MASK_HI_SHIFTED) * ia)) & RGB565_MASK_HI;
+    return lo | hi;
+}
+
+static inline uint16_t blend565(uint16_t to, uint16_t from, uint32_t a, uint32_t ia)
+{
+    // Spread a single pixel as 0b00000gggggg00000rrrrr000000bbbbb so every field has headroom
+    const uint32_t t = ((uint32_t)to | ((uint32_t)to << 16)) & RGB565_MASK_LO;
+    const uint32_t f = ((uint32_t)from | ((uint32_t)from << 16)) & RGB565_MASK_LO;
+    const uint32_t mixed = ((t * a + f * ia) >> 5) & RGB565_MASK_LO;
+    return (uint16_t)((mixed & 0xFFFFU) | (mixed >> 16));
+}
+
+static inline uint32_t blend888x4(uint32_t to, uint32_t from, uint32_t a, uint32_t ia)
+{
+    // Byte lanes are blended pairwise; channel order does not matter for a uniform blend
+    const uint32_t rb = ((((to & 0x00FF00FFU) * a) + ((from & 0x00FF00FFU) * ia)) >> 8) & 0x00FF00FFU;
+    const uint32_t g = ((((to >> 8) & 0x00FF00FFU) * a) + (((from >> 8) & 0x00FF00FFU) * ia)) & 0xFF00FF00U;
+    return rb | g;
+}
+
+static void crossfade_row(const frame_transition_t *t, uint8_t *dst_row, const uint8_t *from_row)
+{
+    const uint32_t steps = (uint32_t)t->steps + 1U;
+
+    if (t->bytes_per_pixel == 2) {
+        const uint32_t a = ((uint32_t)t->step * BLEND565_ONE) / steps;
+        const uint32_t ia = BLEND565_ONE - a;
+        uint32_t *dst_words = (uint32_t *)dst_row;
+        const uint32_t *from_words = (const uint32_t *)from_row;
+        const int pairs = t->width / 2;
+        for (int i = 0; i < pairs; ++i) {
+            dst_words[i] = blend565x2(dst_words[i], from_words[i], a, ia);
+        }
+        if (t->width & 1) {
+            uint16_t *dst_px = (uint16_t *)dst_row;
+            const uint16_t *from_px = (const uint16_t *)from_row;
+            const int last = t->width - 1;
+            dst_px[last] = blend565(dst_px[last], from_px[last], a, ia);
+        }
+    } else {
+        const uint32_t a = ((uint32_t)t->step * BLEND888_ONE) / steps;
+        const uint32_t ia = BLEND888_ONE - a;
+        const size_t row_bytes = (size_t)t->width * t->bytes_per_pixel;
+        const size_t words = row_bytes / 4U;
+        uint32_t *dst_words = (uint32_t *)dst_row;
+        const uint32_t *from_words = (const uint32_t *)from_row;
+        for (size_t i = 0; i < words; ++i) {
+            dst_words[i] = blend888x4(dst_words[i], from_words[i], a, ia);
+        }
+        for (size_t i = words * 4U; i < row_bytes; ++i) {
+            dst_row[i] = (uint8_t)((dst_row[i] * a + from_row[i] * ia) >> 8);
+        }
+    }
+}
+
+// Keep the outgoing frame in columns [x0, x1)
+static inline void copy_from_span(const frame_transition_t *t, uint8_t *dst_row, const uint8_t *from_row, int x0, int x1)
+{
+    if (x0 < 0) {
+        x0 = 0;
+    }
+    if (x1 > t->width) {
+        x1 = t->width;
+    }
+    if (x0 >= x1) {
+        return;
+    }
+    const size_t offset = (size_t)x0 * t->bytes_per_pixel;
+    memcpy(dst_row + offset, from_row + offset, (size_t)(x1 - x0) * t->bytes_per_pixel);
+}
+
+static uint32_t isqrt32(uint32_t v)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+void frame_transition_begin(frame_transition_t *t, frame_transition_type_t type, const uint8_t *from_frame,
+                            uint16_t steps, int width, int height,
+                            size_t row_stride_bytes, size_t bytes_per_pixel)
+{
+    if (!t) {
+        return;
+    }
+    memset(t, 0, sizeof(*t));
+    if (type == FRAME_TRANSITION_NONE || !from_frame || steps == 0 || width <= 0 || height <= 0 ||
+        (bytes_per_pixel != 2 && bytes_per_pixel != 3)) {
+        return;
+    }
+    t->type = type;
+    t->from_frame = from_frame;
+    t->step = 1;
+    t->steps = steps;
+    t->width = width;
+    t->height = height;
+    t->row_stride_bytes = row_stride_bytes;
+    t->bytes_per_pixel = bytes_per_pixel;
+}
+
+bool frame_transition_active(const frame_transition_t *t)
+{
+    return t && t->type != FRAME_TRANSITION_NONE && t->from_frame && t->step <= t->steps;
+}
+
+void frame_transition_apply_rows(const frame_transition_t *t, uint8_t *dst, int row_start, int row_end)
+{
+    if (!frame_transition_active(t) || !dst) {
+        return;
+    }
+    if (row_start < 0) row_start = 0;
+    if (row_end > t->height) row_end = t->height;
+    if (row_start >= row_end) return;
+
+    const uint32_t steps = (uint32_t)t->steps + 1U;
+
+    switch (t->type) {
+    case FRAME_TRANSITION_CROSSFADE:
+        for (int y = row_start; y < row_end; ++y) {
+            const size_t row_offset = (size_t)y * t->row_stride_bytes;
+            crossfade_row(t, dst + row_offset, t->from_frame + row_offset);
+        }
+        break;
+
+    case FRAME_TRANSITION_WIPE: {
+        // Incoming frame is revealed left to right
+        const int boundary = (int)(((uint32_t)t->step * (uint32_t)t->width) / steps);
+        for (int y = row_start; y < row_end; ++y) {
+            const size_t row_offset = (size_t)y * t->row_stride_bytes;
+            copy_from_span(t, dst + row_offset, t->from_frame + row_offset, boundary, t->width);
+        }
+        break;
+    }
+
+    case FRAME_TRANSITION_IRIS: {
+        // Incoming frame grows from the centre as a circle
+        const int cx = t->width / 2;
+        const int cy = t->height / 2;
+        const uint32_t max_radius = isqrt32((uint32_t)(cx * cx + cy * cy)) + 1U;
+        const int radius = (int)(((uint32_t)t->step * max_radius) / steps);
+        for (int y = row_start; y < row_end; ++y) {
+            const size_t row_offset = (size_t)y * t->row_stride_bytes;
+            uint8_t *dst_row = dst + row_offset;
+            const uint8_t *from_row = t->from_frame + row_offset;
+            const int dy = y - cy;
+            if (dy <= -radius || dy >= radius) {
+                copy_from_span(t, dst_row, from_row, 0, t->width);
+                continue;
+            }
+            const int half = (int)isqrt32((uint32_t)(radius * radius - dy * dy));
+            copy_from_span(t, dst_row, from_row, 0, cx - half);
+            copy_from_span(t, dst_row, from_row, cx + half, t->width);
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void frame_transition_advance(frame_transition_t *t)
+{
+    if (!frame_transition_active(t)) {
+        return;
+    }
+    t->step++;
+    if (t->step > t->steps) {
+        frame_transition_cancel(t);
+    }
+}
+
+void frame_transition_cancel(frame_transition_t *t)
+{
+    if (!t) {
+        return;
+    }
+    t->type = FRAME_TRANSITION_NONE;
+    t->from_frame = NULL;
+    t->step = 0;
+    t->steps = 0;
+}
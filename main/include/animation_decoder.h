@@ -33,6 +33,7 @@ typedef struct {
     uint32_t canvas_height;
     size_t frame_count;
     bool has_transparency;
+    uint32_t loop_duration_ms;  // Sum of all frame delays (one full loop), 0 if unknown
 } animation_decoder_info_t;
 
 /**
@@ -73,6 +74,21 @@ esp_err_t animation_decoder_decode_next(animation_decoder_t *decoder, uint8_t *r
  */
 esp_err_t animation_decoder_get_frame_delay(animation_decoder_t *decoder, uint32_t *delay_ms);
 
+/**
+ * @brief Pre-blend transparency against a solid background colour
+ *
+ * Indexed formats (GIF) resolve transparent palette entries to this colour while
+ * decoding, so frames come out fully opaque and need no per-pixel compositing.
+ * Afterwards animation_decoder_get_info() reports has_transparency = false.
+ *
+ * @param decoder Decoder handle
+ * @param r Red
+ * @param g Green
+ * @param b Blue
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED for formats with a real alpha channel
+ */
+esp_err_t animation_decoder_set_background(animation_decoder_t *decoder, uint8_t r, uint8_t g, uint8_t b);
+
 /**
  * @brief Reset decoder to beginning
  *
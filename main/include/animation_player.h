@@ -8,6 +8,7 @@
 #define ANIMATION_PLAYER_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "esp_err.h"
 #include "esp_lcd_panel_ops.h"
@@ -66,6 +67,124 @@ bool animation_player_is_paused(void);
  */
 void animation_player_cycle_animation(bool forward);
 
+/**
+ * @brief Change to the artwork steps positions away in play order, as for a fling
+ *
+ * Quarantined artworks do not count as positions. In gallery mode the page is turned once
+ * in the direction of steps.
+ *
+ * @param steps Positive forward, negative backward
+ * @return ESP_OK if queued or if steps is a whole number of laps (nothing changes), ESP_ERR_INVALID_ARG
+ *         for 0, ESP_ERR_NOT_FOUND if there is nothing to change to
+ */
+esp_err_t animation_player_skip(int steps);
+
+/**
+ * @brief Start loading the artwork a skip of steps would show, before the skip is decided
+ *
+ * Meant for the predicted destination of a fling still in progress. Each call replaces the
+ * previous prediction, cancelling its load; the artwork stays loaded until evicted, so a
+ * following animation_player_skip() to it swaps right away.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for 0, ESP_ERR_INVALID_STATE without artworks or in gallery mode
+ */
+esp_err_t animation_player_preload_skip(int steps);
+
+/**
+ * @brief Let the scrub position choose the frames of the artwork on screen instead of the clock
+ *
+ * Swaps wait until scrubbing ends; playback (or the pause) then continues from the frame
+ * reached.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE in gallery mode
+ */
+esp_err_t animation_player_scrub_begin(void);
+
+/**
+ * @brief Move the scrub position
+ *
+ * @param permille Horizontal drag since animation_player_scrub_begin() in thousandths of the
+ *                 panel width, negative to the left; one panel width runs through one loop
+ */
+void animation_player_scrub_to(int permille);
+
+/**
+ * @brief Hand the frames back to the clock
+ */
+void animation_player_scrub_end(void);
+
+/**
+ * @brief Preload the next animation now and swap to it at a loop boundary
+ *
+ * The swap happens when the current animation shows the last frame of a loop at or after
+ * not_before_us, so the next artwork's first frame replaces it on schedule. If no loop ends in
+ * time (long or paused animations) the swap happens at deadline_us. A regular
+ * animation_player_cycle_animation(true) meanwhile swaps to the preloaded artwork immediately.
+ * In gallery mode the page is turned right away.
+ *
+ * @param not_before_us Earliest swap time (esp_timer clock)
+ * @param deadline_us Latest swap time once the next animation is loaded
+ * @return ESP_OK if queued, ESP_ERR_INVALID_STATE if a change is already in progress,
+ *         ESP_ERR_NOT_FOUND if there is nothing to change to
+ */
+esp_err_t animation_player_schedule_cycle(int64_t not_before_us, int64_t deadline_us);
+
+/**
+ * @brief Swap to the artwork at a position in the play order at a loop boundary
+ *
+ * Like animation_player_schedule_cycle() with a given target, except that it replaces a pending
+ * change: one to the same target only has its swap window moved, and any is dropped if the
+ * target is already on screen. A window in the past swaps as soon as the artwork is loaded.
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if index is past the file list, ESP_ERR_INVALID_STATE in
+ *         gallery mode
+ */
+esp_err_t animation_player_schedule_asset(size_t index, int64_t not_before_us, int64_t deadline_us);
+
+/**
+ * @brief Time (esp_timer clock) the artwork or gallery page on screen appeared, 0 before playback starts
+ */
+int64_t animation_player_get_shown_since_us(void);
+
+/**
+ * @brief Duration of one loop of the current animation in milliseconds, 0 if unknown
+ */
+uint32_t animation_player_get_loop_duration_ms(void);
+
+/**
+ * @brief Copy the file name of the artwork at a position in the play order
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if index is past the file list
+ */
+esp_err_t animation_player_get_asset_name(size_t index, char *out, size_t len);
+
+/**
+ * @brief Show several artworks at once in a grid
+ *
+ * Each tile plays its own animation on its own timeline. While a gallery is shown,
+ * animation_player_cycle_animation() turns the page instead of changing one artwork.
+ * Takes effect on the render task's next frame.
+ *
+ * @param grid Tiles per side: 2 or 3 for a gallery, 0 or 1 for single-artwork playback
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for unsupported grid sizes
+ */
+esp_err_t animation_player_set_gallery_grid(int grid);
+
+/**
+ * @brief Get the grid currently shown (1 for single-artwork playback)
+ */
+int animation_player_get_gallery_grid(void);
+
+/**
+ * @brief Re-read display settings from the config store
+ *
+ * Rebuilds the colour correction tables and applies the gallery grid; the change
+ * takes effect on the next frame.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t animation_player_apply_config(void);
+
 /**
  * @brief Start animation player task
  *
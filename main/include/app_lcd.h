@@ -75,6 +75,11 @@ void app_lcd_cycle_animation(void);
 
 void app_lcd_cycle_animation_backward(void);
 
+/**
+ * @brief Change to the artwork steps positions away (positive forward), as for a fling
+ */
+void app_lcd_skip_animations(int steps);
+
 /**
  * @brief Get current display brightness
  *
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ASSET_HEALTH_H
+#define ASSET_HEALTH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Why an artwork failed to load
+typedef enum {
+    ASSET_FAILURE_NONE,
+    ASSET_FAILURE_OPEN,      // File could not be opened
+    ASSET_FAILURE_READ,      // Empty file or short read from the SD card
+    ASSET_FAILURE_NO_MEM,    // No memory for the file data or the decoder
+    ASSET_FAILURE_DECODE,    // Decoder rejected the file
+} asset_failure_reason_t;
+
+typedef struct {
+    size_t index;                    // Position in the play order
+    asset_failure_reason_t reason;   // Of the last failure
+    esp_err_t error;                 // Of the last failure
+    uint32_t failures;               // Failures since the last successful load
+    bool quarantined;                // Skipped by navigation until retry_at_us
+    int64_t retry_at_us;             // esp_timer time the artwork is tried again
+} asset_health_record_t;
+
+/**
+ * @brief Start tracking a new play order of count artworks, all healthy
+ *
+ * Called whenever the file list is replaced; records of the previous list are dropped.
+ *
+ * @return ESP_OK, or ESP_ERR_NO_MEM (navigation then steps over every artwork)
+ */
+esp_err_t asset_health_reset(size_t count);
+
+/**
+ * @brief Record a failed load and quarantine the artwork
+ *
+ * The artwork is skipped by navigation until its retry time, which doubles with every
+ * failure since the last successful load (CONFIG_P3A_ASSET_RETRY_BASE_S up to
+ * CONFIG_P3A_ASSET_RETRY_MAX_S).
+ */
+void asset_health_record_failure(size_t index, asset_failure_reason_t reason, esp_err_t error);
+
+/**
+ * @brief Record a successful load, which clears the artwork's failure record
+ */
+void asset_health_record_success(size_t index);
+
+/**
+ * @brief Whether navigation may step onto the artwork (quarantines that are due are lifted first)
+ */
+bool asset_health_is_healthy(size_t index);
+
+/**
+ * @brief Number of artworks navigation may step onto
+ */
+size_t asset_health_healthy_count(void);
+
+/**
+ * @brief Next healthy artwork in play order after index, wrapping around
+ *
+ * Constant time from a healthy artwork. Without tracking for count artworks (allocation
+ * failed) every artwork counts as healthy.
+ *
+ * @return index itself when no other artwork is healthy
+ */
+size_t asset_health_next(size_t index, size_t count);
+
+/**
+ * @brief Previous healthy artwork in play order before index, wrapping around
+ *
+ * @return index itself when no other artwork is healthy
+ */
+size_t asset_health_prev(size_t index, size_t count);
+
+/**
+ * @brief Copy the records of artworks that failed since their last successful load
+ *
+ * @return Number of records copied
+ */
+size_t asset_health_get_failures(asset_health_record_t *out, size_t max);
+
+/**
+ * @brief Short lower-case name of a failure reason ("open", "read", ...)
+ */
+const char *asset_health_reason_name(asset_failure_reason_t reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ASSET_HEALTH_H
@@ -0,0 +1,55 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_PROFILE_MAX_MARKS  24
+
+typedef struct {
+    const char *phase;       // String literal passed to boot_profile_mark()
+    int64_t time_us;         // esp_timer time, which starts right after the bootloader hands over
+} boot_profile_mark_t;
+
+/**
+ * @brief Record that a start-up phase has completed (callable from any task)
+ *
+ * Only the first mark of each phase is kept, so events that repeat after boot (reconnects) do not
+ * fill the table; marks past BOOT_PROFILE_MAX_MARKS are dropped.
+ *
+ * @param phase Static string naming the phase, compared by address
+ */
+void boot_profile_mark(const char *phase);
+
+/**
+ * @brief Record the first frame sent to the panel and log the boot timeline (only the first call counts)
+ */
+void boot_profile_first_frame(void);
+
+/**
+ * @brief Copy the recorded marks in the order they were taken
+ *
+ * @return Number of marks copied
+ */
+size_t boot_profile_get(boot_profile_mark_t *out, size_t max);
+
+/**
+ * @brief Time of the first frame, or 0 while none has been shown
+ */
+int64_t boot_profile_first_frame_us(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef COLOR_PIPELINE_H
+#define COLOR_PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "cJSON.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-device colour correction settings
+typedef struct {
+    float gamma;              // Exponent applied to normalized channels, 1.0 leaves them unchanged
+    uint16_t temperature_k;   // White point, 6500 is neutral; lower is warmer, higher is cooler
+    bool dither;              // Ordered (4x4 Bayer) dithering when packing to RGB565
+} color_pipeline_config_t;
+
+// Lookup tables consumed while packing pixels. Built off the render path, read-only afterwards.
+typedef struct {
+    uint8_t lut8_r[256];      // RGB888: corrected 8-bit channel values
+    uint8_t lut8_g[256];
+    uint8_t lut8_b[256];
+    uint16_t lut565_r[256];   // RGB565: corrected output level with 4 fractional bits
+    uint16_t lut565_g[256];
+    uint16_t lut565_b[256];
+    bool dither;
+} color_pipeline_t;
+
+// 4x4 Bayer thresholds in 1/16 steps of one RGB565 output level
+extern const uint8_t color_pipeline_bayer4[4][4];
+
+/**
+ * @brief Fill a config with the Kconfig defaults
+ */
+void color_pipeline_default_config(color_pipeline_config_t *cfg);
+
+/**
+ * @brief Override defaults with "gamma", "color_temp_k" and "dither" keys from a config object
+ *
+ * Missing or out-of-range keys leave the corresponding field unchanged.
+ */
+void color_pipeline_config_from_json(const cJSON *json, color_pipeline_config_t *cfg);
+
+/**
+ * @brief Rebuild the lookup tables for a new configuration
+ *
+ * Tables are built into the inactive copy and published atomically; the render
+ * task picks them up at the start of its next frame.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a NULL config
+ */
+esp_err_t color_pipeline_configure(const color_pipeline_config_t *cfg);
+
+/**
+ * @brief Latch the most recently published tables for the frame about to be rendered
+ *
+ * @return Tables to use, or NULL when the configuration is an identity mapping
+ *         (the packing step then takes its plain fast path)
+ */
+const color_pipeline_t *color_pipeline_begin_frame(void);
+
+// Pack one 8-bit RGB pixel to RGB565 through the tables, dithered at panel position (x, y)
+static inline uint16_t color_pipeline_pack565(const color_pipeline_t *cp, uint8_t r, uint8_t g, uint8_t b,
+                                              int x, int y)
+{
+    const uint16_t t = cp->dither ? color_pipeline_bayer4[y & 3][x & 3] : 8;
+    const uint16_t r5 = (uint16_t)((cp->lut565_r[r] + t) >> 4);
+    const uint16_t g6 = (uint16_t)((cp->lut565_g[g] + t) >> 4);
+    const uint16_t b5 = (uint16_t)((cp->lut565_b[b] + t) >> 4);
+    return (uint16_t)((r5 << 11) | (g6 << 5) | b5);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // COLOR_PIPELINE_H
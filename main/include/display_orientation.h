@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef DISPLAY_ORIENTATION_H
+#define DISPLAY_ORIENTATION_H
+
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Clockwise rotation of the artwork on the panel, in quarter turns
+#if CONFIG_P3A_DISPLAY_ROTATION_90
+#define DISPLAY_ROTATION_QUARTERS 1
+#elif CONFIG_P3A_DISPLAY_ROTATION_180
+#define DISPLAY_ROTATION_QUARTERS 2
+#elif CONFIG_P3A_DISPLAY_ROTATION_270
+#define DISPLAY_ROTATION_QUARTERS 3
+#else
+#define DISPLAY_ROTATION_QUARTERS 0
+#endif
+
+// Mirroring, applied in the viewer's frame after rotation
+#if CONFIG_P3A_DISPLAY_FLIP_HORIZONTAL
+#define DISPLAY_FLIP_H true
+#else
+#define DISPLAY_FLIP_H false
+#endif
+#if CONFIG_P3A_DISPLAY_FLIP_VERTICAL
+#define DISPLAY_FLIP_V true
+#else
+#define DISPLAY_FLIP_V false
+#endif
+
+// True when the viewer's axes are swapped relative to the panel's (90/270 degrees)
+#define DISPLAY_ORIENTATION_TRANSPOSED ((DISPLAY_ROTATION_QUARTERS & 1) != 0)
+
+/**
+ * @brief Map a point from panel coordinates to the viewer's upright frame
+ *
+ * Inverse of the rotation and flips applied to the artwork, so touch input can be
+ * interpreted in the same frame the viewer sees.
+ *
+ * @param x In: panel column, out: viewer column
+ * @param y In: panel row, out: viewer row
+ * @param panel_w Panel width
+ * @param panel_h Panel height
+ */
+static inline void display_orientation_panel_to_view(int *x, int *y, int panel_w, int panel_h)
+{
+    int vx, vy;
+    switch (DISPLAY_ROTATION_QUARTERS) {
+    case 1:
+        vx = *y;
+        vy = panel_w - 1 - *x;
+        break;
+    case 2:
+        vx = panel_w - 1 - *x;
+        vy = panel_h - 1 - *y;
+        break;
+    case 3:
+        vx = panel_h - 1 - *y;
+        vy = *x;
+        break;
+    default:
+        vx = *x;
+        vy = *y;
+        break;
+    }
+    const int view_w = DISPLAY_ORIENTATION_TRANSPOSED ? panel_h : panel_w;
+    const int view_h = DISPLAY_ORIENTATION_TRANSPOSED ? panel_w : panel_h;
+    if (DISPLAY_FLIP_H) {
+        vx = view_w - 1 - vx;
+    }
+    if (DISPLAY_FLIP_V) {
+        vy = view_h - 1 - vy;
+    }
+    *x = vx;
+    *y = vy;
+}
+
+/**
+ * @brief Map a point from the viewer's upright frame to panel coordinates
+ *
+ * Inverse of display_orientation_panel_to_view().
+ *
+ * @param x In: viewer column, out: panel column
+ * @param y In: viewer row, out: panel row
+ * @param panel_w Panel width
+ * @param panel_h Panel height
+ */
+static inline void display_orientation_view_to_panel(int *x, int *y, int panel_w, int panel_h)
+{
+    const int view_w = DISPLAY_ORIENTATION_TRANSPOSED ? panel_h : panel_w;
+    const int view_h = DISPLAY_ORIENTATION_TRANSPOSED ? panel_w : panel_h;
+    int vx = DISPLAY_FLIP_H ? (view_w - 1 - *x) : *x;
+    int vy = DISPLAY_FLIP_V ? (view_h - 1 - *y) : *y;
+    switch (DISPLAY_ROTATION_QUARTERS) {
+    case 1:
+        *x = panel_w - 1 - vy;
+        *y = vx;
+        break;
+    case 2:
+        *x = panel_w - 1 - vx;
+        *y = panel_h - 1 - vy;
+        break;
+    case 3:
+        *x = vy;
+        *y = panel_h - 1 - vx;
+        break;
+    default:
+        *x = vx;
+        *y = vy;
+        break;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DISPLAY_ORIENTATION_H
@@ -0,0 +1,136 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FRAME_BACKGROUND_H
+#define FRAME_BACKGROUND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "cJSON.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What transparent pixels are composited over
+typedef enum {
+    FRAME_BACKGROUND_SOLID,
+    FRAME_BACKGROUND_CHECKER,
+    FRAME_BACKGROUND_IMAGE,
+} frame_background_mode_t;
+
+#define FRAME_BACKGROUND_IMAGE_PATH_MAX 128
+
+typedef struct {
+    frame_background_mode_t mode;
+    uint32_t color;           // 0xRRGGBB, solid colour and first checker colour
+    uint32_t checker_color;   // 0xRRGGBB, second checker colour
+    uint8_t checker_shift;    // Checker squares are (1 << checker_shift) panel pixels wide
+    char image_path[FRAME_BACKGROUND_IMAGE_PATH_MAX];
+} frame_background_config_t;
+
+// Published background, read by the packing step. The image is panel-sized RGB (R, G, B bytes).
+typedef struct {
+    frame_background_mode_t mode;
+    uint8_t rgb[2][3];
+    uint8_t checker_shift;
+    const uint8_t *image;
+    int image_w;
+    int image_h;
+} frame_background_t;
+
+/**
+ * @brief Fill a config with the Kconfig defaults
+ */
+void frame_background_default_config(frame_background_config_t *cfg);
+
+/**
+ * @brief Override defaults with the "background", "background_color" and "background_image" config keys
+ *
+ * "background" is "solid", "checker" or "image"; colours are "#RRGGBB" strings or numbers.
+ */
+void frame_background_config_from_json(const cJSON *json, frame_background_config_t *cfg);
+
+/**
+ * @brief Publish a new background
+ *
+ * For FRAME_BACKGROUND_IMAGE the caller passes the decoded image (RGBA, any size); it is
+ * scaled to the panel once here. A missing image falls back to the solid colour.
+ *
+ * @param cfg Background settings
+ * @param image_rgba Decoded image for image mode, may be NULL
+ * @param image_w Image width
+ * @param image_h Image height
+ * @param panel_w Panel width
+ * @param panel_h Panel height
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the panel-sized image could not be allocated
+ */
+esp_err_t frame_background_configure(const frame_background_config_t *cfg,
+                                     const uint8_t *image_rgba, int image_w, int image_h,
+                                     int panel_w, int panel_h);
+
+/**
+ * @brief Latch the most recently published background for the frame about to be rendered
+ */
+const frame_background_t *frame_background_begin_frame(void);
+
+/**
+ * @brief Solid colour transparent pixels of indexed formats can be pre-blended with
+ *
+ * @param rgb Output colour
+ * @return true when the background is a uniform colour, false for checker or image
+ */
+bool frame_background_uniform_color(uint8_t rgb[3]);
+
+// Background colour at panel position (x, y)
+static inline const uint8_t *frame_background_pixel(const frame_background_t *bg, int x, int y)
+{
+    switch (bg->mode) {
+    case FRAME_BACKGROUND_CHECKER:
+        return bg->rgb[((x >> bg->checker_shift) ^ (y >> bg->checker_shift)) & 1];
+    case FRAME_BACKGROUND_IMAGE:
+        if (bg->image && x < bg->image_w && y < bg->image_h) {
+            return bg->image + ((size_t)y * bg->image_w + x) * 3;
+        }
+        return bg->rgb[0];
+    case FRAME_BACKGROUND_SOLID:
+    default:
+        return bg->rgb[0];
+    }
+}
+
+// Composite one straight-alpha RGBA pixel over the background at panel position (x, y)
+static inline void frame_background_composite(const frame_background_t *bg, const uint8_t *rgba,
+                                              int x, int y, uint8_t out[3])
+{
+    const uint32_t a = rgba[3];
+    if (a == 255) {
+        out[0] = rgba[0];
+        out[1] = rgba[1];
+        out[2] = rgba[2];
+        return;
+    }
+    const uint8_t *under = frame_background_pixel(bg, x, y);
+    if (a == 0) {
+        out[0] = under[0];
+        out[1] = under[1];
+        out[2] = under[2];
+        return;
+    }
+    // x * a / 255 via the exact (v + 128 + ((v + 128) >> 8)) >> 8 rounding
+    const uint32_t ia = 255U - a;
+    for (int c = 0; c < 3; ++c) {
+        const uint32_t v = (uint32_t)rgba[c] * a + (uint32_t)under[c] * ia + 128U;
+        out[c] = (uint8_t)((v + (v >> 8)) >> 8);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_BACKGROUND_H
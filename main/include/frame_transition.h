@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef FRAME_TRANSITION_H
+#define FRAME_TRANSITION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Transition style used when the player swaps to a new animation
+typedef enum {
+    FRAME_TRANSITION_NONE,
+    FRAME_TRANSITION_CROSSFADE,
+    FRAME_TRANSITION_WIPE,
+    FRAME_TRANSITION_IRIS,
+} frame_transition_type_t;
+
+// Transition state - blends a snapshot of the outgoing frame over the incoming frames
+typedef struct {
+    frame_transition_type_t type;
+    const uint8_t *from_frame;  // Panel-format snapshot of the last outgoing frame
+    uint16_t step;              // Current step, 1..steps while active
+    uint16_t steps;             // Number of display frames the transition lasts
+    int width;
+    int height;
+    size_t row_stride_bytes;
+    size_t bytes_per_pixel;     // 2 (RGB565) or 3 (RGB888)
+} frame_transition_t;
+
+/**
+ * @brief Start a transition
+ *
+ * @param t Transition state to initialize
+ * @param type Transition style (FRAME_TRANSITION_NONE leaves the transition inactive)
+ * @param from_frame Snapshot of the outgoing frame, must stay valid until the transition ends
+ * @param steps Number of display frames the transition lasts
+ * @param width Frame width in pixels
+ * @param height Frame height in pixels
+ * @param row_stride_bytes Row stride of both the snapshot and the destination frames
+ * @param bytes_per_pixel 2 for RGB565, 3 for RGB888
+ */
+void frame_transition_begin(frame_transition_t *t, frame_transition_type_t type, const uint8_t *from_frame,
+                            uint16_t steps, int width, int height,
+                            size_t row_stride_bytes, size_t bytes_per_pixel);
+
+/**
+ * @brief Check whether a transition is in progress
+ */
+bool frame_transition_active(const frame_transition_t *t);
+
+/**
+ * @brief Blend the outgoing snapshot into rows of a freshly rendered incoming frame
+ *
+ * Only touches rows [row_start, row_end), so it can run on the upscale workers
+ * right after they finish their share of the frame.
+ *
+ * @param t Active transition
+ * @param dst Incoming frame (panel format), modified in place
+ * @param row_start First row to process
+ * @param row_end One past the last row to process
+ */
+void frame_transition_apply_rows(const frame_transition_t *t, uint8_t *dst, int row_start, int row_end);
+
+/**
+ * @brief Advance the transition by one displayed frame, ending it after the last step
+ */
+void frame_transition_advance(frame_transition_t *t);
+
+/**
+ * @brief Abort a transition immediately
+ */
+void frame_transition_cancel(frame_transition_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_TRANSITION_H
@@ -0,0 +1,74 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Monotonic counters exported as p3a_<name>_total
+typedef enum {
+    METRICS_FRAMES_PRESENTED,
+    METRICS_FRAMES_LATE,         // Frame finished after its pacing deadline
+    METRICS_SWAPS,
+    METRICS_LOADS,
+    METRICS_LOAD_FAILURES,
+    METRICS_LOADS_CANCELLED,     // Loads abandoned because navigation moved past the artwork
+    METRICS_SD_READ_BYTES,
+    METRICS_PREFETCH_HITS,       // First frame after a swap came from the prefetched copy
+    METRICS_PREFETCH_MISSES,     // ... or had to be decoded on the render path
+    METRICS_COUNTER_COUNT,
+} metrics_counter_t;
+
+// Histograms exported as p3a_<name>_seconds
+typedef enum {
+    METRICS_DECODE_TIME,
+    METRICS_UPSCALE_TIME,
+    METRICS_PRESENT_TIME,
+    METRICS_LOAD_TIME,
+    METRICS_SWAP_LATENCY,        // User swap request to first frame of the new artwork
+    METRICS_TOUCH_LATENCY,       // Touch controller INT (or poll read) to the gesture's action
+    METRICS_HISTOGRAM_COUNT,
+} metrics_histogram_t;
+
+/**
+ * @brief Add to a counter (safe from any task, a few instructions under a spinlock)
+ */
+void metrics_add(metrics_counter_t counter, uint64_t value);
+
+/**
+ * @brief Record one observation in microseconds
+ */
+void metrics_observe_us(metrics_histogram_t histogram, int64_t duration_us);
+
+/**
+ * @brief Render all player, heap and task metrics in Prometheus text format
+ *
+ * Nothing is allocated: counters are snapshotted under the spinlock and formatted into buf.
+ * Lines that do not fit are dropped whole.
+ *
+ * @return Length of the text in buf (always NUL-terminated)
+ */
+size_t metrics_render(char *buf, size_t size);
+
+/**
+ * @brief Append one formatted line to a metrics buffer
+ *
+ * @return New length; unchanged when the line does not fit
+ */
+size_t metrics_appendf(char *buf, size_t size, size_t len, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METRICS_H
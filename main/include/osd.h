@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef OSD_H
+#define OSD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Text elements, drawn right-aligned along the top edge of the view
+typedef enum {
+    OSD_TEXT_FRAME_TIME,
+    OSD_TEXT_COUNT,
+} osd_text_t;
+
+// Status icons, laid out left to right from the top-left corner of the view in this order
+typedef enum {
+    OSD_ICON_WIFI_OFF,
+    OSD_ICON_PAUSED,
+    OSD_ICON_LOADING,   // Animated spinner
+    OSD_ICON_COUNT,
+} osd_icon_t;
+
+// Edge of the view highlighted as navigation feedback, the side the user navigated towards
+typedef enum {
+    OSD_EDGE_NONE,
+    OSD_EDGE_LEFT,
+    OSD_EDGE_RIGHT,
+} osd_edge_t;
+
+// One horizontal span of opaque OSD pixels in panel coordinates
+typedef struct {
+    uint16_t y;
+    uint16_t x;
+    uint16_t len;
+    uint8_t color;      // Index of the panel-format colour row the span is copied from
+    uint8_t reserved;
+} osd_run_t;
+
+// Rasterized OSD layer: spans sorted by row, plus the rectangle they cover
+typedef struct {
+    const osd_run_t *runs;
+    size_t run_count;
+    int x0;             // Dirty rectangle [x0, x1) x [y0, y1) in panel coordinates
+    int x1;
+    int y0;
+    int y1;
+} osd_layer_t;
+
+/**
+ * @brief Build the glyph atlas for the panel
+ *
+ * Glyphs and icons are rasterized once at the configured scale, already rotated and
+ * mirrored into panel orientation, so composing the layer is a sequence of row copies.
+ *
+ * @param panel_w Panel width in pixels
+ * @param panel_h Panel height in pixels
+ * @param bytes_per_pixel 2 for RGB565, 3 for RGB888
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the atlas cannot be allocated
+ */
+esp_err_t osd_init(int panel_w, int panel_h, size_t bytes_per_pixel);
+
+/**
+ * @brief Show a text element, or hide it with NULL or an empty string
+ *
+ * Supports digits, '.', '-', ':', '%' and space. Setting the same text and colour again is free.
+ *
+ * @param id Text element
+ * @param text Text to show
+ * @param rgb Colour as 0xRRGGBB
+ */
+void osd_set_text(osd_text_t id, const char *text, uint32_t rgb);
+
+/**
+ * @brief Show or hide a status icon (no-op unless CONFIG_P3A_OSD_STATUS_ICONS is enabled)
+ */
+void osd_set_icon(osd_icon_t icon, bool visible);
+
+/**
+ * @brief Show a bar along the left or right edge of the view, or hide it with OSD_EDGE_NONE
+ *
+ * No-op unless CONFIG_P3A_OSD_TAP_FEEDBACK is enabled.
+ */
+void osd_set_edge(osd_edge_t edge);
+
+/**
+ * @brief Rebuild the layer if anything changed and latch it for the frame about to be rendered
+ *
+ * Must be called from the render task while no composition is in flight.
+ *
+ * @param now_us Current time, drives the spinner animation
+ * @param[out] changed Set when the layer differs from the previous frame's
+ * @return Layer to compose, or NULL when nothing is shown
+ */
+const osd_layer_t *osd_begin_frame(int64_t now_us, bool *changed);
+
+/**
+ * @brief Copy the layer's spans that fall in rows [row_start, row_end) into a frame
+ *
+ * Safe to call concurrently for disjoint row ranges, so it runs on the upscale workers.
+ *
+ * @param layer Layer returned by osd_begin_frame()
+ * @param frame Panel-format frame buffer
+ * @param row_stride_bytes Frame row stride
+ * @param row_start First row to compose
+ * @param row_end One past the last row to compose
+ */
+void osd_compose_rows(const osd_layer_t *layer, uint8_t *frame, size_t row_stride_bytes,
+                      int row_start, int row_end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OSD_H
@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PERF_TRACE_H
+#define PERF_TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Traced spans; names in the exported trace come from perf_trace.c
+typedef enum {
+    PERF_TRACE_RENDER_FRAME,     // render_next_frame()
+    PERF_TRACE_DECODE,           // animation_decoder_decode_next() on the render path
+    PERF_TRACE_UPSCALE_WAIT,     // Render task waiting for both upscale workers
+    PERF_TRACE_UPSCALE_ROWS,     // One worker's share of a blit, prescale or gallery job
+    PERF_TRACE_CACHE_FLUSH,      // esp_cache_msync() of a frame
+    PERF_TRACE_PACING_WAIT,      // Residual frame delay / sync wall deadline
+    PERF_TRACE_VSYNC_WAIT,       // Waiting for the panel refresh
+    PERF_TRACE_PRESENT,          // esp_lcd_panel_draw_bitmap()
+    PERF_TRACE_PREFETCH,         // prefetch_first_frame()
+    PERF_TRACE_LOAD_FILE,        // load_animation_file_from_sd()
+    PERF_TRACE_SWAP,             // swap_buffers()
+    PERF_TRACE_BUFFER_MUTEX,     // Blocked on the player's buffer mutex
+    PERF_TRACE_EVENT_COUNT,
+} perf_trace_event_t;
+
+#if CONFIG_P3A_TRACE_ENABLE
+
+/**
+ * @brief Append a begin or end event to the calling core's ring
+ *
+ * Wait-free: one atomic increment and a 16-byte store, safe from any task.
+ */
+void perf_trace_record(perf_trace_event_t event, bool begin);
+
+#define PERF_TRACE_BEGIN(event) perf_trace_record((event), true)
+#define PERF_TRACE_END(event)   perf_trace_record((event), false)
+
+#else
+
+#define PERF_TRACE_BEGIN(event) do { } while (0)
+#define PERF_TRACE_END(event)   do { } while (0)
+
+#endif
+
+/**
+ * @brief Allocate the per-core rings and start recording (no-op unless CONFIG_P3A_TRACE_ENABLE)
+ *
+ * @return ESP_OK on success (or when tracing is compiled out), ESP_ERR_NO_MEM otherwise
+ */
+esp_err_t perf_trace_init(void);
+
+/**
+ * @brief True when tracing is compiled in and the rings are allocated
+ */
+bool perf_trace_available(void);
+
+// Sink for perf_trace_dump_json(); return anything but ESP_OK to abort the dump
+typedef esp_err_t (*perf_trace_write_fn)(void *ctx, const char *chunk, size_t len);
+
+/**
+ * @brief Export the rings as Chrome trace-event JSON (loads in Perfetto and chrome://tracing)
+ *
+ * Recording is paused while the rings are read and resumes afterwards. Output is produced in
+ * small chunks, so nothing the size of the trace is allocated.
+ *
+ * @param write Called with consecutive pieces of the JSON document
+ * @param ctx Passed to write
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED when tracing is unavailable, or the sink's error
+ */
+esp_err_t perf_trace_dump_json(perf_trace_write_fn write, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PERF_TRACE_H
@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PIXEL_SCALERS_H
+#define PIXEL_SCALERS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Edge-aware integer pre-scalers for pixel art, run before the final nearest-neighbour pass
+typedef enum {
+    PIXEL_SCALER_NONE,      // Nearest neighbour only
+    PIXEL_SCALER_SCALE2X,   // Scale2x / EPX, 2x
+    PIXEL_SCALER_SCALE3X,   // Scale3x, 3x
+    PIXEL_SCALER_XBR_LITE,  // Scale2x rules with fuzzy colour matching and blended corners, 2x
+} pixel_scaler_t;
+
+/**
+ * @brief Integer factor a scaler multiplies each axis by (1 for PIXEL_SCALER_NONE)
+ */
+int pixel_scaler_factor(pixel_scaler_t scaler);
+
+/**
+ * @brief Pick the scaler to use for a canvas
+ *
+ * Falls back to a smaller factor (or none) when the scaled canvas would exceed the
+ * target, since downsampling an edge-aware result afterwards only wastes time.
+ *
+ * @param preferred Configured scaler
+ * @param src_w Canvas width
+ * @param src_h Canvas height
+ * @param max_w Width the result is scaled to afterwards
+ * @param max_h Height the result is scaled to afterwards
+ */
+pixel_scaler_t pixel_scaler_select(pixel_scaler_t preferred, int src_w, int src_h, int max_w, int max_h);
+
+/**
+ * @brief Scale source rows [row_start, row_end) of an RGBA frame
+ *
+ * Each source row produces factor output rows, so disjoint source ranges can be
+ * processed in parallel. Neighbouring rows are read, never written.
+ *
+ * @param scaler Scaler to apply (not PIXEL_SCALER_NONE)
+ * @param src RGBA source frame, src_w * src_h pixels, 4-byte aligned
+ * @param src_w Source width
+ * @param src_h Source height
+ * @param dst RGBA output frame, (src_w * factor) * (src_h * factor) pixels, 4-byte aligned
+ * @param row_start First source row to process
+ * @param row_end One past the last source row to process
+ */
+void pixel_scaler_run_rows(pixel_scaler_t scaler, const uint8_t *src, int src_w, int src_h,
+                           uint8_t *dst, int row_start, int row_end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PIXEL_SCALERS_H
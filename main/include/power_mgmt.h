@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef POWER_MGMT_H
+#define POWER_MGMT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPU frequency and sleep policy of the player. With CONFIG_PM_ENABLE the CPU runs at the
+// minimum frequency unless a pipeline task is inside a busy section; without it only the
+// residency figures are kept, so they show how much of the time a lock would be held.
+
+typedef struct {
+    bool pm_enabled;             // Built with CONFIG_PM_ENABLE and esp_pm_configure() succeeded
+    bool light_sleep;            // Light sleep allowed while the display is blanked
+    int max_freq_mhz;
+    int min_freq_mhz;
+    uint64_t busy_us;            // Time at least one busy section was open (CPU at max frequency)
+    uint64_t busy_sections;      // Busy sections opened while none was
+    uint64_t blanked_us;         // Time the display was blanked
+} power_mgmt_stats_t;
+
+/**
+ * @brief Configure dynamic frequency scaling and create the locks (call once, before the player starts)
+ *
+ * @return ESP_OK, also when built without CONFIG_PM_ENABLE; otherwise the esp_pm error,
+ *         after which the CPU stays at its default frequency
+ */
+esp_err_t power_mgmt_init(void);
+
+/**
+ * @brief Enter a section that needs the maximum CPU frequency (decoding, upscaling, loading)
+ *
+ * Sections nest and may be open on several tasks at once; each needs its power_mgmt_busy_end().
+ */
+void power_mgmt_busy_begin(void);
+
+/**
+ * @brief Leave a busy section; the CPU drops to the minimum frequency once none is open
+ */
+void power_mgmt_busy_end(void);
+
+/**
+ * @brief Tell whether the panel is lit; light sleep is only allowed while it is not
+ *
+ * The DPI panel is refreshed from PSRAM continuously, which light sleep would stop. Cheap to call
+ * every frame: only changes take effect.
+ */
+void power_mgmt_set_display_lit(bool lit);
+
+/**
+ * @brief Copy the configuration and residency figures (callable from any task)
+ */
+void power_mgmt_get_stats(power_mgmt_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_MGMT_H
@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TASK_STATS_MAX_TASKS    32
+#define TASK_STATS_NAME_LEN     16
+
+// Sliding windows the CPU figures are averaged over
+typedef enum {
+    TASK_STATS_WINDOW_1S,
+    TASK_STATS_WINDOW_10S,
+    TASK_STATS_WINDOW_60S,
+    TASK_STATS_WINDOW_COUNT,
+} task_stats_window_t;
+
+typedef struct {
+    char name[TASK_STATS_NAME_LEN];
+    int core;                                   // Pinned core, or -1 when the task may run on either
+    uint32_t priority;                          // Current priority (raised while inheriting a mutex)
+    uint32_t base_priority;
+    uint32_t stack_free_min;                    // Lowest free stack seen, in bytes
+    uint64_t cpu_total_us;                      // Run time since the task was created, as of the last sample
+    uint16_t cpu_permille[TASK_STATS_WINDOW_COUNT];  // Share of one core, 1000 = a full core
+} task_stats_task_t;
+
+typedef struct {
+    bool running;
+    uint32_t window_s[TASK_STATS_WINDOW_COUNT]; // Seconds actually covered (shorter right after boot)
+    uint16_t core_busy_permille[portNUM_PROCESSORS][TASK_STATS_WINDOW_COUNT];
+    size_t task_count;
+    task_stats_task_t tasks[TASK_STATS_MAX_TASKS];
+    // Player buffer mutex contention
+    uint32_t lock_contended;                    // Takes that had to block
+    uint32_t lock_inversions;                   // ... past the bound, with the holder preempted
+    int64_t lock_max_wait_us;
+    int64_t lock_last_inversion_wait_us;
+    char lock_last_waiter[TASK_STATS_NAME_LEN];
+    char lock_last_holder[TASK_STATS_NAME_LEN];
+} task_stats_report_t;
+
+/**
+ * @brief Start the sampler task (once per second; no-op unless CONFIG_P3A_TASK_STATS_ENABLE)
+ */
+esp_err_t task_stats_start(void);
+
+/**
+ * @brief Fill a report with the latest windows
+ *
+ * @return ESP_OK, or ESP_ERR_INVALID_STATE before the sampler runs
+ */
+esp_err_t task_stats_get(task_stats_report_t *out);
+
+/**
+ * @brief Record a blocking mutex take by the calling task
+ *
+ * Blocking on a lower-priority holder is normal and bounded: priority inheritance lets it finish
+ * its short critical section. Only a holder that is ready but not running once the wait has
+ * outlasted task_stats_inversion_bound_ticks() counts as an inversion.
+ *
+ * @param holder Task that held the mutex when the caller started waiting
+ * @param holder_priority Holder's priority at that moment
+ * @param wait_us Time spent blocked
+ * @param holder_preempted The holder was ready but not running when the bound passed
+ */
+void task_stats_note_lock_wait(TaskHandle_t holder, UBaseType_t holder_priority, int64_t wait_us,
+                               bool holder_preempted);
+
+/**
+ * @brief How long a blocked take waits before checking whether the holder is running
+ */
+static inline TickType_t task_stats_inversion_bound_ticks(void)
+{
+#if CONFIG_P3A_TASK_STATS_ENABLE
+    const TickType_t ticks = pdMS_TO_TICKS(CONFIG_P3A_TASK_STATS_INVERSION_BOUND_MS);
+    return (ticks > 0) ? ticks : 1;
+#else
+    return portMAX_DELAY;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_STATS_H
@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TASK_TOPOLOGY_H
+#define TASK_TOPOLOGY_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pipeline tasks whose placement is configurable
+typedef enum {
+    TASK_TOPOLOGY_RENDER,            // lcd_anim
+    TASK_TOPOLOGY_UPSCALE_TOP,       // upscale_top
+    TASK_TOPOLOGY_UPSCALE_BOTTOM,    // upscale_bottom
+    TASK_TOPOLOGY_LOADER,            // anim_loader
+    TASK_TOPOLOGY_TOUCH,             // app_touch_task
+    TASK_TOPOLOGY_AUTO_SWAP,         // auto_swap
+    TASK_TOPOLOGY_HTTP_WORKER,       // api_worker
+    TASK_TOPOLOGY_COUNT,
+} task_topology_id_t;
+
+#define TASK_TOPOLOGY_ANY_CORE  (-1)
+
+typedef struct {
+    const char *name;                // Task name, also the key in the "tasks" config object
+    int core;                        // 0/1, or TASK_TOPOLOGY_ANY_CORE
+    UBaseType_t priority;
+    uint32_t stack_size;             // Bytes
+} task_topology_entry_t;
+
+/**
+ * @brief Build the table from Kconfig and apply the "tasks" overrides of the config store
+ *
+ * The config object maps task names to {"core": 0|1|null, "priority": n, "stack": bytes}; any
+ * field may be left out. Overrides only affect tasks created afterwards, so call this once
+ * before the player starts (changes take effect on the next boot).
+ */
+esp_err_t task_topology_load(void);
+
+/**
+ * @brief Placement of one task (Kconfig defaults until task_topology_load() has run)
+ */
+const task_topology_entry_t *task_topology_get(task_topology_id_t id);
+
+/**
+ * @brief Create a pipeline task with its configured name, affinity, priority and stack size
+ */
+BaseType_t task_topology_create(task_topology_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *out_handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TASK_TOPOLOGY_H
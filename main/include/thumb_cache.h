@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef THUMB_CACHE_H
+#define THUMB_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Thumbnails are square, in the panel's pixel format and the viewer's orientation (row-major,
+// top row first), with the artwork's first frame fitted and centred over black
+#if CONFIG_P3A_THUMB_SIZE_180
+#define THUMB_CACHE_SIDE  180
+#else
+#define THUMB_CACHE_SIDE  90
+#endif
+
+/**
+ * @brief Open the packed thumbnail file, creating it when missing or laid out for another size
+ *
+ * @param path File on the SD card holding every thumbnail plus their index
+ * @param bytes_per_pixel 2 for RGB565, 3 for RGB888
+ * @return ESP_OK, or the error that left the cache unavailable (every lookup then misses)
+ */
+esp_err_t thumb_cache_open(const char *path, size_t bytes_per_pixel);
+
+/**
+ * @brief Close the file; lookups miss until the next thumb_cache_open()
+ */
+void thumb_cache_close(void);
+
+/**
+ * @brief Size in bytes of one thumbnail, 0 while the cache is closed
+ */
+size_t thumb_cache_thumb_bytes(void);
+
+/**
+ * @brief Whether the artwork with this file name has a thumbnail
+ */
+bool thumb_cache_has(const char *name);
+
+/**
+ * @brief Drop the thumbnail of an artwork whose file no longer has the size it was made from
+ */
+void thumb_cache_check(const char *name, uint32_t asset_size);
+
+/**
+ * @brief Store a thumbnail of thumb_cache_thumb_bytes() bytes
+ *
+ * When the index is full the oldest entries are overwritten in turn.
+ *
+ * @param asset_size Size of the artwork's file, for thumb_cache_check()
+ */
+esp_err_t thumb_cache_store(const char *name, uint32_t asset_size, const uint8_t *pixels);
+
+/**
+ * @brief Copy an artwork's thumbnail into out (callable from any task)
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND without a thumbnail, ESP_ERR_INVALID_SIZE if len is too small
+ */
+esp_err_t thumb_cache_read(const char *name, uint8_t *out, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THUMB_CACHE_H
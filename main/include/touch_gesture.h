@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef TOUCH_GESTURE_H
+#define TOUCH_GESTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Gesture recognition over touch samples. Plain C with no ESP-IDF dependencies, so recorded
+// traces (app_touch logs every sample at verbose level as "sample <t_us> <pressed> <x> <y>")
+// can be replayed through it on a host.
+
+typedef struct {
+    uint16_t screen_w;            // Viewer's frame, after rotation
+    uint16_t screen_h;
+    uint16_t min_swipe_height;    // Vertical travel that turns a touch into a brightness swipe
+    int max_brightness_delta;     // Percentage points for a swipe over the full height
+    uint16_t touch_slop;          // Travel below which a contact still counts as holding still
+    int64_t long_press_us;        // Hold time that starts scrubbing
+    int fling_min_velocity;       // Horizontal speed (px/s) at release that skips one artwork
+    int fling_velocity_per_item;  // Further speed (px/s) per additional artwork skipped
+    int fling_max_items;
+} touch_gesture_config_t;
+
+typedef struct {
+    int64_t t_us;                 // When the contact state was observed (interrupt or read time)
+    bool pressed;
+    uint16_t x;                   // Viewer's frame
+    uint16_t y;
+} touch_sample_t;
+
+typedef enum {
+    TOUCH_GESTURE_NONE,
+    TOUCH_GESTURE_TAP_LEFT,           // Released without a swipe, started in the left half
+    TOUCH_GESTURE_TAP_RIGHT,
+    TOUCH_GESTURE_BRIGHTNESS_START,   // Vertical travel passed min_swipe_height
+    TOUCH_GESTURE_BRIGHTNESS,         // brightness_delta relative to the brightness at the start
+    TOUCH_GESTURE_BRIGHTNESS_END,
+    TOUCH_GESTURE_FLING_PREDICT,      // Horizontal drag fast enough to fling; steps is where it would land
+    TOUCH_GESTURE_FLING,              // Released with steps artworks to skip (positive is forward)
+    TOUCH_GESTURE_SCRUB_START,        // Held still for long_press_us
+    TOUCH_GESTURE_SCRUB,              // scrub_permille of the width dragged since the start
+    TOUCH_GESTURE_SCRUB_END,
+} touch_gesture_type_t;
+
+typedef struct {
+    touch_gesture_type_t type;
+    int64_t t_us;                 // Sample that produced the event
+    int64_t down_us;              // Start of the contact
+    uint16_t x;                   // Where the contact started
+    uint16_t y;
+    int brightness_delta;         // TOUCH_GESTURE_BRIGHTNESS only
+    int steps;                    // TOUCH_GESTURE_FLING and TOUCH_GESTURE_FLING_PREDICT
+    int scrub_permille;           // TOUCH_GESTURE_SCRUB, negative to the left
+} touch_gesture_event_t;
+
+typedef enum {
+    TOUCH_GESTURE_STATE_IDLE,         // No active touch
+    TOUCH_GESTURE_STATE_TAP,          // Potential tap (minimal movement so far)
+    TOUCH_GESTURE_STATE_BRIGHTNESS,   // Vertical swipe controlling brightness
+    TOUCH_GESTURE_STATE_HORIZONTAL,   // Horizontal drag, a fling if fast enough at release
+    TOUCH_GESTURE_STATE_SCRUB,        // Long press, horizontal travel scrubs the animation
+} touch_gesture_state_t;
+
+// Recent pressed samples for the velocity estimate
+#define TOUCH_GESTURE_HISTORY  8
+
+typedef struct {
+    touch_gesture_config_t config;
+    touch_gesture_state_t state;
+    int64_t down_us;
+    uint16_t start_x;
+    uint16_t start_y;
+    uint16_t baseline_y;          // Finger position when the brightness swipe started
+    int predicted_steps;          // Last TOUCH_GESTURE_FLING_PREDICT sent for this drag
+    touch_sample_t history[TOUCH_GESTURE_HISTORY];
+    unsigned history_len;
+    unsigned history_head;        // Slot the next sample goes into
+} touch_gesture_t;
+
+/**
+ * @brief Reset a recognizer to the idle state
+ */
+void touch_gesture_init(touch_gesture_t *g, const touch_gesture_config_t *config);
+
+/**
+ * @brief Feed one sample; at most one event results
+ *
+ * Samples must come in time order. A released sample while idle is ignored, so polling
+ * an untouched panel produces no events.
+ */
+touch_gesture_event_t touch_gesture_feed(touch_gesture_t *g, const touch_sample_t *sample);
+
+/**
+ * @brief Finger velocity in px/s over the last 100 ms of the contact (0 with fewer than two samples)
+ */
+void touch_gesture_velocity(const touch_gesture_t *g, int *vx, int *vy);
+
+/**
+ * @brief Whether a contact is in progress
+ */
+static inline bool touch_gesture_active(const touch_gesture_t *g)
+{
+    return g->state != TOUCH_GESTURE_STATE_IDLE;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TOUCH_GESTURE_H
@@ -218,6 +218,7 @@ esp_err_t jpeg_decoder_get_info_wrapper(animation_decoder_t *decoder, animation_
     info->canvas_height = jpeg_data->canvas_height;
     info->frame_count = 1; // JPEG is always single frame
     info->has_transparency = false; // JPEG doesn't support transparency
+    info->loop_duration_ms = STATIC_IMAGE_FRAME_DELAY_MS;
 
     return ESP_OK;
 }
@@ -0,0 +1,273 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "metrics.h"
+#include "power_mgmt.h"
+#include "task_stats.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define METRICS_BUCKETS     9
+
+typedef struct {
+    const char *name;
+    const char *help;
+    const int64_t *bounds_us;    // METRICS_BUCKETS upper bounds, the +Inf bucket is implicit
+    const char *const *le;       // Bounds as Prometheus "le" labels (seconds)
+} histogram_desc_t;
+
+typedef struct {
+    uint32_t buckets[METRICS_BUCKETS + 1];
+    uint32_t count;
+    uint64_t sum_us;
+} histogram_t;
+
+typedef struct {
+    uint64_t counters[METRICS_COUNTER_COUNT];
+    histogram_t histograms[METRICS_HISTOGRAM_COUNT];
+} metrics_state_t;
+
+static const int64_t s_frame_bounds_us[METRICS_BUCKETS] = {
+    1000, 2000, 4000, 8000, 16000, 33000, 66000, 133000, 266000,
+};
+static const char *const s_frame_le[METRICS_BUCKETS] = {
+    "0.001", "0.002", "0.004", "0.008", "0.016", "0.033", "0.066", "0.133", "0.266",
+};
+static const int64_t s_load_bounds_us[METRICS_BUCKETS] = {
+    25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000,
+};
+static const char *const s_load_le[METRICS_BUCKETS] = {
+    "0.025", "0.05", "0.1", "0.25", "0.5", "1", "2.5", "5", "10",
+};
+
+static const struct {
+    const char *name;
+    const char *help;
+} s_counter_desc[METRICS_COUNTER_COUNT] = {
+    [METRICS_FRAMES_PRESENTED] = { "p3a_frames_presented_total", "Frames sent to the panel" },
+    [METRICS_FRAMES_LATE] = { "p3a_frames_late_total", "Paced frames whose rendering overran the frame delay" },
+    [METRICS_SWAPS] = { "p3a_swaps_total", "Artwork swaps" },
+    [METRICS_LOADS] = { "p3a_loads_total", "Artworks loaded from the SD card" },
+    [METRICS_LOAD_FAILURES] = { "p3a_load_failures_total", "Artworks that failed to load" },
+    [METRICS_LOADS_CANCELLED] = { "p3a_loads_cancelled_total", "Loads cancelled before they finished" },
+    [METRICS_SD_READ_BYTES] = { "p3a_sd_read_bytes_total", "Bytes read from the SD card" },
+    [METRICS_PREFETCH_HITS] = { "p3a_prefetch_hits_total", "Swaps whose first frame was already decoded" },
+    [METRICS_PREFETCH_MISSES] = { "p3a_prefetch_misses_total", "Swaps whose first frame was decoded on the render path" },
+};
+
+static const histogram_desc_t s_histogram_desc[METRICS_HISTOGRAM_COUNT] = {
+    [METRICS_DECODE_TIME] = { "p3a_decode_seconds", "Decode time per frame", s_frame_bounds_us, s_frame_le },
+    [METRICS_UPSCALE_TIME] = { "p3a_upscale_seconds", "Upscale worker time per frame", s_frame_bounds_us, s_frame_le },
+    [METRICS_PRESENT_TIME] = { "p3a_present_seconds", "Panel draw call time per frame", s_frame_bounds_us, s_frame_le },
+    [METRICS_LOAD_TIME] = { "p3a_load_seconds", "Loader time per artwork (read and decoder setup)", s_load_bounds_us, s_load_le },
+    [METRICS_SWAP_LATENCY] = { "p3a_swap_latency_seconds", "User swap request to swap (scheduled swaps excluded)", s_load_bounds_us, s_load_le },
+    [METRICS_TOUCH_LATENCY] = { "p3a_touch_latency_seconds", "Touch controller signal to gesture action", s_frame_bounds_us, s_frame_le },
+};
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static metrics_state_t s_state;
+
+// Only used by metrics_render(), which runs on the HTTP server task
+static metrics_state_t s_snapshot;
+static task_stats_report_t s_task_report;
+
+void metrics_add(metrics_counter_t counter, uint64_t value)
+{
+    if (counter >= METRICS_COUNTER_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    s_state.counters[counter] += value;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void metrics_observe_us(metrics_histogram_t histogram, int64_t duration_us)
+{
+    if (histogram >= METRICS_HISTOGRAM_COUNT) {
+        return;
+    }
+    if (duration_us < 0) {
+        duration_us = 0;
+    }
+    const int64_t *bounds = s_histogram_desc[histogram].bounds_us;
+    int bucket = 0;
+    while (bucket < METRICS_BUCKETS && duration_us > bounds[bucket]) {
+        bucket++;
+    }
+    portENTER_CRITICAL(&s_lock);
+    histogram_t *h = &s_state.histograms[histogram];
+    h->buckets[bucket]++;
+    h->count++;
+    h->sum_us += (uint64_t)duration_us;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+size_t metrics_appendf(char *buf, size_t size, size_t len, const char *fmt, ...)
+{
+    if (!buf || len >= size) {
+        return len;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + len, size - len, fmt, args);
+    va_end(args);
+    if (n < 0 || (size_t)n >= size - len) {
+        buf[len] = '\0';  // Drop the partial line
+        return len;
+    }
+    return len + (size_t)n;
+}
+
+static size_t render_seconds(char *buf, size_t size, size_t len, const char *name, const char *labels, uint64_t us)
+{
+    return metrics_appendf(buf, size, len, "%s%s %llu.%06lu\n", name, labels,
+                           (unsigned long long)(us / 1000000ULL), (unsigned long)(us % 1000000ULL));
+}
+
+// Per-task figures come from the task_stats sampler (once per second), which already folds the
+// 32-bit run time counters into 64-bit totals
+static size_t render_tasks(char *buf, size_t size, size_t len)
+{
+    if (task_stats_get(&s_task_report) != ESP_OK) {
+        return len;
+    }
+
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_task_cpu_seconds_total CPU time per task\n"
+                          "# TYPE p3a_task_cpu_seconds_total counter\n");
+    for (size_t i = 0; i < s_task_report.task_count; ++i) {
+        const task_stats_task_t *t = &s_task_report.tasks[i];
+        char labels[48];
+        if (t->core >= 0) {
+            snprintf(labels, sizeof(labels), "{task=\"%s\",core=\"%d\"}", t->name, t->core);
+        } else {
+            snprintf(labels, sizeof(labels), "{task=\"%s\",core=\"any\"}", t->name);
+        }
+        len = render_seconds(buf, size, len, "p3a_task_cpu_seconds_total", labels, t->cpu_total_us);
+    }
+
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_task_stack_free_min_bytes Lowest free stack seen per task\n"
+                          "# TYPE p3a_task_stack_free_min_bytes gauge\n");
+    for (size_t i = 0; i < s_task_report.task_count; ++i) {
+        len = metrics_appendf(buf, size, len, "p3a_task_stack_free_min_bytes{task=\"%s\"} %lu\n",
+                              s_task_report.tasks[i].name, (unsigned long)s_task_report.tasks[i].stack_free_min);
+    }
+    return len;
+}
+
+static size_t render_heap(char *buf, size_t size, size_t len)
+{
+    static const struct {
+        const char *pool;
+        uint32_t caps;
+    } pools[] = {
+        { "internal", MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT },
+        { "psram", MALLOC_CAP_SPIRAM },
+    };
+
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_heap_size_bytes Heap size per pool\n"
+                          "# TYPE p3a_heap_size_bytes gauge\n");
+    for (size_t i = 0; i < sizeof(pools) / sizeof(pools[0]); ++i) {
+        len = metrics_appendf(buf, size, len, "p3a_heap_size_bytes{pool=\"%s\"} %u\n",
+                              pools[i].pool, (unsigned)heap_caps_get_total_size(pools[i].caps));
+    }
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_heap_free_bytes Free heap per pool\n"
+                          "# TYPE p3a_heap_free_bytes gauge\n");
+    for (size_t i = 0; i < sizeof(pools) / sizeof(pools[0]); ++i) {
+        len = metrics_appendf(buf, size, len, "p3a_heap_free_bytes{pool=\"%s\"} %u\n",
+                              pools[i].pool, (unsigned)heap_caps_get_free_size(pools[i].caps));
+    }
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_heap_free_min_bytes Lowest free heap since boot (high-water mark of use)\n"
+                          "# TYPE p3a_heap_free_min_bytes gauge\n");
+    for (size_t i = 0; i < sizeof(pools) / sizeof(pools[0]); ++i) {
+        len = metrics_appendf(buf, size, len, "p3a_heap_free_min_bytes{pool=\"%s\"} %u\n",
+                              pools[i].pool, (unsigned)heap_caps_get_minimum_free_size(pools[i].caps));
+    }
+    return len;
+}
+
+static size_t render_power(char *buf, size_t size, size_t len)
+{
+    power_mgmt_stats_t pm;
+    power_mgmt_get_stats(&pm);
+
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_cpu_busy_seconds_total Time the player held the CPU at its maximum frequency\n"
+                          "# TYPE p3a_cpu_busy_seconds_total counter\n");
+    len = render_seconds(buf, size, len, "p3a_cpu_busy_seconds_total", "", pm.busy_us);
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_cpu_busy_sections_total Switches from idle to the maximum frequency\n"
+                          "# TYPE p3a_cpu_busy_sections_total counter\n"
+                          "p3a_cpu_busy_sections_total %llu\n",
+                          (unsigned long long)pm.busy_sections);
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_display_blanked_seconds_total Time the display was blanked (light sleep allowed)\n"
+                          "# TYPE p3a_display_blanked_seconds_total counter\n");
+    len = render_seconds(buf, size, len, "p3a_display_blanked_seconds_total", "", pm.blanked_us);
+    len = metrics_appendf(buf, size, len,
+                          "# HELP p3a_cpu_freq_mhz CPU frequency while busy (max) and between frames (min)\n"
+                          "# TYPE p3a_cpu_freq_mhz gauge\n"
+                          "p3a_cpu_freq_mhz{bound=\"max\"} %d\n"
+                          "p3a_cpu_freq_mhz{bound=\"min\"} %d\n"
+                          "# HELP p3a_pm_enabled Whether frequency scaling (and light sleep) is active\n"
+                          "# TYPE p3a_pm_enabled gauge\n"
+                          "p3a_pm_enabled{mode=\"dfs\"} %d\n"
+                          "p3a_pm_enabled{mode=\"light_sleep\"} %d\n",
+                          pm.max_freq_mhz, pm.min_freq_mhz, pm.pm_enabled ? 1 : 0, pm.light_sleep ? 1 : 0);
+    return len;
+}
+
+size_t metrics_render(char *buf, size_t size)
+{
+    if (!buf || size == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+
+    portENTER_CRITICAL(&s_lock);
+    memcpy(&s_snapshot, &s_state, sizeof(s_snapshot));
+    portEXIT_CRITICAL(&s_lock);
+
+    size_t len = 0;
+    for (int c = 0; c < METRICS_COUNTER_COUNT; ++c) {
+        len = metrics_appendf(buf, size, len, "# HELP %s %s\n# TYPE %s counter\n%s %llu\n",
+                              s_counter_desc[c].name, s_counter_desc[c].help, s_counter_desc[c].name,
+                              s_counter_desc[c].name, (unsigned long long)s_snapshot.counters[c]);
+    }
+
+    for (int h = 0; h < METRICS_HISTOGRAM_COUNT; ++h) {
+        const histogram_desc_t *desc = &s_histogram_desc[h];
+        const histogram_t *hist = &s_snapshot.histograms[h];
+        len = metrics_appendf(buf, size, len, "# HELP %s %s\n# TYPE %s histogram\n",
+                              desc->name, desc->help, desc->name);
+        uint32_t cumulative = 0;
+        for (int b = 0; b < METRICS_BUCKETS; ++b) {
+            cumulative += hist->buckets[b];
+            len = metrics_appendf(buf, size, len, "%s_bucket{le=\"%s\"} %lu\n",
+                                  desc->name, desc->le[b], (unsigned long)cumulative);
+        }
+        len = metrics_appendf(buf, size, len, "%s_bucket{le=\"+Inf\"} %lu\n",
+                              desc->name, (unsigned long)hist->count);
+        char sum_name[48];
+        snprintf(sum_name, sizeof(sum_name), "%s_sum", desc->name);
+        len = render_seconds(buf, size, len, sum_name, "", hist->sum_us);
+        len = metrics_appendf(buf, size, len, "%s_count %lu\n", desc->name, (unsigned long)hist->count);
+    }
+
+    len = render_heap(buf, size, len);
+    len = render_power(buf, size, len);
+    len = render_tasks(buf, size, len);
+    return len;
+}
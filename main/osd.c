@@ -0,0 +1,558 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "osd.h"
+#include "display_orientation.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "osd";
+
+#ifndef CONFIG_P3A_OSD_SCALE
+#define CONFIG_P3A_OSD_SCALE 3
+#endif
+
+#define OSD_TEXT_MAX 16
+#define OSD_GLYPH_MAX_ROWS 12
+#define OSD_MAX_RUNS 2048
+#define OSD_COLOR_ROW_PIXELS 128          // Longest span copied in one go; longer spans are split
+#define OSD_SPINNER_FRAMES 8
+#define OSD_SPINNER_PERIOD_US 100000
+#define OSD_EDGE_WIDTH (CONFIG_P3A_OSD_SCALE * 2)
+#define OSD_EDGE_RGB 0xFFFFFF
+#define OSD_COLOR_EDGE (OSD_TEXT_COUNT + OSD_ICON_COUNT)
+#define OSD_COLOR_COUNT (OSD_COLOR_EDGE + 1)
+
+// 1-bit source glyph, bit (width - 1) is the leftmost column
+typedef struct {
+    char ch;
+    uint8_t width;
+    uint8_t height;
+    uint16_t rows[OSD_GLYPH_MAX_ROWS];
+} osd_glyph_mask_t;
+
+static const osd_glyph_mask_t s_font[] = {
+    { '0', 5, 7, {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E} },
+    { '1', 5, 7, {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x1F} },
+    { '2', 5, 7, {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F} },
+    { '3', 5, 7, {0x0E, 0x11, 0x01, 0x06, 0x01, 0x11, 0x0E} },
+    { '4', 5, 7, {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02} },
+    { '5', 5, 7, {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E} },
+    { '6', 5, 7, {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E} },
+    { '7', 5, 7, {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08} },
+    { '8', 5, 7, {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E} },
+    { '9', 5, 7, {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C} },
+    { '.', 1, 7, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01} },
+    { '-', 5, 7, {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00} },
+    { ':', 1, 7, {0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00} },
+    { '%', 5, 7, {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03} },
+    { ' ', 3, 7, {0} },
+};
+#define OSD_FONT_GLYPHS (sizeof(s_font) / sizeof(s_font[0]))
+
+static const osd_glyph_mask_t s_icon_wifi_off = { 0, 12, 12, {
+    0x1F8,  // ...######...
+    0x606,  // .##......##.
+    0x9F9,  // #..######..#
+    0x204,  // ..#......#..
+    0x4F2,  // .#..####..#.
+    0x108,  // ...#....#...
+    0x264,  // ..#..##..#..
+    0x090,  // ....#..#....
+    0x060,  // .....##.....
+    0x000,
+    0x060,  // .....##.....
+    0x060,  // .....##.....
+} };
+
+static const osd_glyph_mask_t s_icon_paused = { 0, 12, 12, {
+    0x000, 0x39C, 0x39C, 0x39C, 0x39C, 0x39C,
+    0x39C, 0x39C, 0x39C, 0x39C, 0x39C, 0x000,
+} };
+
+// Spinner dots (top-left of a 2x2 block) clockwise from 12 o'clock on a 12x12 grid
+static const uint8_t s_spinner_dots[OSD_SPINNER_FRAMES][2] = {
+    {5, 0}, {8, 1}, {10, 5}, {8, 8}, {5, 10}, {2, 8}, {0, 5}, {2, 1},
+};
+
+// Atlas glyph: spans relative to the top-left of the glyph's panel-space bounding box
+typedef struct {
+    uint16_t first_run;
+    uint16_t run_count;
+    uint8_t view_w;     // Scaled size in the viewer's frame
+    uint8_t view_h;
+} osd_atlas_glyph_t;
+
+typedef struct {
+    uint8_t dx;
+    uint8_t dy;
+    uint8_t len;
+} osd_atlas_run_t;
+
+enum {
+    ATLAS_ICON_WIFI_OFF = OSD_FONT_GLYPHS,
+    ATLAS_ICON_PAUSED,
+    ATLAS_ICON_SPINNER,
+    ATLAS_GLYPH_COUNT = ATLAS_ICON_SPINNER + OSD_SPINNER_FRAMES,
+};
+
+typedef struct {
+    bool visible;
+    char text[OSD_TEXT_MAX];
+    uint32_t rgb;
+} osd_text_state_t;
+
+static osd_atlas_glyph_t s_atlas[ATLAS_GLYPH_COUNT];
+static osd_atlas_run_t *s_atlas_runs = NULL;
+static int s_panel_w = 0;
+static int s_panel_h = 0;
+static size_t s_bytes_per_pixel = 0;
+
+// Element state written by any task under s_state_mutex; the layer is rebuilt by the render task
+static SemaphoreHandle_t s_state_mutex = NULL;
+static osd_text_state_t s_texts[OSD_TEXT_COUNT];
+static bool s_icons[OSD_ICON_COUNT];
+static osd_edge_t s_edge = OSD_EDGE_NONE;
+static bool s_state_dirty = false;
+
+static osd_run_t s_runs[OSD_MAX_RUNS];
+static osd_layer_t s_layer = {0};
+static uint8_t s_color_rows[OSD_COLOR_COUNT][OSD_COLOR_ROW_PIXELS * 3] __attribute__((aligned(4)));
+static uint8_t s_spinner_frame = 0;
+static int64_t s_spinner_next_us = 0;
+
+static const uint32_t s_icon_colors[OSD_ICON_COUNT] = {
+    [OSD_ICON_WIFI_OFF] = 0xFF4040,
+    [OSD_ICON_PAUSED] = 0xFFFFFF,
+    [OSD_ICON_LOADING] = 0xFFFFFF,
+};
+
+static void spinner_mask(int frame, osd_glyph_mask_t *mask)
+{
+    memset(mask, 0, sizeof(*mask));
+    mask->width = 12;
+    mask->height = 12;
+    // Head dot plus a two-dot tail
+    for (int i = 0; i < 3; ++i) {
+        const uint8_t *dot = s_spinner_dots[(frame + OSD_SPINNER_FRAMES - i) % OSD_SPINNER_FRAMES];
+        const uint16_t bits = (uint16_t)(0x3U << (12 - 2 - dot[0]));
+        mask->rows[dot[1]] |= bits;
+        mask->rows[dot[1] + 1] |= bits;
+    }
+}
+
+static inline bool mask_bit(const osd_glyph_mask_t *mask, int x, int y, int scale)
+{
+    const int col = x / scale;
+    const int row = y / scale;
+    return (mask->rows[row] >> (mask->width - 1 - col)) & 0x1U;
+}
+
+// Rasterize one glyph at scale, in panel orientation. With runs == NULL only counts the spans.
+static size_t rasterize_glyph(const osd_glyph_mask_t *mask, int scale, osd_atlas_run_t *runs)
+{
+    const int view_w = mask->width * scale;
+    const int view_h = mask->height * scale;
+    const int box_w = DISPLAY_ORIENTATION_TRANSPOSED ? view_h : view_w;
+    const int box_h = DISPLAY_ORIENTATION_TRANSPOSED ? view_w : view_h;
+    size_t count = 0;
+
+    for (int py = 0; py < box_h; ++py) {
+        int run_start = -1;
+        for (int px = 0; px <= box_w; ++px) {
+            bool lit = false;
+            if (px < box_w) {
+                int vx = px;
+                int vy = py;
+                display_orientation_panel_to_view(&vx, &vy, box_w, box_h);
+                lit = mask_bit(mask, vx, vy, scale);
+            }
+            if (lit && run_start < 0) {
+                run_start = px;
+            } else if (!lit && run_start >= 0) {
+                if (runs) {
+                    runs[count].dx = (uint8_t)run_start;
+                    runs[count].dy = (uint8_t)py;
+                    runs[count].len = (uint8_t)(px - run_start);
+                }
+                count++;
+                run_start = -1;
+            }
+        }
+    }
+    return count;
+}
+
+static const osd_glyph_mask_t *atlas_source(int index, osd_glyph_mask_t *scratch)
+{
+    if (index < (int)OSD_FONT_GLYPHS) {
+        return &s_font[index];
+    }
+    if (index == ATLAS_ICON_WIFI_OFF) {
+        return &s_icon_wifi_off;
+    }
+    if (index == ATLAS_ICON_PAUSED) {
+        return &s_icon_paused;
+    }
+    spinner_mask(index - ATLAS_ICON_SPINNER, scratch);
+    return scratch;
+}
+
+static int glyph_index(char c)
+{
+    for (size_t i = 0; i < OSD_FONT_GLYPHS; ++i) {
+        if (s_font[i].ch == c) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static void pack_color_row(uint8_t *row, uint32_t rgb)
+{
+    const uint8_t r = (uint8_t)(rgb >> 16);
+    const uint8_t g = (uint8_t)(rgb >> 8);
+    const uint8_t b = (uint8_t)rgb;
+    if (s_bytes_per_pixel == 2) {
+        const uint16_t c = (uint16_t)(((uint16_t)(r & 0xF8) << 8) | ((uint16_t)(g & 0xFC) << 3) | (b >> 3));
+        uint16_t *px = (uint16_t *)row;
+        for (int i = 0; i < OSD_COLOR_ROW_PIXELS; ++i) {
+            px[i] = c;
+        }
+    } else {
+        for (int i = 0; i < OSD_COLOR_ROW_PIXELS; ++i) {
+            row[i * 3 + 0] = b;
+            row[i * 3 + 1] = g;
+            row[i * 3 + 2] = r;
+        }
+    }
+}
+
+// Panel-space top-left of a rectangle given in the viewer's frame
+static void view_rect_to_panel(int vx, int vy, int w, int h, int *px, int *py)
+{
+    int x0 = vx, y0 = vy;
+    int x1 = vx + w - 1, y1 = vy + h - 1;
+    display_orientation_view_to_panel(&x0, &y0, s_panel_w, s_panel_h);
+    display_orientation_view_to_panel(&x1, &y1, s_panel_w, s_panel_h);
+    *px = (x0 < x1) ? x0 : x1;
+    *py = (y0 < y1) ? y0 : y1;
+}
+
+// Add the panel span [x0, x1) of row y, clipped and split into colour-row lengths
+static void emit_span(int y, int x0, int x1, uint8_t color)
+{
+    if (y < 0 || y >= s_panel_h) {
+        return;
+    }
+    if (x0 < 0) x0 = 0;
+    if (x1 > s_panel_w) x1 = s_panel_w;
+    while (x0 < x1 && s_layer.run_count < OSD_MAX_RUNS) {
+        const int len = (x1 - x0 > OSD_COLOR_ROW_PIXELS) ? OSD_COLOR_ROW_PIXELS : (x1 - x0);
+        osd_run_t *run = &s_runs[s_layer.run_count++];
+        run->y = (uint16_t)y;
+        run->x = (uint16_t)x0;
+        run->len = (uint16_t)len;
+        run->color = color;
+        run->reserved = 0;
+        x0 += len;
+    }
+}
+
+static void emit_glyph(int glyph, int vx, int vy, uint8_t color)
+{
+    const osd_atlas_glyph_t *g = &s_atlas[glyph];
+    int ox, oy;
+    view_rect_to_panel(vx, vy, g->view_w, g->view_h, &ox, &oy);
+
+    for (uint16_t i = 0; i < g->run_count; ++i) {
+        const osd_atlas_run_t *r = &s_atlas_runs[g->first_run + i];
+        const int x0 = ox + r->dx;
+        emit_span(oy + r->dy, x0, x0 + r->len, color);
+    }
+}
+
+// Filled rectangle given in the viewer's frame
+static void emit_rect(int vx, int vy, int w, int h, uint8_t color)
+{
+    int ox, oy;
+    view_rect_to_panel(vx, vy, w, h, &ox, &oy);
+    const int box_w = DISPLAY_ORIENTATION_TRANSPOSED ? h : w;
+    const int box_h = DISPLAY_ORIENTATION_TRANSPOSED ? w : h;
+    for (int y = oy; y < oy + box_h; ++y) {
+        emit_span(y, ox, ox + box_w, color);
+    }
+}
+
+static int text_view_width(const char *text)
+{
+    int width = 0;
+    for (const char *ch = text; *ch; ++ch) {
+        const int glyph = glyph_index(*ch);
+        if (glyph >= 0) {
+            width += s_atlas[glyph].view_w + CONFIG_P3A_OSD_SCALE;
+        }
+    }
+    return width;
+}
+
+static int compare_runs(const void *a, const void *b)
+{
+    const osd_run_t *ra = (const osd_run_t *)a;
+    const osd_run_t *rb = (const osd_run_t *)b;
+    if (ra->y != rb->y) {
+        return (int)ra->y - (int)rb->y;
+    }
+    return (int)ra->x - (int)rb->x;
+}
+
+static void rebuild_layer(const osd_text_state_t *texts, const bool *icons, osd_edge_t edge)
+{
+    const int view_w = DISPLAY_ORIENTATION_TRANSPOSED ? s_panel_h : s_panel_w;
+    const int view_h = DISPLAY_ORIENTATION_TRANSPOSED ? s_panel_w : s_panel_h;
+    const int margin = CONFIG_P3A_OSD_SCALE * 2;
+
+    s_layer.run_count = 0;
+
+    if (edge != OSD_EDGE_NONE) {
+        pack_color_row(s_color_rows[OSD_COLOR_EDGE], OSD_EDGE_RGB);
+        emit_rect((edge == OSD_EDGE_LEFT) ? 0 : view_w - OSD_EDGE_WIDTH, 0, OSD_EDGE_WIDTH, view_h, OSD_COLOR_EDGE);
+    }
+
+    int cursor_x = margin;
+    for (int i = 0; i < OSD_ICON_COUNT; ++i) {
+        if (!icons[i]) {
+            continue;
+        }
+        int glyph = ATLAS_ICON_WIFI_OFF + i;
+        if (i == OSD_ICON_LOADING) {
+            glyph = ATLAS_ICON_SPINNER + s_spinner_frame;
+        }
+        const uint8_t color = (uint8_t)(OSD_TEXT_COUNT + i);
+        pack_color_row(s_color_rows[color], s_icon_colors[i]);
+        emit_glyph(glyph, cursor_x, margin, color);
+        cursor_x += s_atlas[glyph].view_w + margin;
+    }
+
+    int text_y = margin;
+    for (int i = 0; i < OSD_TEXT_COUNT; ++i) {
+        if (!texts[i].visible) {
+            continue;
+        }
+        pack_color_row(s_color_rows[i], texts[i].rgb);
+        int x = view_w - margin - text_view_width(texts[i].text);
+        if (x < 0) {
+            x = 0;
+        }
+        for (const char *ch = texts[i].text; *ch; ++ch) {
+            const int glyph = glyph_index(*ch);
+            if (glyph < 0) {
+                continue;
+            }
+            emit_glyph(glyph, x, text_y, (uint8_t)i);
+            x += s_atlas[glyph].view_w + CONFIG_P3A_OSD_SCALE;
+        }
+        text_y += (s_font[0].height + 2) * CONFIG_P3A_OSD_SCALE;
+    }
+
+    if (s_layer.run_count == OSD_MAX_RUNS) {
+        ESP_LOGW(TAG, "OSD layer truncated at %d spans", OSD_MAX_RUNS);
+    }
+    qsort(s_runs, s_layer.run_count, sizeof(s_runs[0]), compare_runs);
+    s_layer.runs = s_runs;
+    s_layer.x0 = s_panel_w;
+    s_layer.x1 = 0;
+    for (size_t i = 0; i < s_layer.run_count; ++i) {
+        if (s_runs[i].x < s_layer.x0) {
+            s_layer.x0 = s_runs[i].x;
+        }
+        if (s_runs[i].x + s_runs[i].len > s_layer.x1) {
+            s_layer.x1 = s_runs[i].x + s_runs[i].len;
+        }
+    }
+    s_layer.y0 = s_layer.run_count ? s_runs[0].y : 0;
+    s_layer.y1 = s_layer.run_count ? s_runs[s_layer.run_count - 1].y + 1 : 0;
+}
+
+esp_err_t osd_init(int panel_w, int panel_h, size_t bytes_per_pixel)
+{
+    if (panel_w <= 0 || panel_h <= 0 || (bytes_per_pixel != 2 && bytes_per_pixel != 3)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_atlas_runs) {
+        return ESP_OK;
+    }
+
+    const int scale = CONFIG_P3A_OSD_SCALE;
+    osd_glyph_mask_t scratch;
+    size_t total = 0;
+    for (int i = 0; i < ATLAS_GLYPH_COUNT; ++i) {
+        total += rasterize_glyph(atlas_source(i, &scratch), scale, NULL);
+    }
+
+    s_atlas_runs = (osd_atlas_run_t *)heap_caps_malloc(total * sizeof(osd_atlas_run_t), MALLOC_CAP_8BIT);
+    if (!s_atlas_runs) {
+        ESP_LOGE(TAG, "Failed to allocate glyph atlas (%zu spans)", total);
+        return ESP_ERR_NO_MEM;
+    }
+    s_state_mutex = xSemaphoreCreateMutex();
+    if (!s_state_mutex) {
+        heap_caps_free(s_atlas_runs);
+        s_atlas_runs = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    size_t offset = 0;
+    for (int i = 0; i < ATLAS_GLYPH_COUNT; ++i) {
+        const osd_glyph_mask_t *mask = atlas_source(i, &scratch);
+        const size_t count = rasterize_glyph(mask, scale, &s_atlas_runs[offset]);
+        s_atlas[i].first_run = (uint16_t)offset;
+        s_atlas[i].run_count = (uint16_t)count;
+        s_atlas[i].view_w = (uint8_t)(mask->width * scale);
+        s_atlas[i].view_h = (uint8_t)(mask->height * scale);
+        offset += count;
+    }
+
+    s_panel_w = panel_w;
+    s_panel_h = panel_h;
+    s_bytes_per_pixel = bytes_per_pixel;
+    ESP_LOGI(TAG, "Glyph atlas ready: %d glyphs, %zu spans at scale %d", ATLAS_GLYPH_COUNT, total, scale);
+    return ESP_OK;
+}
+
+void osd_set_text(osd_text_t id, const char *text, uint32_t rgb)
+{
+    if (id >= OSD_TEXT_COUNT || !s_state_mutex) {
+        return;
+    }
+    const bool visible = text && text[0];
+    if (xSemaphoreTake(s_state_mutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    osd_text_state_t *state = &s_texts[id];
+    if (state->visible != visible ||
+        (visible && (state->rgb != rgb || strncmp(state->text, text, sizeof(state->text)) != 0))) {
+        state->visible = visible;
+        state->rgb = rgb;
+        if (visible) {
+            snprintf(state->text, sizeof(state->text), "%s", text);
+        } else {
+            state->text[0] = '\0';
+        }
+        s_state_dirty = true;
+    }
+    xSemaphoreGive(s_state_mutex);
+}
+
+void osd_set_icon(osd_icon_t icon, bool visible)
+{
+#if CONFIG_P3A_OSD_STATUS_ICONS
+    if (icon >= OSD_ICON_COUNT || !s_state_mutex) {
+        return;
+    }
+    if (xSemaphoreTake(s_state_mutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    if (s_icons[icon] != visible) {
+        s_icons[icon] = visible;
+        s_state_dirty = true;
+    }
+    xSemaphoreGive(s_state_mutex);
+#else
+    (void)icon;
+    (void)visible;
+#endif
+}
+
+void osd_set_edge(osd_edge_t edge)
+{
+#if CONFIG_P3A_OSD_TAP_FEEDBACK
+    if (!s_state_mutex) {
+        return;
+    }
+    if (xSemaphoreTake(s_state_mutex, portMAX_DELAY) != pdTRUE) {
+        return;
+    }
+    if (s_edge != edge) {
+        s_edge = edge;
+        s_state_dirty = true;
+    }
+    xSemaphoreGive(s_state_mutex);
+#else
+    (void)edge;
+#endif
+}
+
+const osd_layer_t *osd_begin_frame(int64_t now_us, bool *changed)
+{
+    bool rebuild = false;
+    osd_text_state_t texts[OSD_TEXT_COUNT];
+    bool icons[OSD_ICON_COUNT];
+    osd_edge_t edge = OSD_EDGE_NONE;
+
+    // A setter holding the lock keeps the previous layer for this frame
+    if (s_state_mutex && xSemaphoreTake(s_state_mutex, 0) == pdTRUE) {
+        if (s_icons[OSD_ICON_LOADING] && now_us >= s_spinner_next_us) {
+            s_spinner_frame = (uint8_t)((s_spinner_frame + 1) % OSD_SPINNER_FRAMES);
+            s_spinner_next_us = now_us + OSD_SPINNER_PERIOD_US;
+            s_state_dirty = true;
+        }
+        if (s_state_dirty) {
+            memcpy(texts, s_texts, sizeof(texts));
+            memcpy(icons, s_icons, sizeof(icons));
+            edge = s_edge;
+            s_state_dirty = false;
+            rebuild = true;
+        }
+        xSemaphoreGive(s_state_mutex);
+    }
+
+    if (rebuild) {
+        rebuild_layer(texts, icons, edge);
+    }
+    if (changed) {
+        *changed = rebuild;
+    }
+    return s_layer.run_count ? &s_layer : NULL;
+}
+
+void osd_compose_rows(const osd_layer_t *layer, uint8_t *frame, size_t row_stride_bytes,
+                      int row_start, int row_end)
+{
+    if (!layer || !frame || layer->run_count == 0) {
+        return;
+    }
+    if (row_start < layer->y0) row_start = layer->y0;
+    if (row_end > layer->y1) row_end = layer->y1;
+    if (row_start >= row_end) {
+        return;
+    }
+
+    // First span at or below row_start
+    size_t lo = 0;
+    size_t hi = layer->run_count;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (layer->runs[mid].y < row_start) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    const size_t bpp = s_bytes_per_pixel;
+    for (size_t i = lo; i < layer->run_count && layer->runs[i].y < row_end; ++i) {
+        const osd_run_t *run = &layer->runs[i];
+        uint8_t *dst = frame + (size_t)run->y * row_stride_bytes + (size_t)run->x * bpp;
+        memcpy(dst, s_color_rows[run->color], (size_t)run->len * bpp);
+    }
+}
@@ -9,6 +9,7 @@
 #include "nvs_flash.h"
 #include "esp_netif.h"
 #include "esp_event.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -16,6 +17,17 @@
 #include "app_touch.h"
 #include "app_wifi.h"
 #include "http_api.h"
+#include "animation_player.h"
+#include "perf_trace.h"
+#include "task_stats.h"
+#include "task_topology.h"
+#include "boot_profile.h"
+#include "power_mgmt.h"
+#if CONFIG_P3A_SYNC_WALL_ENABLE && !CONFIG_P3A_SYNC_WALL_LEADER
+#include "sync_wall.h"
+#include "sync_clock.h"
+#define AUTO_SWAP_FOLLOWS_LEADER 1
+#endif
 
 static const char *TAG = "p3a";
 
@@ -23,26 +35,102 @@ static const char *TAG = "p3a";
 
 static TaskHandle_t s_auto_swap_task_handle = NULL;
 
+#if AUTO_SWAP_FOLLOWS_LEADER
+#define FOLLOW_POLL_MS  100
+
+// Position of the announced artwork in this device's play order
+static bool find_announced_asset(uint32_t asset_id, size_t *index)
+{
+    char name[256];
+    for (size_t i = 0; animation_player_get_asset_name(i, name, sizeof(name)) == ESP_OK; ++i) {
+        if (sync_clock_asset_id(name) == asset_id) {
+            *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// A follower's play order is shuffled on its own, so a timer of its own would put different
+// artworks side by side: it swaps to what the leader announces, in the same loop-end window
+static void follow_leader(void)
+{
+    ESP_LOGI(TAG, "Auto-swap follows the sync wall leader");
+    sync_wall_asset_t followed = {0};
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FOLLOW_POLL_MS));
+        sync_wall_asset_t asset;
+        if (!sync_wall_get_leader_asset(&asset) ||
+            (asset.asset_id == followed.asset_id && asset.not_before_us == followed.not_before_us &&
+             asset.deadline_us == followed.deadline_us)) {
+            continue;
+        }
+        size_t index;
+        if (!find_announced_asset(asset.asset_id, &index)) {
+            ESP_LOGW(TAG, "Leader shows artwork %08lx, which is not on this SD card", (unsigned long)asset.asset_id);
+            followed = asset;
+            continue;
+        }
+        const esp_err_t err = animation_player_schedule_asset(index, sync_wall_shared_to_local(asset.not_before_us),
+                                                              sync_wall_shared_to_local(asset.deadline_us));
+        if (err == ESP_OK) {
+            followed = asset;
+        } else {
+            ESP_LOGD(TAG, "Cannot follow the leader (%s), retrying", esp_err_to_name(err));
+        }
+    }
+}
+#endif
+
 static void auto_swap_task(void *arg)
 {
     (void)arg;
-    const TickType_t delay_ticks = pdMS_TO_TICKS(AUTO_SWAP_INTERVAL_SECONDS * 1000);
+#if AUTO_SWAP_FOLLOWS_LEADER
+    follow_leader();  // Never returns
+#endif
+    const int64_t dwell_us = (int64_t)AUTO_SWAP_INTERVAL_SECONDS * 1000000;
+    const int64_t preload_lead_us = (int64_t)CONFIG_P3A_AUTO_SWAP_PRELOAD_SECONDS * 1000000;
+    const int64_t max_loop_wait_us = (int64_t)CONFIG_P3A_AUTO_SWAP_MAX_LOOP_WAIT_SECONDS * 1000000;
     
-    ESP_LOGI(TAG, "Auto-swap task started: will cycle forward every %d seconds", AUTO_SWAP_INTERVAL_SECONDS);
+    ESP_LOGI(TAG, "Auto-swap task started: will cycle forward at the first loop end after %d seconds", AUTO_SWAP_INTERVAL_SECONDS);
     
     // Wait a bit for system to initialize before first swap
     vTaskDelay(pdMS_TO_TICKS(1000));
     
     while (true) {
-        // Wait for interval or notification (which resets the timer)
-        uint32_t notified = ulTaskNotifyTake(pdTRUE, delay_ticks);
-        if (notified > 0) {
-            ESP_LOGD(TAG, "Auto-swap timer reset by user interaction");
-            continue;  // Timer was reset, start waiting again
+        // The dwell time counts from when the current artwork appeared, so user swaps restart it
+        const int64_t shown_since_us = animation_player_get_shown_since_us();
+        if (shown_since_us == 0) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+            continue;
+        }
+        const int64_t dwell_end_us = shown_since_us + dwell_us;
+        const int64_t preload_in_us = dwell_end_us - preload_lead_us - esp_timer_get_time();
+        if (preload_in_us > 0) {
+            // Wait for the preload point or a notification (which re-evaluates the timer)
+            if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(preload_in_us / 1000) + 1) > 0) {
+                ESP_LOGD(TAG, "Auto-swap timer reset by user interaction");
+            }
+            continue;
+        }
+        
+        // Load the next artwork now, swap to it on the first loop boundary after the dwell time
+        const int64_t deadline_us = dwell_end_us + max_loop_wait_us;
+        esp_err_t err = animation_player_schedule_cycle(dwell_end_us, deadline_us);
+        if (err != ESP_OK) {
+            ESP_LOGD(TAG, "Auto-swap: cannot schedule (%s), retrying", esp_err_to_name(err));
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+            continue;
+        }
+        ESP_LOGD(TAG, "Auto-swap: next artwork preloading, loop is %lu ms",
+                 (unsigned long)animation_player_get_loop_duration_ms());
+        
+        // Wait for the swap (or a user swap) before planning the next one. A failed load drops the
+        // request, so stop waiting a little after the deadline.
+        while (animation_player_get_shown_since_us() == shown_since_us &&
+               esp_timer_get_time() < deadline_us + 5000000) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(250));
         }
-        // Timeout occurred, perform auto-swap
-        ESP_LOGD(TAG, "Auto-swap: cycling forward");
-        app_lcd_cycle_animation();
     }
 }
 
@@ -53,6 +141,14 @@ void auto_swap_reset_timer(void)
     }
 }
 
+static void apply_saved_config(void)
+{
+    esp_err_t err = animation_player_apply_config();
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to apply saved config: %s", esp_err_to_name(err));
+    }
+}
+
 static void register_rest_action_handlers(void)
 {
     // Register action handlers for HTTP API swap commands
@@ -60,6 +156,7 @@ static void register_rest_action_handlers(void)
         app_lcd_cycle_animation,           // swap_next callback
         app_lcd_cycle_animation_backward   // swap_back callback
     );
+    http_api_set_config_handler(apply_saved_config);
     ESP_LOGI(TAG, "REST action handlers registered");
 }
 
@@ -74,24 +171,42 @@ void app_main(void)
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+    boot_profile_mark("nvs_ready");
 
     // Initialize network interface and event loop
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
 
+    // Task placement from Kconfig and the config store, before any pipeline task is created
+    task_topology_load();
+
+    // Trace rings first, so player start-up is recorded too (no-op unless tracing is enabled)
+    if (perf_trace_init() != ESP_OK) {
+        ESP_LOGW(TAG, "Tracing unavailable");
+    }
+    if (task_stats_start() != ESP_OK) {
+        ESP_LOGW(TAG, "Task statistics unavailable");
+    }
+    // Before the panel and Wi-Fi drivers start, so their own power locks apply from the outset
+    if (power_mgmt_init() != ESP_OK) {
+        ESP_LOGW(TAG, "Power management unavailable, running at full speed");
+    }
+
     // Initialize LCD and touch
     ESP_ERROR_CHECK(app_lcd_init());
+    boot_profile_mark("player_started");
     ESP_ERROR_CHECK(app_touch_init());
 
     // Create auto-swap task
-    const BaseType_t created = xTaskCreate(auto_swap_task, "auto_swap", 2048, NULL, 
-                                           tskIDLE_PRIORITY + 1, &s_auto_swap_task_handle);
+    const BaseType_t created = task_topology_create(TASK_TOPOLOGY_AUTO_SWAP, auto_swap_task, NULL,
+                                                    &s_auto_swap_task_handle);
     if (created != pdPASS) {
         ESP_LOGE(TAG, "Failed to create auto-swap task");
     }
 
     // Initialize Wi-Fi (will start captive portal if needed, or connect to saved network)
     ESP_ERROR_CHECK(app_wifi_init(register_rest_action_handlers));
+    boot_profile_mark("wifi_started");
 
-    ESP_LOGI(TAG, "P3A ready: tap the display to cycle animations (auto-swap forward every %d seconds)", AUTO_SWAP_INTERVAL_SECONDS);
+    ESP_LOGI(TAG, "P3A ready: tap the display to cycle animations (auto-swap forward at a loop end after %d seconds)", AUTO_SWAP_INTERVAL_SECONDS);
 }
@@ -0,0 +1,251 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "perf_trace.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "perf_trace";
+
+#if CONFIG_P3A_TRACE_ENABLE
+
+// Ring size rounded down to a power of two so the write index wraps with a mask
+#define TRACE_RING_EVENTS   (1u << (31 - __builtin_clz((unsigned)CONFIG_P3A_TRACE_EVENTS_PER_CORE)))
+#define TRACE_RING_MASK     (TRACE_RING_EVENTS - 1)
+#define TRACE_MAX_TASKS     24
+#define TRACE_CHUNK_BYTES   1024
+
+typedef struct {
+    int64_t ts_us;
+    TaskHandle_t task;
+    uint8_t event;
+    uint8_t begin;
+    uint8_t core;
+    uint8_t reserved;
+} trace_record_t;
+
+typedef struct {
+    trace_record_t *records;
+    atomic_uint head;           // Total events written; the slot is head & TRACE_RING_MASK
+} trace_ring_t;
+
+static const char *const s_event_names[PERF_TRACE_EVENT_COUNT] = {
+    [PERF_TRACE_RENDER_FRAME] = "render_frame",
+    [PERF_TRACE_DECODE] = "decode",
+    [PERF_TRACE_UPSCALE_WAIT] = "upscale_wait",
+    [PERF_TRACE_UPSCALE_ROWS] = "upscale_rows",
+    [PERF_TRACE_CACHE_FLUSH] = "cache_flush",
+    [PERF_TRACE_PACING_WAIT] = "pacing_wait",
+    [PERF_TRACE_VSYNC_WAIT] = "vsync_wait",
+    [PERF_TRACE_PRESENT] = "present",
+    [PERF_TRACE_PREFETCH] = "prefetch",
+    [PERF_TRACE_LOAD_FILE] = "load_file",
+    [PERF_TRACE_SWAP] = "swap_buffers",
+    [PERF_TRACE_BUFFER_MUTEX] = "buffer_mutex",
+};
+
+static trace_ring_t s_rings[portNUM_PROCESSORS];
+static atomic_bool s_recording = false;
+static atomic_bool s_dumping = false;
+
+void perf_trace_record(perf_trace_event_t event, bool begin)
+{
+    if (!atomic_load_explicit(&s_recording, memory_order_relaxed)) {
+        return;
+    }
+    const int core = esp_cpu_get_core_id();
+    trace_ring_t *ring = &s_rings[core];
+    // Tasks on the same core may preempt each other here, so the slot is claimed atomically
+    const unsigned slot = atomic_fetch_add_explicit(&ring->head, 1, memory_order_relaxed) & TRACE_RING_MASK;
+    trace_record_t *rec = &ring->records[slot];
+    rec->ts_us = esp_timer_get_time();
+    rec->task = xTaskGetCurrentTaskHandle();
+    rec->event = (uint8_t)event;
+    rec->begin = begin ? 1 : 0;
+    rec->core = (uint8_t)core;
+}
+
+esp_err_t perf_trace_init(void)
+{
+    if (perf_trace_available()) {
+        return ESP_OK;
+    }
+    for (int i = 0; i < portNUM_PROCESSORS; ++i) {
+        s_rings[i].records = heap_caps_calloc(TRACE_RING_EVENTS, sizeof(trace_record_t),
+                                              MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_rings[i].records) {
+            ESP_LOGE(TAG, "Failed to allocate trace ring for core %d", i);
+            for (int j = 0; j < i; ++j) {
+                heap_caps_free(s_rings[j].records);
+                s_rings[j].records = NULL;
+            }
+            return ESP_ERR_NO_MEM;
+        }
+        atomic_store(&s_rings[i].head, 0);
+    }
+    atomic_store(&s_recording, true);
+    ESP_LOGI(TAG, "Tracing %u events per core", (unsigned)TRACE_RING_EVENTS);
+    return ESP_OK;
+}
+
+bool perf_trace_available(void)
+{
+    return s_rings[0].records != NULL;
+}
+
+typedef struct {
+    perf_trace_write_fn write;
+    void *ctx;
+    char buf[TRACE_CHUNK_BYTES];
+    size_t len;
+    esp_err_t err;
+} trace_writer_t;
+
+static void writer_flush(trace_writer_t *w)
+{
+    if (w->len > 0 && w->err == ESP_OK) {
+        w->err = w->write(w->ctx, w->buf, w->len);
+    }
+    w->len = 0;
+}
+
+static void writer_printf(trace_writer_t *w, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void writer_printf(trace_writer_t *w, const char *fmt, ...)
+{
+    char line[192];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (n <= 0) {
+        return;
+    }
+    if ((size_t)n >= sizeof(line)) {
+        n = sizeof(line) - 1;
+    }
+    if (w->len + (size_t)n > sizeof(w->buf)) {
+        writer_flush(w);
+    }
+    memcpy(w->buf + w->len, line, (size_t)n);
+    w->len += (size_t)n;
+}
+
+static int task_index(TaskHandle_t *tasks, int *task_count, TaskHandle_t task)
+{
+    for (int i = 0; i < *task_count; ++i) {
+        if (tasks[i] == task) {
+            return i;
+        }
+    }
+    if (*task_count < TRACE_MAX_TASKS) {
+        tasks[*task_count] = task;
+        return (*task_count)++;
+    }
+    return TRACE_MAX_TASKS;  // Shared "other" track
+}
+
+esp_err_t perf_trace_dump_json(perf_trace_write_fn write, void *ctx)
+{
+    if (!write || !perf_trace_available()) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (atomic_exchange(&s_dumping, true)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    static trace_writer_t s_writer;  // Too large for the HTTP task stack; dumps are serialized
+    trace_writer_t *w = &s_writer;
+    w->write = write;
+    w->ctx = ctx;
+    w->len = 0;
+    w->err = ESP_OK;
+
+    // Stop writers; one tick lets any record already past the check finish its store
+    atomic_store(&s_recording, false);
+    vTaskDelay(1);
+
+    unsigned pos[portNUM_PROCESSORS];
+    unsigned end[portNUM_PROCESSORS];
+    for (int c = 0; c < portNUM_PROCESSORS; ++c) {
+        end[c] = atomic_load(&s_rings[c].head);
+        pos[c] = (end[c] > TRACE_RING_EVENTS) ? end[c] - TRACE_RING_EVENTS : 0;
+    }
+
+    TaskHandle_t tasks[TRACE_MAX_TASKS];
+    int task_count = 0;
+    bool first = true;
+    writer_printf(w, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    // Merge the per-core rings by timestamp so each task's begin/end pairs come out in order
+    while (w->err == ESP_OK) {
+        int pick = -1;
+        for (int c = 0; c < portNUM_PROCESSORS; ++c) {
+            if (pos[c] == end[c]) {
+                continue;
+            }
+            if (pick < 0 || s_rings[c].records[pos[c] & TRACE_RING_MASK].ts_us <
+                            s_rings[pick].records[pos[pick] & TRACE_RING_MASK].ts_us) {
+                pick = c;
+            }
+        }
+        if (pick < 0) {
+            break;
+        }
+        const trace_record_t *rec = &s_rings[pick].records[pos[pick]++ & TRACE_RING_MASK];
+        if (rec->event >= PERF_TRACE_EVENT_COUNT) {
+            continue;
+        }
+        writer_printf(w, "%s{\"name\":\"%s\",\"cat\":\"core%u\",\"ph\":\"%c\",\"ts\":%lld,\"pid\":1,\"tid\":%d}",
+                      first ? "" : ",", s_event_names[rec->event], (unsigned)rec->core, rec->begin ? 'B' : 'E',
+                      (long long)rec->ts_us, task_index(tasks, &task_count, rec->task));
+        first = false;
+    }
+
+    // Track names; tasks of this firmware are never deleted while playing
+    writer_printf(w, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"p3a\"}}",
+                  first ? "" : ",");
+    for (int i = 0; i < task_count; ++i) {
+        const char *name = tasks[i] ? pcTaskGetName(tasks[i]) : "isr";
+        writer_printf(w, ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                      i, name ? name : "?");
+    }
+    writer_printf(w, "]}");
+    writer_flush(w);
+
+    atomic_store(&s_recording, true);
+    atomic_store(&s_dumping, false);
+    return w->err;
+}
+
+#else
+
+esp_err_t perf_trace_init(void)
+{
+    return ESP_OK;
+}
+
+bool perf_trace_available(void)
+{
+    return false;
+}
+
+esp_err_t perf_trace_dump_json(perf_trace_write_fn write, void *ctx)
+{
+    (void)write;
+    (void)ctx;
+    (void)TAG;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
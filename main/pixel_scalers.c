@@ -0,0 +1,197 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "pixel_scalers.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Pixels are handled as opaque 32-bit RGBA words; exact comparisons need no unpacking
+
+// Colour distance threshold for xBR-lite, on the weighted sum below (max 4 * 255 + 255)
+#define XBR_MATCH_THRESHOLD 48
+
+static inline bool xbr_similar(uint32_t a, uint32_t b)
+{
+    if (a == b) {
+        return true;
+    }
+    // Little endian RGBA: R in the low byte
+    const int dr = abs((int)(a & 0xFF) - (int)(b & 0xFF));
+    const int dg = abs((int)((a >> 8) & 0xFF) - (int)((b >> 8) & 0xFF));
+    const int db = abs((int)((a >> 16) & 0xFF) - (int)((b >> 16) & 0xFF));
+    const int da = abs((int)(a >> 24) - (int)(b >> 24));
+    // Green dominates perceived brightness; alpha differences always count fully
+    return (dr + 2 * dg + db + da * 4) < XBR_MATCH_THRESHOLD;
+}
+
+// Average two RGBA words per byte lane
+static inline uint32_t average_rgba(uint32_t a, uint32_t b)
+{
+    return (a & b) + (((a ^ b) & 0xFEFEFEFEU) >> 1);
+}
+
+int pixel_scaler_factor(pixel_scaler_t scaler)
+{
+    switch (scaler) {
+    case PIXEL_SCALER_SCALE2X:
+    case PIXEL_SCALER_XBR_LITE:
+        return 2;
+    case PIXEL_SCALER_SCALE3X:
+        return 3;
+    case PIXEL_SCALER_NONE:
+    default:
+        return 1;
+    }
+}
+
+pixel_scaler_t pixel_scaler_select(pixel_scaler_t preferred, int src_w, int src_h, int max_w, int max_h)
+{
+    if (src_w <= 0 || src_h <= 0) {
+        return PIXEL_SCALER_NONE;
+    }
+    const int factor = pixel_scaler_factor(preferred);
+    if (src_w * factor <= max_w && src_h * factor <= max_h) {
+        return preferred;
+    }
+    if (preferred == PIXEL_SCALER_SCALE3X && src_w * 2 <= max_w && src_h * 2 <= max_h) {
+        return PIXEL_SCALER_SCALE2X;
+    }
+    return PIXEL_SCALER_NONE;
+}
+
+static void scale2x_rows(const uint32_t *src, int w, int h, uint32_t *dst, int row_start, int row_end)
+{
+    const size_t dst_stride = (size_t)w * 2;
+    for (int y = row_start; y < row_end; ++y) {
+        const uint32_t *row = src + (size_t)y * w;
+        const uint32_t *up = (y > 0) ? row - w : row;
+        const uint32_t *down = (y + 1 < h) ? row + w : row;
+        uint32_t *out0 = dst + (size_t)y * 2 * dst_stride;
+        uint32_t *out1 = out0 + dst_stride;
+        for (int x = 0; x < w; ++x) {
+            const int xl = (x > 0) ? x - 1 : x;
+            const int xr = (x + 1 < w) ? x + 1 : x;
+            const uint32_t p = row[x];
+            const uint32_t a = up[x];
+            const uint32_t b = row[xr];
+            const uint32_t c = row[xl];
+            const uint32_t d = down[x];
+            if (a != d && c != b) {
+                out0[2 * x]     = (c == a) ? a : p;
+                out0[2 * x + 1] = (a == b) ? b : p;
+                out1[2 * x]     = (d == c) ? c : p;
+                out1[2 * x + 1] = (b == d) ? d : p;
+            } else {
+                out0[2 * x] = out0[2 * x + 1] = p;
+                out1[2 * x] = out1[2 * x + 1] = p;
+            }
+        }
+    }
+}
+
+static void scale3x_rows(const uint32_t *src, int w, int h, uint32_t *dst, int row_start, int row_end)
+{
+    const size_t dst_stride = (size_t)w * 3;
+    for (int y = row_start; y < row_end; ++y) {
+        const uint32_t *row = src + (size_t)y * w;
+        const uint32_t *up = (y > 0) ? row - w : row;
+        const uint32_t *down = (y + 1 < h) ? row + w : row;
+        uint32_t *out0 = dst + (size_t)y * 3 * dst_stride;
+        uint32_t *out1 = out0 + dst_stride;
+        uint32_t *out2 = out1 + dst_stride;
+        for (int x = 0; x < w; ++x) {
+            const int xl = (x > 0) ? x - 1 : x;
+            const int xr = (x + 1 < w) ? x + 1 : x;
+            // A B C
+            // D E F
+            // G H I
+            const uint32_t a = up[xl], b = up[x], c = up[xr];
+            const uint32_t d = row[xl], e = row[x], f = row[xr];
+            const uint32_t g = down[xl], hh = down[x], i = down[xr];
+            uint32_t *o0 = out0 + 3 * x;
+            uint32_t *o1 = out1 + 3 * x;
+            uint32_t *o2 = out2 + 3 * x;
+            if (b != hh && d != f) {
+                o0[0] = (d == b) ? d : e;
+                o0[1] = ((d == b && e != c) || (b == f && e != a)) ? b : e;
+                o0[2] = (b == f) ? f : e;
+                o1[0] = ((d == b && e != g) || (d == hh && e != a)) ? d : e;
+                o1[1] = e;
+                o1[2] = ((b == f && e != i) || (hh == f && e != c)) ? f : e;
+                o2[0] = (d == hh) ? d : e;
+                o2[1] = ((d == hh && e != i) || (hh == f && e != g)) ? hh : e;
+                o2[2] = (hh == f) ? f : e;
+            } else {
+                o0[0] = o0[1] = o0[2] = e;
+                o1[0] = o1[1] = o1[2] = e;
+                o2[0] = o2[1] = o2[2] = e;
+            }
+        }
+    }
+}
+
+// Scale2x decision structure with tolerant matching, and corners blended half-way
+// instead of replaced, which smooths the stair-steps on shaded and anti-aliased art
+static void xbr_lite_rows(const uint32_t *src, int w, int h, uint32_t *dst, int row_start, int row_end)
+{
+    const size_t dst_stride = (size_t)w * 2;
+    for (int y = row_start; y < row_end; ++y) {
+        const uint32_t *row = src + (size_t)y * w;
+        const uint32_t *up = (y > 0) ? row - w : row;
+        const uint32_t *down = (y + 1 < h) ? row + w : row;
+        uint32_t *out0 = dst + (size_t)y * 2 * dst_stride;
+        uint32_t *out1 = out0 + dst_stride;
+        for (int x = 0; x < w; ++x) {
+            const int xl = (x > 0) ? x - 1 : x;
+            const int xr = (x + 1 < w) ? x + 1 : x;
+            const uint32_t p = row[x];
+            const uint32_t a = up[x];
+            const uint32_t b = row[xr];
+            const uint32_t c = row[xl];
+            const uint32_t d = down[x];
+            uint32_t e0 = p, e1 = p, e2 = p, e3 = p;
+            if (!xbr_similar(a, d) && !xbr_similar(c, b)) {
+                if (xbr_similar(c, a) && !xbr_similar(p, a)) e0 = average_rgba(p, a);
+                if (xbr_similar(a, b) && !xbr_similar(p, b)) e1 = average_rgba(p, b);
+                if (xbr_similar(d, c) && !xbr_similar(p, c)) e2 = average_rgba(p, c);
+                if (xbr_similar(b, d) && !xbr_similar(p, d)) e3 = average_rgba(p, d);
+            }
+            out0[2 * x] = e0;
+            out0[2 * x + 1] = e1;
+            out1[2 * x] = e2;
+            out1[2 * x + 1] = e3;
+        }
+    }
+}
+
+void pixel_scaler_run_rows(pixel_scaler_t scaler, const uint8_t *src, int src_w, int src_h,
+                           uint8_t *dst, int row_start, int row_end)
+{
+    if (!src || !dst || src_w <= 0 || src_h <= 0) {
+        return;
+    }
+    if (row_start < 0) row_start = 0;
+    if (row_end > src_h) row_end = src_h;
+    if (row_start >= row_end) return;
+
+    const uint32_t *src_px = (const uint32_t *)src;
+    uint32_t *dst_px = (uint32_t *)dst;
+
+    switch (scaler) {
+    case PIXEL_SCALER_SCALE2X:
+        scale2x_rows(src_px, src_w, src_h, dst_px, row_start, row_end);
+        break;
+    case PIXEL_SCALER_SCALE3X:
+        scale3x_rows(src_px, src_w, src_h, dst_px, row_start, row_end);
+        break;
+    case PIXEL_SCALER_XBR_LITE:
+        xbr_lite_rows(src_px, src_w, src_h, dst_px, row_start, row_end);
+        break;
+    case PIXEL_SCALER_NONE:
+    default:
+        break;
+    }
+}
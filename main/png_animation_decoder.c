@@ -228,6 +228,7 @@ esp_err_t png_decoder_get_info(animation_decoder_t *decoder, animation_decoder_i
     info->canvas_height = png_data->canvas_height;
     info->frame_count = 1; // PNG is always single frame
     info->has_transparency = png_data->has_transparency;
+    info->loop_duration_ms = STATIC_IMAGE_FRAME_DELAY_MS;
 
     return ESP_OK;
 }
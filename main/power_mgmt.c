@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "power_mgmt.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#endif
+
+static const char *TAG = "power";
+
+#ifndef CONFIG_P3A_PM_MIN_CPU_FREQ_MHZ
+#define CONFIG_P3A_PM_MIN_CPU_FREQ_MHZ CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#endif
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static power_mgmt_stats_t s_stats;
+static int s_busy_depth = 0;
+static int64_t s_busy_since_us = 0;
+static bool s_lit = true;
+static int64_t s_blanked_since_us = 0;
+
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t s_cpu_lock = NULL;     // ESP_PM_CPU_FREQ_MAX, held by busy sections
+static esp_pm_lock_handle_t s_awake_lock = NULL;   // ESP_PM_NO_LIGHT_SLEEP, held while the panel is lit
+#endif
+
+esp_err_t power_mgmt_init(void)
+{
+    s_stats.max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+    s_stats.min_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+
+#if CONFIG_PM_ENABLE
+    const esp_pm_config_t config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_P3A_PM_MIN_CPU_FREQ_MHZ,
+#if CONFIG_P3A_PM_LIGHT_SLEEP
+        .light_sleep_enable = true,
+#else
+        .light_sleep_enable = false,
+#endif
+    };
+    esp_err_t err = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "p3a_busy", &s_cpu_lock);
+    if (err == ESP_OK) {
+        err = esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "p3a_lit", &s_awake_lock);
+    }
+    if (err == ESP_OK) {
+        // The panel starts lit; take its lock before light sleep can be entered
+        err = esp_pm_lock_acquire(s_awake_lock);
+    }
+    if (err == ESP_OK) {
+        err = esp_pm_configure(&config);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Frequency scaling unavailable: %s", esp_err_to_name(err));
+        return err;
+    }
+    s_stats.pm_enabled = true;
+    s_stats.light_sleep = config.light_sleep_enable;
+    s_stats.min_freq_mhz = config.min_freq_mhz;
+    ESP_LOGI(TAG, "CPU %d MHz while rendering, %d MHz between frames%s", config.max_freq_mhz,
+             config.min_freq_mhz, config.light_sleep_enable ? ", light sleep while blanked" : "");
+#endif
+    return ESP_OK;
+}
+
+void power_mgmt_busy_begin(void)
+{
+#if CONFIG_PM_ENABLE
+    if (s_cpu_lock) {
+        esp_pm_lock_acquire(s_cpu_lock);   // Counts nested acquires itself
+    }
+#endif
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    if (s_busy_depth++ == 0) {
+        s_busy_since_us = now_us;
+        s_stats.busy_sections++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void power_mgmt_busy_end(void)
+{
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    if (s_busy_depth > 0 && --s_busy_depth == 0) {
+        s_stats.busy_us += (uint64_t)(now_us - s_busy_since_us);
+    }
+    portEXIT_CRITICAL(&s_lock);
+#if CONFIG_PM_ENABLE
+    if (s_cpu_lock) {
+        esp_pm_lock_release(s_cpu_lock);
+    }
+#endif
+}
+
+void power_mgmt_set_display_lit(bool lit)
+{
+    const int64_t now_us = esp_timer_get_time();
+    bool changed = false;
+    portENTER_CRITICAL(&s_lock);
+    if (lit != s_lit) {
+        s_lit = lit;
+        changed = true;
+        if (lit) {
+            s_stats.blanked_us += (uint64_t)(now_us - s_blanked_since_us);
+        } else {
+            s_blanked_since_us = now_us;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if (!changed) {
+        return;
+    }
+#if CONFIG_PM_ENABLE
+    if (s_awake_lock) {
+        if (lit) {
+            esp_pm_lock_acquire(s_awake_lock);
+        } else {
+            esp_pm_lock_release(s_awake_lock);
+        }
+    }
+#endif
+    ESP_LOGD(TAG, "Display %s", lit ? "lit" : "blanked");
+}
+
+void power_mgmt_get_stats(power_mgmt_stats_t *out)
+{
+    if (!out) {
+        return;
+    }
+    const int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    // Include the sections still open
+    if (s_busy_depth > 0) {
+        out->busy_us += (uint64_t)(now_us - s_busy_since_us);
+    }
+    if (!s_lit) {
+        out->blanked_us += (uint64_t)(now_us - s_blanked_since_us);
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
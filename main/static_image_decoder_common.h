@@ -25,6 +25,7 @@ extern esp_err_t gif_decoder_get_info(animation_decoder_t *decoder, animation_de
 extern esp_err_t gif_decoder_decode_next(animation_decoder_t *decoder, uint8_t *rgba_buffer);
 extern esp_err_t gif_decoder_get_frame_delay(animation_decoder_t *decoder, uint32_t *delay_ms);
 extern esp_err_t gif_decoder_reset(animation_decoder_t *decoder);
+extern esp_err_t gif_decoder_set_background(animation_decoder_t *decoder, uint8_t r, uint8_t g, uint8_t b);
 extern void gif_decoder_unload(animation_decoder_t **decoder);
 
 extern esp_err_t png_decoder_init(animation_decoder_t **decoder, const uint8_t *data, size_t size);
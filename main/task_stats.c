@@ -0,0 +1,348 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "task_stats.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "task_stats";
+
+#if CONFIG_P3A_TASK_STATS_ENABLE
+
+#define SAMPLE_PERIOD_MS        1000
+#define HISTORY_SAMPLES         60       // Longest window, in samples
+#define SAMPLER_STACK_SIZE      3072
+#define SAMPLER_PRIORITY        1
+#define INVERSION_LOG_GAP_US    (10 * 1000 * 1000)
+
+static const uint32_t s_window_samples[TASK_STATS_WINDOW_COUNT] = { 1, 10, 60 };
+
+// One column of the history per live task
+typedef struct {
+    TaskHandle_t task;
+    char name[TASK_STATS_NAME_LEN];
+    int core;
+    uint32_t priority;
+    uint32_t base_priority;
+    uint32_t stack_free_min;
+    uint32_t last_counter;
+    uint64_t cpu_total_us;     // Deltas of the 32-bit counter folded in, so wraps do not matter
+    bool seen;
+} task_column_t;
+
+typedef struct {
+    int64_t elapsed_us;
+    uint32_t runtime_us[TASK_STATS_MAX_TASKS];
+} history_slot_t;
+
+static SemaphoreHandle_t s_mutex = NULL;
+static TaskHandle_t s_sampler = NULL;
+static history_slot_t *s_history = NULL;   // HISTORY_SAMPLES slots in PSRAM
+static task_column_t s_columns[TASK_STATS_MAX_TASKS];
+static TaskStatus_t s_status[TASK_STATS_MAX_TASKS + 8];
+static uint32_t s_samples = 0;
+static int64_t s_last_sample_us = 0;
+
+static portMUX_TYPE s_lock_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t s_lock_contended = 0;
+static uint32_t s_lock_inversions = 0;
+static int64_t s_lock_max_wait_us = 0;
+static int64_t s_lock_last_inversion_wait_us = 0;
+static char s_lock_last_waiter[TASK_STATS_NAME_LEN];
+static char s_lock_last_holder[TASK_STATS_NAME_LEN];
+static int64_t s_last_inversion_log_us = 0;
+
+static task_column_t *column_for(TaskHandle_t task, int *index_out)
+{
+    int free_index = -1;
+    for (int i = 0; i < TASK_STATS_MAX_TASKS; ++i) {
+        if (s_columns[i].task == task) {
+            *index_out = i;
+            return &s_columns[i];
+        }
+        if (free_index < 0 && !s_columns[i].task) {
+            free_index = i;
+        }
+    }
+    if (free_index < 0) {
+        return NULL;
+    }
+    // New task: its column starts empty so old data of a deleted task does not leak into it
+    memset(&s_columns[free_index], 0, sizeof(s_columns[free_index]));
+    s_columns[free_index].task = task;
+    for (int s = 0; s < HISTORY_SAMPLES; ++s) {
+        s_history[s].runtime_us[free_index] = 0;
+    }
+    *index_out = free_index;
+    return &s_columns[free_index];
+}
+
+static void take_sample(void)
+{
+    uint32_t total_runtime = 0;
+    const UBaseType_t n = uxTaskGetSystemState(s_status, sizeof(s_status) / sizeof(s_status[0]), &total_runtime);
+    const int64_t now_us = esp_timer_get_time();
+    const bool baseline = (s_last_sample_us == 0);
+    const int64_t elapsed_us = now_us - s_last_sample_us;
+    history_slot_t *slot = &s_history[s_samples % HISTORY_SAMPLES];
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    for (int i = 0; i < TASK_STATS_MAX_TASKS; ++i) {
+        s_columns[i].seen = false;
+    }
+    if (!baseline) {
+        slot->elapsed_us = elapsed_us;
+        memset(slot->runtime_us, 0, sizeof(slot->runtime_us));
+    }
+    for (UBaseType_t t = 0; t < n; ++t) {
+        const TaskStatus_t *st = &s_status[t];
+        int index = 0;
+        task_column_t *col = column_for(st->xHandle, &index);
+        if (!col) {
+            continue;
+        }
+        // A new column starts from 0, so a task's first sample adds its whole run time so far
+        col->cpu_total_us += (uint32_t)(st->ulRunTimeCounter - col->last_counter);
+        if (!baseline) {
+            uint32_t delta = st->ulRunTimeCounter - col->last_counter;
+            if ((int64_t)delta > elapsed_us) {
+                delta = (uint32_t)elapsed_us;  // Task created during this period
+            }
+            slot->runtime_us[index] = delta;
+        }
+        snprintf(col->name, sizeof(col->name), "%s", st->pcTaskName);
+        col->core = (st->xCoreID >= 0 && st->xCoreID < portNUM_PROCESSORS) ? (int)st->xCoreID : -1;
+        col->priority = st->uxCurrentPriority;
+        col->base_priority = st->uxBasePriority;
+        col->stack_free_min = st->usStackHighWaterMark;
+        col->last_counter = st->ulRunTimeCounter;
+        col->seen = true;
+    }
+    for (int i = 0; i < TASK_STATS_MAX_TASKS; ++i) {
+        if (!s_columns[i].seen) {
+            s_columns[i].task = NULL;
+        }
+    }
+    if (!baseline) {
+        s_samples++;
+    }
+    s_last_sample_us = now_us;
+    xSemaphoreGive(s_mutex);
+}
+
+static uint16_t permille(uint64_t part, uint64_t whole)
+{
+    if (whole == 0) {
+        return 0;
+    }
+    const uint64_t p = part * 1000 / whole;
+    return (uint16_t)(p > 1000 ? 1000 : p);
+}
+
+esp_err_t task_stats_get(task_stats_report_t *out)
+{
+    if (!out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(out, 0, sizeof(*out));
+    if (!s_mutex || !s_history) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    out->running = true;
+    int64_t elapsed_us[TASK_STATS_WINDOW_COUNT] = {0};
+    for (int w = 0; w < TASK_STATS_WINDOW_COUNT; ++w) {
+        const uint32_t covered = (s_samples < s_window_samples[w]) ? s_samples : s_window_samples[w];
+        for (uint32_t k = 0; k < covered; ++k) {
+            elapsed_us[w] += s_history[(s_samples - 1 - k) % HISTORY_SAMPLES].elapsed_us;
+        }
+        out->window_s[w] = (uint32_t)((elapsed_us[w] + 500000) / 1000000);
+    }
+
+    TaskHandle_t idle[portNUM_PROCESSORS];
+    for (int c = 0; c < portNUM_PROCESSORS; ++c) {
+        idle[c] = xTaskGetIdleTaskHandleForCore(c);
+    }
+
+    for (int i = 0; i < TASK_STATS_MAX_TASKS && out->task_count < TASK_STATS_MAX_TASKS; ++i) {
+        const task_column_t *col = &s_columns[i];
+        if (!col->task) {
+            continue;
+        }
+        task_stats_task_t *t = &out->tasks[out->task_count++];
+        snprintf(t->name, sizeof(t->name), "%s", col->name);
+        t->core = col->core;
+        t->priority = col->priority;
+        t->base_priority = col->base_priority;
+        t->stack_free_min = col->stack_free_min;
+        t->cpu_total_us = col->cpu_total_us;
+        for (int w = 0; w < TASK_STATS_WINDOW_COUNT; ++w) {
+            const uint32_t covered = (s_samples < s_window_samples[w]) ? s_samples : s_window_samples[w];
+            uint64_t runtime_us = 0;
+            for (uint32_t k = 0; k < covered; ++k) {
+                runtime_us += s_history[(s_samples - 1 - k) % HISTORY_SAMPLES].runtime_us[i];
+            }
+            t->cpu_permille[w] = permille(runtime_us, (uint64_t)elapsed_us[w]);
+            // A core is busy whenever its idle task is not running
+            for (int c = 0; c < portNUM_PROCESSORS; ++c) {
+                if (col->task == idle[c]) {
+                    out->core_busy_permille[c][w] = (uint16_t)(1000 - t->cpu_permille[w]);
+                }
+            }
+        }
+    }
+    xSemaphoreGive(s_mutex);
+
+    portENTER_CRITICAL(&s_lock_stats_mux);
+    out->lock_contended = s_lock_contended;
+    out->lock_inversions = s_lock_inversions;
+    out->lock_max_wait_us = s_lock_max_wait_us;
+    out->lock_last_inversion_wait_us = s_lock_last_inversion_wait_us;
+    memcpy(out->lock_last_waiter, s_lock_last_waiter, sizeof(out->lock_last_waiter));
+    memcpy(out->lock_last_holder, s_lock_last_holder, sizeof(out->lock_last_holder));
+    portEXIT_CRITICAL(&s_lock_stats_mux);
+    return ESP_OK;
+}
+
+static void log_report(void)
+{
+    static task_stats_report_t s_report;  // Only the sampler task logs
+    if (task_stats_get(&s_report) != ESP_OK) {
+        return;
+    }
+    const int w = TASK_STATS_WINDOW_10S;
+    ESP_LOGI(TAG, "Last %lus: core0 %u.%u%% busy, core1 %u.%u%% busy; buffer mutex %lu contended, %lu inversions",
+             (unsigned long)s_report.window_s[w],
+             s_report.core_busy_permille[0][w] / 10, s_report.core_busy_permille[0][w] % 10,
+             s_report.core_busy_permille[portNUM_PROCESSORS - 1][w] / 10,
+             s_report.core_busy_permille[portNUM_PROCESSORS - 1][w] % 10,
+             (unsigned long)s_report.lock_contended, (unsigned long)s_report.lock_inversions);
+    for (size_t i = 0; i < s_report.task_count; ++i) {
+        const task_stats_task_t *t = &s_report.tasks[i];
+        char core[4] = "any";
+        if (t->core >= 0) {
+            core[0] = (char)('0' + t->core);
+            core[1] = '\0';
+        }
+        ESP_LOGI(TAG, "  %-16s core %-3s prio %2lu  cpu %3u.%u%%  stack free %lu",
+                 t->name, core, (unsigned long)t->priority,
+                 t->cpu_permille[w] / 10, t->cpu_permille[w] % 10, (unsigned long)t->stack_free_min);
+    }
+}
+
+static void sampler_task(void *arg)
+{
+    (void)arg;
+    TickType_t last_wake = xTaskGetTickCount();
+    uint32_t since_log_s = 0;
+    while (true) {
+        take_sample();
+#if CONFIG_P3A_TASK_STATS_LOG_SECONDS > 0
+        if (++since_log_s >= CONFIG_P3A_TASK_STATS_LOG_SECONDS) {
+            since_log_s = 0;
+            log_report();
+        }
+#else
+        (void)since_log_s;
+        (void)log_report;
+#endif
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SAMPLE_PERIOD_MS));
+    }
+}
+
+esp_err_t task_stats_start(void)
+{
+    if (s_sampler) {
+        return ESP_OK;
+    }
+    s_history = heap_caps_calloc(HISTORY_SAMPLES, sizeof(history_slot_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!s_history) {
+        s_history = calloc(HISTORY_SAMPLES, sizeof(history_slot_t));
+    }
+    s_mutex = xSemaphoreCreateMutex();
+    if (!s_history || !s_mutex) {
+        ESP_LOGE(TAG, "Failed to allocate task statistics");
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(sampler_task, "task_stats", SAMPLER_STACK_SIZE, NULL, SAMPLER_PRIORITY, &s_sampler) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create sampler task");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void task_stats_note_lock_wait(TaskHandle_t holder, UBaseType_t holder_priority, int64_t wait_us,
+                               bool holder_preempted)
+{
+    TaskHandle_t waiter = xTaskGetCurrentTaskHandle();
+    // Inheritance should have the holder running at the waiter's priority; ready but not running
+    // means something else kept it off the CPU while the waiter sat blocked
+    const bool inversion = holder && holder_preempted;
+    bool log_it = false;
+    char waiter_name[TASK_STATS_NAME_LEN] = "";
+    char holder_name[TASK_STATS_NAME_LEN] = "";
+    if (inversion) {
+        snprintf(waiter_name, sizeof(waiter_name), "%s", pcTaskGetName(waiter));
+        snprintf(holder_name, sizeof(holder_name), "%s", pcTaskGetName(holder));
+    }
+
+    portENTER_CRITICAL(&s_lock_stats_mux);
+    s_lock_contended++;
+    if (wait_us > s_lock_max_wait_us) {
+        s_lock_max_wait_us = wait_us;
+    }
+    if (inversion) {
+        s_lock_inversions++;
+        s_lock_last_inversion_wait_us = wait_us;
+        memcpy(s_lock_last_waiter, waiter_name, sizeof(s_lock_last_waiter));
+        memcpy(s_lock_last_holder, holder_name, sizeof(s_lock_last_holder));
+        const int64_t now_us = esp_timer_get_time();
+        if (now_us - s_last_inversion_log_us >= INVERSION_LOG_GAP_US) {
+            s_last_inversion_log_us = now_us;
+            log_it = true;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock_stats_mux);
+
+    if (log_it) {
+        ESP_LOGW(TAG, "Priority inversion: %s (prio %lu) waited %lld us for buffer mutex held by preempted %s (prio %lu)",
+                 waiter_name, (unsigned long)uxTaskPriorityGet(waiter), (long long)wait_us,
+                 holder_name, (unsigned long)holder_priority);
+    }
+}
+
+#else
+
+esp_err_t task_stats_start(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t task_stats_get(task_stats_report_t *out)
+{
+    (void)TAG;
+    if (out) {
+        memset(out, 0, sizeof(*out));
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void task_stats_note_lock_wait(TaskHandle_t holder, UBaseType_t holder_priority, int64_t wait_us,
+                               bool holder_preempted)
+{
+    (void)holder;
+    (void)holder_priority;
+    (void)wait_us;
+    (void)holder_preempted;
+}
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "task_topology.h"
+#include "config_store.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+static const char *TAG = "task_topology";
+
+#define MIN_STACK_SIZE  2048
+#define MAX_STACK_SIZE  32768
+
+static task_topology_entry_t s_topology[TASK_TOPOLOGY_COUNT] = {
+    [TASK_TOPOLOGY_RENDER] = {
+        "lcd_anim", CONFIG_P3A_RENDER_TASK_CORE, CONFIG_P3A_RENDER_TASK_PRIORITY, CONFIG_P3A_RENDER_TASK_STACK,
+    },
+    [TASK_TOPOLOGY_UPSCALE_TOP] = {
+        "upscale_top", CONFIG_P3A_UPSCALE_TOP_CORE, CONFIG_P3A_UPSCALE_TASK_PRIORITY, CONFIG_P3A_UPSCALE_TASK_STACK,
+    },
+    [TASK_TOPOLOGY_UPSCALE_BOTTOM] = {
+        "upscale_bottom", CONFIG_P3A_UPSCALE_BOTTOM_CORE, CONFIG_P3A_UPSCALE_TASK_PRIORITY, CONFIG_P3A_UPSCALE_TASK_STACK,
+    },
+    [TASK_TOPOLOGY_LOADER] = {
+        "anim_loader", CONFIG_P3A_LOADER_TASK_CORE, CONFIG_P3A_LOADER_TASK_PRIORITY, CONFIG_P3A_LOADER_TASK_STACK,
+    },
+    [TASK_TOPOLOGY_TOUCH] = {
+        "app_touch_task", CONFIG_P3A_TOUCH_TASK_CORE, CONFIG_P3A_TOUCH_TASK_PRIORITY, CONFIG_P3A_TOUCH_TASK_STACK,
+    },
+    [TASK_TOPOLOGY_AUTO_SWAP] = {
+        "auto_swap", CONFIG_P3A_AUTO_SWAP_TASK_CORE, CONFIG_P3A_AUTO_SWAP_TASK_PRIORITY, CONFIG_P3A_AUTO_SWAP_TASK_STACK,
+    },
+    [TASK_TOPOLOGY_HTTP_WORKER] = {
+        "api_worker", CONFIG_P3A_HTTP_WORKER_TASK_CORE, CONFIG_P3A_HTTP_WORKER_TASK_PRIORITY, CONFIG_P3A_HTTP_WORKER_TASK_STACK,
+    },
+};
+
+static void apply_override(task_topology_entry_t *entry, const cJSON *json)
+{
+    if (!cJSON_IsObject(json)) {
+        return;
+    }
+    const cJSON *core = cJSON_GetObjectItemCaseSensitive(json, "core");
+    if (cJSON_IsNull(core)) {
+        entry->core = TASK_TOPOLOGY_ANY_CORE;
+    } else if (cJSON_IsNumber(core) && core->valueint >= TASK_TOPOLOGY_ANY_CORE && core->valueint < portNUM_PROCESSORS) {
+        entry->core = core->valueint;
+    } else if (core) {
+        ESP_LOGW(TAG, "%s: ignoring invalid core", entry->name);
+    }
+    const cJSON *priority = cJSON_GetObjectItemCaseSensitive(json, "priority");
+    if (cJSON_IsNumber(priority) && priority->valueint >= 1 && priority->valueint < configMAX_PRIORITIES) {
+        entry->priority = (UBaseType_t)priority->valueint;
+    } else if (priority) {
+        ESP_LOGW(TAG, "%s: ignoring invalid priority", entry->name);
+    }
+    const cJSON *stack = cJSON_GetObjectItemCaseSensitive(json, "stack");
+    if (cJSON_IsNumber(stack) && stack->valueint >= MIN_STACK_SIZE && stack->valueint <= MAX_STACK_SIZE) {
+        entry->stack_size = (uint32_t)stack->valueint;
+    } else if (stack) {
+        ESP_LOGW(TAG, "%s: ignoring invalid stack size", entry->name);
+    }
+}
+
+esp_err_t task_topology_load(void)
+{
+    cJSON *cfg = NULL;
+    esp_err_t err = config_store_load(&cfg);
+    if (err == ESP_OK) {
+        const cJSON *tasks = cJSON_GetObjectItemCaseSensitive(cfg, "tasks");
+        for (int i = 0; i < TASK_TOPOLOGY_COUNT && cJSON_IsObject(tasks); ++i) {
+            apply_override(&s_topology[i], cJSON_GetObjectItemCaseSensitive(tasks, s_topology[i].name));
+        }
+        cJSON_Delete(cfg);
+    } else {
+        ESP_LOGW(TAG, "Config unavailable (%s), using Kconfig task placement", esp_err_to_name(err));
+    }
+
+    for (int i = 0; i < TASK_TOPOLOGY_COUNT; ++i) {
+        const task_topology_entry_t *t = &s_topology[i];
+        if (t->core == TASK_TOPOLOGY_ANY_CORE) {
+            ESP_LOGI(TAG, "%-15s core any  prio %2u  stack %lu", t->name, (unsigned)t->priority,
+                     (unsigned long)t->stack_size);
+        } else {
+            ESP_LOGI(TAG, "%-15s core %d    prio %2u  stack %lu", t->name, t->core, (unsigned)t->priority,
+                     (unsigned long)t->stack_size);
+        }
+    }
+    return err;
+}
+
+const task_topology_entry_t *task_topology_get(task_topology_id_t id)
+{
+    return (id < TASK_TOPOLOGY_COUNT) ? &s_topology[id] : NULL;
+}
+
+BaseType_t task_topology_create(task_topology_id_t id, TaskFunction_t fn, void *arg, TaskHandle_t *out_handle)
+{
+    const task_topology_entry_t *t = task_topology_get(id);
+    if (!t) {
+        return pdFAIL;
+    }
+    const BaseType_t core = (t->core == TASK_TOPOLOGY_ANY_CORE) ? tskNO_AFFINITY : (BaseType_t)t->core;
+    return xTaskCreatePinnedToCore(fn, t->name, t->stack_size, arg, t->priority, out_handle, core);
+}
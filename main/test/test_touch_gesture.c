@@ -0,0 +1,212 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Host tests for the gesture recognizer: synthetic sample sequences in, events out
+
+#include "touch_gesture.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static int s_failures = 0;
+
+#define CHECK_EQ(actual, expected)                                                              \
+    do {                                                                                        \
+        const long long a_ = (long long)(actual);                                               \
+        const long long e_ = (long long)(expected);                                             \
+        if (a_ != e_) {                                                                         \
+            fprintf(stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual,  \
+                    a_, e_);                                                                    \
+            s_failures++;                                                                       \
+        }                                                                                       \
+    } while (0)
+
+#define MS(ms)  ((int64_t)(ms) * 1000)
+
+// Same proportions as app_touch on the 720x720 panel with the default Kconfig values
+static const touch_gesture_config_t s_config = {
+    .screen_w = 720,
+    .screen_h = 720,
+    .min_swipe_height = 72,
+    .max_brightness_delta = 100,
+    .touch_slop = 30,
+    .long_press_us = MS(500),
+    .fling_min_velocity = 800,
+    .fling_velocity_per_item = 1500,
+    .fling_max_items = 10,
+};
+
+static touch_gesture_event_t press(touch_gesture_t *g, int64_t t_us, int x, int y)
+{
+    const touch_sample_t s = { .t_us = t_us, .pressed = true, .x = (uint16_t)x, .y = (uint16_t)y };
+    return touch_gesture_feed(g, &s);
+}
+
+static touch_gesture_event_t release(touch_gesture_t *g, int64_t t_us)
+{
+    const touch_sample_t s = { .t_us = t_us, .pressed = false };
+    return touch_gesture_feed(g, &s);
+}
+
+// Straight horizontal drag from x0 at speed px/s, one sample every period; returns the release event
+// and counts the FLING_PREDICT events on the way, keeping the last predicted steps
+static touch_gesture_event_t drag(touch_gesture_t *g, int x0, int speed, int64_t period_us, int samples,
+                                  int *predictions, int *predicted_steps)
+{
+    touch_gesture_init(g, &s_config);
+    *predictions = 0;
+    *predicted_steps = 0;
+    int64_t t_us = 0;
+    for (int i = 0; i < samples; ++i) {
+        t_us = period_us * i;
+        const int x = x0 + (int)((int64_t)speed * t_us / 1000000);
+        const touch_gesture_event_t e = press(g, t_us, x, 360);
+        if (e.type == TOUCH_GESTURE_FLING_PREDICT) {
+            (*predictions)++;
+            *predicted_steps = e.steps;
+        } else {
+            CHECK_EQ(e.type, TOUCH_GESTURE_NONE);
+        }
+    }
+    return release(g, t_us);
+}
+
+static void test_taps(void)
+{
+    touch_gesture_t g;
+    touch_gesture_init(&g, &s_config);
+
+    // Release while idle (polling an untouched panel) does nothing
+    CHECK_EQ(release(&g, MS(0)).type, TOUCH_GESTURE_NONE);
+
+    CHECK_EQ(press(&g, MS(10), 100, 300).type, TOUCH_GESTURE_NONE);
+    CHECK_EQ(press(&g, MS(30), 110, 305).type, TOUCH_GESTURE_NONE);   // Within the slop
+    touch_gesture_event_t e = release(&g, MS(60));
+    CHECK_EQ(e.type, TOUCH_GESTURE_TAP_LEFT);
+    CHECK_EQ(e.down_us, MS(10));
+    CHECK_EQ(e.x, 100);
+
+    press(&g, MS(100), 600, 300);
+    CHECK_EQ(release(&g, MS(150)).type, TOUCH_GESTURE_TAP_RIGHT);
+    CHECK_EQ(touch_gesture_active(&g), false);
+}
+
+static void test_velocity_window(void)
+{
+    touch_gesture_t g;
+    touch_gesture_init(&g, &s_config);
+
+    // Still for 40 ms, then 100 px every 20 ms: only the last 100 ms count (500 px / 0.1 s),
+    // not the whole contact (500 px / 0.14 s)
+    static const int xs[] = { 100, 100, 100, 200, 300, 400, 500, 600 };
+    for (int i = 0; i < 8; ++i) {
+        press(&g, MS(20 * i), xs[i], 360);
+    }
+    int vx, vy;
+    touch_gesture_velocity(&g, &vx, &vy);
+    CHECK_EQ(vx, 5000);
+    CHECK_EQ(vy, 0);
+
+    // A single sample has no velocity
+    touch_gesture_init(&g, &s_config);
+    press(&g, MS(0), 100, 100);
+    touch_gesture_velocity(&g, &vx, &vy);
+    CHECK_EQ(vx, 0);
+}
+
+static void test_fling_steps(void)
+{
+    touch_gesture_t g;
+    int predictions, predicted;
+
+    // 4000 px/s leftwards is forward: 1 + (4000 - 800) / 1500 = 3 artworks
+    touch_gesture_event_t e = drag(&g, 600, -4000, MS(10), 10, &predictions, &predicted);
+    CHECK_EQ(e.type, TOUCH_GESTURE_FLING);
+    CHECK_EQ(e.steps, 3);
+    CHECK_EQ(predicted, 3);
+    CHECK_EQ(predictions, 1);   // Sent again only when the prediction changes
+
+    // Rightwards goes backward
+    e = drag(&g, 100, 4000, MS(10), 10, &predictions, &predicted);
+    CHECK_EQ(e.type, TOUCH_GESTURE_FLING);
+    CHECK_EQ(e.steps, -3);
+    CHECK_EQ(predicted, -3);
+
+    // Extra items are whole multiples of fling_velocity_per_item above the minimum
+    e = drag(&g, 400, -2300, MS(100), 2, &predictions, &predicted);
+    CHECK_EQ(e.steps, 2);
+    e = drag(&g, 400, -2290, MS(100), 2, &predictions, &predicted);
+    CHECK_EQ(e.steps, 1);
+    e = drag(&g, 400, -800, MS(100), 2, &predictions, &predicted);
+    CHECK_EQ(e.type, TOUCH_GESTURE_FLING);
+    CHECK_EQ(e.steps, 1);
+
+    // Capped at fling_max_items
+    e = drag(&g, 700, -20000, MS(5), 7, &predictions, &predicted);
+    CHECK_EQ(e.steps, 10);
+
+    // Too slow at release: the drag does nothing
+    e = drag(&g, 600, -500, MS(20), 10, &predictions, &predicted);
+    CHECK_EQ(e.type, TOUCH_GESTURE_NONE);
+    CHECK_EQ(predictions, 0);
+}
+
+static void test_scrub(void)
+{
+    touch_gesture_t g;
+    touch_gesture_init(&g, &s_config);
+
+    // Held within the slop until long_press_us starts scrubbing
+    press(&g, MS(0), 360, 360);
+    CHECK_EQ(press(&g, MS(300), 370, 365).type, TOUCH_GESTURE_NONE);
+    CHECK_EQ(press(&g, MS(499), 370, 365).type, TOUCH_GESTURE_NONE);
+    CHECK_EQ(press(&g, MS(500), 370, 365).type, TOUCH_GESTURE_SCRUB_START);
+
+    // Permille of the width dragged since the contact started, signed
+    touch_gesture_event_t e = press(&g, MS(520), 360 + 72, 360);
+    CHECK_EQ(e.type, TOUCH_GESTURE_SCRUB);
+    CHECK_EQ(e.scrub_permille, 100);
+    e = press(&g, MS(540), 360 - 180, 400);
+    CHECK_EQ(e.type, TOUCH_GESTURE_SCRUB);
+    CHECK_EQ(e.scrub_permille, -250);
+    CHECK_EQ(release(&g, MS(560)).type, TOUCH_GESTURE_SCRUB_END);
+
+    // Leaving the slop first makes it a horizontal drag; holding still afterwards never scrubs
+    touch_gesture_init(&g, &s_config);
+    press(&g, MS(0), 360, 360);
+    press(&g, MS(50), 400, 360);
+    CHECK_EQ(g.state, TOUCH_GESTURE_STATE_HORIZONTAL);
+    CHECK_EQ(press(&g, MS(700), 400, 360).type, TOUCH_GESTURE_NONE);
+    CHECK_EQ(release(&g, MS(800)).type, TOUCH_GESTURE_NONE);
+}
+
+static void test_brightness(void)
+{
+    touch_gesture_t g;
+    touch_gesture_init(&g, &s_config);
+
+    press(&g, MS(0), 360, 500);
+    CHECK_EQ(press(&g, MS(20), 365, 420).type, TOUCH_GESTURE_BRIGHTNESS_START);
+    // 180 px up from where the swipe was recognised on a 720 px panel: a quarter of the range
+    touch_gesture_event_t e = press(&g, MS(40), 365, 240);
+    CHECK_EQ(e.type, TOUCH_GESTURE_BRIGHTNESS);
+    CHECK_EQ(e.brightness_delta, 25);
+    CHECK_EQ(release(&g, MS(60)).type, TOUCH_GESTURE_BRIGHTNESS_END);
+}
+
+int main(void)
+{
+    test_taps();
+    test_velocity_window();
+    test_fling_steps();
+    test_scrub();
+    test_brightness();
+    if (s_failures) {
+        fprintf(stderr, "%d check(s) failed\n", s_failures);
+        return EXIT_FAILURE;
+    }
+    printf("test_touch_gesture: all checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Replays touch samples from a device log through the gesture recognizer and prints the events.
+//
+// Record with the app_touch log level at verbose (esp_log_level_set("app_touch", ESP_LOG_VERBOSE)
+// or menuconfig), then: ./touch_replay monitor.log
+// Lines other than "app_touch: sample <t_us> <pressed> <x> <y>" are ignored, so a whole
+// idf.py monitor capture can be fed in. The recognizer is configured like app_touch with the
+// shipped sdkconfig on the 720x720 panel.
+
+#include "touch_gesture.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const touch_gesture_config_t s_config = {
+    .screen_w = 720,
+    .screen_h = 720,
+    .min_swipe_height = 720 * 10 / 100,      // CONFIG_P3A_TOUCH_SWIPE_MIN_HEIGHT_PERCENT
+    .max_brightness_delta = 75,              // CONFIG_P3A_TOUCH_BRIGHTNESS_MAX_DELTA_PERCENT
+    .touch_slop = 720 / 24,
+    .long_press_us = 500 * 1000,             // CONFIG_P3A_TOUCH_LONG_PRESS_MS
+    .fling_min_velocity = 800,               // CONFIG_P3A_TOUCH_FLING_MIN_VELOCITY
+    .fling_velocity_per_item = 1500,         // CONFIG_P3A_TOUCH_FLING_VELOCITY_PER_ITEM
+    .fling_max_items = 10,                   // CONFIG_P3A_TOUCH_FLING_MAX_ITEMS
+};
+
+static const char *const s_event_names[] = {
+    [TOUCH_GESTURE_NONE] = "none",
+    [TOUCH_GESTURE_TAP_LEFT] = "tap_left",
+    [TOUCH_GESTURE_TAP_RIGHT] = "tap_right",
+    [TOUCH_GESTURE_BRIGHTNESS_START] = "brightness_start",
+    [TOUCH_GESTURE_BRIGHTNESS] = "brightness",
+    [TOUCH_GESTURE_BRIGHTNESS_END] = "brightness_end",
+    [TOUCH_GESTURE_FLING_PREDICT] = "fling_predict",
+    [TOUCH_GESTURE_FLING] = "fling",
+    [TOUCH_GESTURE_SCRUB_START] = "scrub_start",
+    [TOUCH_GESTURE_SCRUB] = "scrub",
+    [TOUCH_GESTURE_SCRUB_END] = "scrub_end",
+};
+
+// Parse one log line; false for lines that are not touch samples
+static bool parse_sample(const char *line, touch_sample_t *out)
+{
+    const char *p = strstr(line, "app_touch: sample ");
+    if (!p) {
+        return false;
+    }
+    long long t_us;
+    int pressed;
+    unsigned x, y;
+    if (sscanf(p, "app_touch: sample %lld %d %u %u", &t_us, &pressed, &x, &y) != 4) {
+        return false;
+    }
+    out->t_us = t_us;
+    out->pressed = (pressed != 0);
+    out->x = (uint16_t)x;
+    out->y = (uint16_t)y;
+    return true;
+}
+
+static void print_event(const touch_gesture_event_t *e)
+{
+    printf("%" PRId64 " %s", e->t_us, s_event_names[e->type]);
+    switch (e->type) {
+    case TOUCH_GESTURE_TAP_LEFT:
+    case TOUCH_GESTURE_TAP_RIGHT:
+        printf(" %u %u", e->x, e->y);
+        break;
+    case TOUCH_GESTURE_BRIGHTNESS:
+        printf(" %+d", e->brightness_delta);
+        break;
+    case TOUCH_GESTURE_FLING_PREDICT:
+    case TOUCH_GESTURE_FLING:
+        printf(" %+d", e->steps);
+        break;
+    case TOUCH_GESTURE_SCRUB:
+        printf(" %+d", e->scrub_permille);
+        break;
+    default:
+        break;
+    }
+    printf("\n");
+}
+
+static int replay(FILE *in, const char *name)
+{
+    touch_gesture_t gesture;
+    touch_gesture_init(&gesture, &s_config);
+    char line[512];
+    int samples = 0;
+    while (fgets(line, sizeof(line), in)) {
+        touch_sample_t sample;
+        if (!parse_sample(line, &sample)) {
+            continue;
+        }
+        samples++;
+        const touch_gesture_event_t event = touch_gesture_feed(&gesture, &sample);
+        if (event.type != TOUCH_GESTURE_NONE) {
+            print_event(&event);
+        }
+    }
+    if (samples == 0) {
+        fprintf(stderr, "%s: no touch samples found\n", name);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        return replay(stdin, "stdin");
+    }
+    int status = 0;
+    for (int i = 1; i < argc; ++i) {
+        FILE *in = fopen(argv[i], "r");
+        if (!in) {
+            perror(argv[i]);
+            return 1;
+        }
+        status |= replay(in, argv[i]);
+        fclose(in);
+    }
+    return status;
+}
@@ -0,0 +1,277 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "thumb_cache.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *TAG = "thumb_cache";
+
+#ifndef CONFIG_P3A_THUMB_CACHE_CAPACITY
+#define CONFIG_P3A_THUMB_CACHE_CAPACITY 1   // Cache disabled; never opened
+#endif
+
+#define THUMB_MAGIC     0x48543350U   // "P3TH"
+#define THUMB_VERSION   1
+#define THUMB_CAPACITY  CONFIG_P3A_THUMB_CACHE_CAPACITY
+
+// File layout: header, THUMB_CAPACITY index entries, then one thumbnail per entry in index order.
+// Entries are taken lowest first, so the data area only grows at its end.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t side;
+    uint16_t bytes_per_pixel;
+    uint16_t capacity;
+} thumb_file_header_t;
+
+// An entry is written after its thumbnail, so a write cut short by a power loss leaves it free
+typedef struct {
+    uint32_t name_hash;      // FNV-1a of the artwork's file name, 0 for a free entry
+    uint32_t asset_size;     // Size of the file the thumbnail was made from
+} thumb_index_entry_t;
+
+// The index is mirrored in RAM; the file is only read for thumbnail data
+static SemaphoreHandle_t s_lock = NULL;
+static FILE *s_file = NULL;
+static thumb_index_entry_t s_index[THUMB_CAPACITY];
+static size_t s_thumb_bytes = 0;
+static size_t s_next_victim = 0;   // Entry overwritten when the index is full
+
+static uint32_t name_hash(const char *name)
+{
+    uint32_t hash = 2166136261U;
+    for (const char *c = name; *c; ++c) {
+        hash = (hash ^ (uint8_t)*c) * 16777619U;
+    }
+    return (hash != 0) ? hash : 1;  // 0 marks a free entry
+}
+
+static long entry_offset(size_t entry)
+{
+    return (long)(sizeof(thumb_file_header_t) + entry * sizeof(thumb_index_entry_t));
+}
+
+static long data_offset(size_t entry)
+{
+    return (long)(sizeof(thumb_file_header_t) + THUMB_CAPACITY * sizeof(thumb_index_entry_t) +
+                  entry * s_thumb_bytes);
+}
+
+// Entry holding the name's thumbnail, -1 if none (caller holds s_lock)
+static int find_entry(uint32_t hash)
+{
+    for (int i = 0; s_file && i < THUMB_CAPACITY; ++i) {
+        if (s_index[i].name_hash == hash) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Write an index entry through to the card (caller holds s_lock)
+static esp_err_t write_entry(size_t entry)
+{
+    if (fseek(s_file, entry_offset(entry), SEEK_SET) != 0 ||
+        fwrite(&s_index[entry], sizeof(s_index[entry]), 1, s_file) != 1 || fflush(s_file) != 0) {
+        return ESP_FAIL;
+    }
+    fsync(fileno(s_file));
+    return ESP_OK;
+}
+
+static esp_err_t create_file(const char *path, const thumb_file_header_t *header)
+{
+    s_file = fopen(path, "w+b");
+    if (!s_file) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    memset(s_index, 0, sizeof(s_index));
+    if (fwrite(header, sizeof(*header), 1, s_file) != 1 ||
+        fwrite(s_index, sizeof(s_index), 1, s_file) != 1 || fflush(s_file) != 0) {
+        fclose(s_file);
+        s_file = NULL;
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t thumb_cache_open(const char *path, size_t bytes_per_pixel)
+{
+    if (!path || (bytes_per_pixel != 2 && bytes_per_pixel != 3)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_lock) {
+        s_lock = xSemaphoreCreateMutex();
+        if (!s_lock) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    thumb_cache_close();
+
+    const thumb_file_header_t header = {
+        .magic = THUMB_MAGIC,
+        .version = THUMB_VERSION,
+        .side = THUMB_CACHE_SIDE,
+        .bytes_per_pixel = (uint16_t)bytes_per_pixel,
+        .capacity = THUMB_CAPACITY,
+    };
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    esp_err_t err = ESP_OK;
+    thumb_file_header_t found = {0};
+    s_file = fopen(path, "r+b");
+    if (s_file && (fread(&found, sizeof(found), 1, s_file) != 1 || memcmp(&found, &header, sizeof(header)) != 0 ||
+                   fread(s_index, sizeof(s_index), 1, s_file) != 1)) {
+        // Another size or format, or cut short: start over
+        ESP_LOGI(TAG, "Thumbnail file %s does not match, recreating it", path);
+        fclose(s_file);
+        s_file = NULL;
+    }
+    if (!s_file) {
+        err = create_file(path, &header);
+    }
+    size_t count = 0;
+    if (s_file) {
+        s_thumb_bytes = (size_t)THUMB_CACHE_SIDE * THUMB_CACHE_SIDE * bytes_per_pixel;
+        for (int i = 0; i < THUMB_CAPACITY; ++i) {
+            count += (s_index[i].name_hash != 0) ? 1 : 0;
+        }
+        s_next_victim = 0;
+    }
+    xSemaphoreGive(s_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Thumbnail file %s unavailable: %s", path, esp_err_to_name(err));
+        return err;
+    }
+    ESP_LOGI(TAG, "%zu of %d thumbnails (%dx%d) cached in %s", count, THUMB_CAPACITY, THUMB_CACHE_SIDE,
+             THUMB_CACHE_SIDE, path);
+    return ESP_OK;
+}
+
+void thumb_cache_close(void)
+{
+    if (!s_lock) {
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (s_file) {
+        fclose(s_file);
+        s_file = NULL;
+    }
+    s_thumb_bytes = 0;
+    xSemaphoreGive(s_lock);
+}
+
+size_t thumb_cache_thumb_bytes(void)
+{
+    return s_thumb_bytes;
+}
+
+bool thumb_cache_has(const char *name)
+{
+    if (!s_lock || !name) {
+        return false;
+    }
+    const uint32_t hash = name_hash(name);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool found = find_entry(hash) >= 0;
+    xSemaphoreGive(s_lock);
+    return found;
+}
+
+void thumb_cache_check(const char *name, uint32_t asset_size)
+{
+    if (!s_lock || !name) {
+        return;
+    }
+    const uint32_t hash = name_hash(name);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    const int entry = find_entry(hash);
+    bool dropped = false;
+    if (entry >= 0 && s_index[entry].asset_size != asset_size) {
+        s_index[entry].name_hash = 0;
+        write_entry((size_t)entry);
+        dropped = true;
+    }
+    xSemaphoreGive(s_lock);
+    if (dropped) {
+        ESP_LOGI(TAG, "Thumbnail of %s is stale, dropped", name);
+    }
+}
+
+esp_err_t thumb_cache_store(const char *name, uint32_t asset_size, const uint8_t *pixels)
+{
+    if (!s_lock || !name || !pixels) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint32_t hash = name_hash(name);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (!s_file) {
+        xSemaphoreGive(s_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    int entry = find_entry(hash);
+    if (entry < 0) {
+        entry = find_entry(0);
+    }
+    if (entry < 0) {
+        entry = (int)s_next_victim;
+        s_next_victim = (s_next_victim + 1) % THUMB_CAPACITY;
+    }
+
+    // Free the entry first so it never points at half-written data
+    esp_err_t err = ESP_OK;
+    if (s_index[entry].name_hash != 0) {
+        s_index[entry].name_hash = 0;
+        err = write_entry((size_t)entry);
+    }
+    if (err == ESP_OK && (fseek(s_file, data_offset((size_t)entry), SEEK_SET) != 0 ||
+                          fwrite(pixels, s_thumb_bytes, 1, s_file) != 1 || fflush(s_file) != 0)) {
+        err = ESP_FAIL;
+    }
+    if (err == ESP_OK) {
+        s_index[entry].name_hash = hash;
+        s_index[entry].asset_size = asset_size;
+        err = write_entry((size_t)entry);
+        if (err != ESP_OK) {
+            s_index[entry].name_hash = 0;
+        }
+    }
+    xSemaphoreGive(s_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to store thumbnail of %s", name);
+    }
+    return err;
+}
+
+esp_err_t thumb_cache_read(const char *name, uint8_t *out, size_t len)
+{
+    if (!s_lock || !name || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint32_t hash = name_hash(name);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    esp_err_t err = ESP_OK;
+    const int entry = find_entry(hash);
+    if (entry < 0) {
+        err = ESP_ERR_NOT_FOUND;
+    } else if (len < s_thumb_bytes) {
+        err = ESP_ERR_INVALID_SIZE;
+    } else if (fseek(s_file, data_offset((size_t)entry), SEEK_SET) != 0 ||
+               fread(out, s_thumb_bytes, 1, s_file) != 1) {
+        err = ESP_FAIL;
+    }
+    xSemaphoreGive(s_lock);
+    return err;
+}
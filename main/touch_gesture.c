@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "touch_gesture.h"
+#include <string.h>
+
+#define VELOCITY_WINDOW_US  100000
+
+void touch_gesture_init(touch_gesture_t *g, const touch_gesture_config_t *config)
+{
+    memset(g, 0, sizeof(*g));
+    g->config = *config;
+    g->state = TOUCH_GESTURE_STATE_IDLE;
+}
+
+static void history_push(touch_gesture_t *g, const touch_sample_t *sample)
+{
+    g->history[g->history_head] = *sample;
+    g->history_head = (g->history_head + 1) % TOUCH_GESTURE_HISTORY;
+    if (g->history_len < TOUCH_GESTURE_HISTORY) {
+        g->history_len++;
+    }
+}
+
+void touch_gesture_velocity(const touch_gesture_t *g, int *vx, int *vy)
+{
+    *vx = 0;
+    *vy = 0;
+    if (g->history_len < 2) {
+        return;
+    }
+    // Newest sample against the oldest one still inside the window
+    const unsigned newest = (g->history_head + TOUCH_GESTURE_HISTORY - 1) % TOUCH_GESTURE_HISTORY;
+    const touch_sample_t *last = &g->history[newest];
+    const touch_sample_t *first = last;
+    for (unsigned i = 1; i < g->history_len; ++i) {
+        const touch_sample_t *s = &g->history[(newest + TOUCH_GESTURE_HISTORY - i) % TOUCH_GESTURE_HISTORY];
+        if (last->t_us - s->t_us > VELOCITY_WINDOW_US) {
+            break;
+        }
+        first = s;
+    }
+    const int64_t dt_us = last->t_us - first->t_us;
+    if (dt_us <= 0) {
+        return;
+    }
+    *vx = (int)(((int64_t)last->x - first->x) * 1000000 / dt_us);
+    *vy = (int)(((int64_t)last->y - first->y) * 1000000 / dt_us);
+}
+
+// Artworks a horizontal release at vx would skip; moving the finger left goes forward
+static int fling_steps(const touch_gesture_config_t *c, int vx)
+{
+    const int speed = (vx < 0) ? -vx : vx;
+    if (speed < c->fling_min_velocity) {
+        return 0;
+    }
+    int steps = 1;
+    if (c->fling_velocity_per_item > 0) {
+        steps += (speed - c->fling_min_velocity) / c->fling_velocity_per_item;
+    }
+    if (steps > c->fling_max_items) {
+        steps = c->fling_max_items;
+    }
+    return (vx < 0) ? steps : -steps;
+}
+
+touch_gesture_event_t touch_gesture_feed(touch_gesture_t *g, const touch_sample_t *sample)
+{
+    touch_gesture_event_t event = {
+        .type = TOUCH_GESTURE_NONE,
+        .t_us = sample->t_us,
+        .down_us = g->down_us,
+        .x = g->start_x,
+        .y = g->start_y,
+    };
+
+    if (!sample->pressed) {
+        // Touch released
+        switch (g->state) {
+        case TOUCH_GESTURE_STATE_IDLE:
+            break;
+        case TOUCH_GESTURE_STATE_TAP:
+            // Left half cycles backward, right half forward
+            event.type = (g->start_x < g->config.screen_w / 2) ? TOUCH_GESTURE_TAP_LEFT : TOUCH_GESTURE_TAP_RIGHT;
+            break;
+        case TOUCH_GESTURE_STATE_BRIGHTNESS:
+            event.type = TOUCH_GESTURE_BRIGHTNESS_END;
+            break;
+        case TOUCH_GESTURE_STATE_HORIZONTAL: {
+            // Speed over the last moments of the drag decides; a slow drag does nothing
+            int vx, vy;
+            touch_gesture_velocity(g, &vx, &vy);
+            event.steps = fling_steps(&g->config, vx);
+            if (event.steps != 0) {
+                event.type = TOUCH_GESTURE_FLING;
+            }
+            break;
+        }
+        case TOUCH_GESTURE_STATE_SCRUB:
+            event.type = TOUCH_GESTURE_SCRUB_END;
+            break;
+        }
+        g->state = TOUCH_GESTURE_STATE_IDLE;
+        g->history_len = 0;
+        return event;
+    }
+
+    history_push(g, sample);
+
+    if (g->state == TOUCH_GESTURE_STATE_IDLE) {
+        // Touch just started
+        g->state = TOUCH_GESTURE_STATE_TAP;
+        g->down_us = sample->t_us;
+        g->start_x = sample->x;
+        g->start_y = sample->y;
+        g->predicted_steps = 0;
+        return event;
+    }
+
+    const int delta_x = (int)sample->x - (int)g->start_x;
+    const int delta_y = (int)sample->y - (int)g->start_y;
+    const int abs_delta_x = (delta_x < 0) ? -delta_x : delta_x;
+    const int abs_delta_y = (delta_y < 0) ? -delta_y : delta_y;
+
+    switch (g->state) {
+    case TOUCH_GESTURE_STATE_TAP:
+        if (abs_delta_y >= g->config.min_swipe_height && abs_delta_y >= abs_delta_x) {
+            // Vertical distance exceeds the threshold: brightness follows the finger from here on
+            g->state = TOUCH_GESTURE_STATE_BRIGHTNESS;
+            g->baseline_y = sample->y;
+            event.type = TOUCH_GESTURE_BRIGHTNESS_START;
+        } else if (abs_delta_x > g->config.touch_slop && abs_delta_x > abs_delta_y) {
+            g->state = TOUCH_GESTURE_STATE_HORIZONTAL;
+        } else if (abs_delta_x <= g->config.touch_slop && abs_delta_y <= g->config.touch_slop &&
+                   sample->t_us - g->down_us >= g->config.long_press_us) {
+            g->state = TOUCH_GESTURE_STATE_SCRUB;
+            event.type = TOUCH_GESTURE_SCRUB_START;
+        }
+        // Otherwise wait for the release
+        return event;
+
+    case TOUCH_GESTURE_STATE_BRIGHTNESS: {
+        // Brightness change is proportional to the vertical distance from the baseline: a swipe over
+        // the full height changes it by max_brightness_delta. Swiping up (y decreasing) brightens.
+        const int baseline_delta_y = (int)sample->y - (int)g->baseline_y;
+        event.type = TOUCH_GESTURE_BRIGHTNESS;
+        event.brightness_delta = (g->config.screen_h > 0)
+                                     ? (-baseline_delta_y * g->config.max_brightness_delta) / g->config.screen_h
+                                     : 0;
+        return event;
+    }
+
+    case TOUCH_GESTURE_STATE_HORIZONTAL: {
+        // Tell the player where a release now would land so it can start loading early
+        int vx, vy;
+        touch_gesture_velocity(g, &vx, &vy);
+        const int steps = fling_steps(&g->config, vx);
+        if (steps != 0 && steps != g->predicted_steps) {
+            g->predicted_steps = steps;
+            event.type = TOUCH_GESTURE_FLING_PREDICT;
+            event.steps = steps;
+        }
+        return event;
+    }
+
+    case TOUCH_GESTURE_STATE_SCRUB:
+        event.type = TOUCH_GESTURE_SCRUB;
+        event.scrub_permille = (g->config.screen_w > 0) ? (delta_x * 1000) / g->config.screen_w : 0;
+        return event;
+
+    case TOUCH_GESTURE_STATE_IDLE:
+        break;
+    }
+    return event;
+}
@@ -22,12 +22,29 @@ typedef struct {
     WebPAnimInfo info;
     int last_timestamp_ms;      // Previous frame timestamp for delay calculation
     uint32_t current_frame_delay_ms;  // Delay of the last decoded frame
+    uint32_t loop_duration_ms;  // Sum of the frame delays as decode_next reports them
     bool is_animation;
     uint8_t *still_rgba;
     size_t still_frame_size;
     bool still_has_alpha;
 } webp_decoder_data_t;
 
+// Walk the frame headers (no decoding) and sum the delays, clamped the same way as decode_next
+static uint32_t webp_loop_duration_ms(const WebPAnimDecoder *anim)
+{
+    const WebPDemuxer *demux = WebPAnimDecoderGetDemuxer(anim);
+    WebPIterator iter;
+    uint32_t total_ms = 0;
+    if (!demux || !WebPDemuxGetFrame(demux, 1, &iter)) {
+        return 0;
+    }
+    do {
+        total_ms += (iter.duration < 1) ? 1 : (uint32_t)iter.duration;
+    } while (WebPDemuxNextFrame(&iter));
+    WebPDemuxReleaseIterator(&iter);
+    return total_ms;
+}
+
 esp_err_t animation_decoder_init(animation_decoder_t **decoder, animation_decoder_type_t type, const uint8_t *data, size_t size)
 {
     if (!decoder || !data || size == 0) {
@@ -112,6 +129,7 @@ esp_err_t animation_decoder_init(animation_decoder_t **decoder, animation_decode
 
             webp_data->last_timestamp_ms = 0;
             webp_data->current_frame_delay_ms = 1;  // Default minimum delay
+            webp_data->loop_duration_ms = webp_loop_duration_ms(webp_data->decoder);
         } else {
             const size_t frame_size = (size_t)features.width * features.height * 4;
             webp_data->still_rgba = (uint8_t *)malloc(frame_size);
@@ -139,6 +157,7 @@ esp_err_t animation_decoder_init(animation_decoder_t **decoder, animation_decode
             webp_data->still_has_alpha = (features.has_alpha != 0);
             webp_data->still_frame_size = frame_size;
             webp_data->current_frame_delay_ms = STATIC_IMAGE_FRAME_DELAY_MS;
+            webp_data->loop_duration_ms = STATIC_IMAGE_FRAME_DELAY_MS;
             webp_data->last_timestamp_ms = 0;
         }
 
@@ -179,6 +198,7 @@ esp_err_t animation_decoder_get_info(animation_decoder_t *decoder, animation_dec
         } else {
             info->has_transparency = webp_data->still_has_alpha;
         }
+        info->loop_duration_ms = webp_data->loop_duration_ms;
 
         return ESP_OK;
     } else if (decoder->type == ANIMATION_DECODER_TYPE_GIF) {
@@ -303,6 +323,18 @@ esp_err_t animation_decoder_get_frame_delay(animation_decoder_t *decoder, uint32
     }
 }
 
+esp_err_t animation_decoder_set_background(animation_decoder_t *decoder, uint8_t r, uint8_t g, uint8_t b)
+{
+    if (!decoder) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (decoder->type == ANIMATION_DECODER_TYPE_GIF) {
+        return gif_decoder_set_background(decoder, r, g, b);
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
 void animation_decoder_unload(animation_decoder_t **decoder)
 {
     if (!decoder || !*decoder) {